@@ -0,0 +1,196 @@
+#include "analyser.hpp"
+#include "interpreter.hpp"
+#include <set>
+#include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+
+namespace ch8 {
+    namespace {
+        constexpr addr PROGRAM_START {0x200};
+        constexpr std::size_t JUMP_TABLE {128}; // Most entries followed, V0 only reaches 256 bytes.
+
+        struct Rom {
+            const byte* program;
+            std::size_t size;
+
+            bool has(addr address) const { return address >= PROGRAM_START && std::size_t {address} + 1 < PROGRAM_START + size; }
+            word opcode(addr address) const {
+                return static_cast<word>(program[address - PROGRAM_START] << 8 | program[address - PROGRAM_START + 1]);
+            }
+        };
+
+        bool skips(Instruction instruction) {
+            return instruction == Instruction::SE_RC || instruction == Instruction::SNE_RC || instruction == Instruction::SE_RR ||
+                   instruction == Instruction::SNE_RR || instruction == Instruction::SKP_R || instruction == Instruction::SKNP_R;
+        }
+
+        // Where control goes after the instruction at an address, and whether it's the end of a block.
+        bool flow(const Rom& rom, addr address, std::vector<addr>& next) {
+            word opcode {rom.opcode(address)};
+            addr target = opcode & 0x0FFF;
+            Instruction instruction {Interpreter::decode(opcode >> 8, opcode & 0xFF)};
+            switch (instruction) {
+            case Instruction::JP_A: next = {target}; return true;
+            case Instruction::CALL_A: next = {target, static_cast<addr>(address + 2)}; return true;
+            case Instruction::RET: case Instruction::EXIT: case Instruction::INVALID: next.clear(); return true;
+            case Instruction::LD_IL: next = {static_cast<addr>(address + 4)}; return true; // Past XO-CHIP's address word.
+            case Instruction::JP_V0A:
+                next.clear();
+                for (addr entry {target}; next.size() < JUMP_TABLE && rom.has(entry) && rom.opcode(entry) >> 12 == 0x1; entry += 2)
+                    next.push_back(entry); // Each one a block of its own, jumping on.
+                if (next.empty()) next.push_back(target); // Not a table of jumps, at least V0 = 0 goes there.
+                return true;
+            default:
+                if (skips(instruction)) {
+                    bool long_next {rom.has(address + 2) && rom.opcode(address + 2) == 0xF000}; // Skipped whole.
+                    next = {static_cast<addr>(address + 2), static_cast<addr>(address + (long_next ? 6 : 4))};
+                    return true;
+                }
+
+                next = {static_cast<addr>(address + 2)};
+                return false;
+            }
+        }
+    }
+
+    Analysis Analyser::analyse(const byte* program, std::size_t size) {
+        if (size > Memory::PROGRAM_SIZE) throw std::length_error {"Couldn't analyse, program doesn't fit in memory."};
+        Rom rom {program, size};
+        Analysis analysis;
+        analysis.map.assign(Memory::SIZE, Analysis::Kind::NONE);
+        std::fill(analysis.map.begin() + PROGRAM_START, analysis.map.begin() + PROGRAM_START + size, Analysis::Kind::DATA);
+
+        // Every instruction that's reachable, and which of them start blocks.
+        std::set<addr> reached, leaders {PROGRAM_START};
+        std::vector<addr> pending {PROGRAM_START}, next;
+        while (!pending.empty()) {
+            addr address {pending.back()};
+            pending.pop_back();
+            if (!rom.has(address) || !reached.insert(address).second) continue;
+            bool ends {flow(rom, address, next)};
+            for (addr target : next) {
+                if (ends) leaders.insert(target);
+                pending.push_back(target);
+            }
+        }
+
+        for (addr address : reached) {
+            analysis.map[address] = analysis.map[address + 1] = Analysis::Kind::CODE;
+            if (rom.opcode(address) == 0xF000 && rom.has(address + 2))
+                analysis.map[address + 2] = analysis.map[address + 3] = Analysis::Kind::CODE;
+        }
+
+        // Blocks run from each leader up to the next one, or whatever ends them first.
+        for (addr leader : leaders) {
+            if (reached.count(leader) == 0) continue; // Outside of the ROM.
+            Analysis::Block block {leader, leader, {}};
+            bool known_I {false};
+            addr I {0x000};
+            for (addr address {leader}; ; address += 2) {
+                word opcode {rom.opcode(address)};
+                Instruction instruction {Interpreter::decode(opcode >> 8, opcode & 0xFF)};
+                if (instruction == Instruction::LD_IA) {
+                    known_I = true;
+                    I = opcode & 0x0FFF;
+                } else if (instruction == Instruction::LD_IL) {
+                    known_I = rom.has(address + 2);
+                    if (known_I) I = rom.opcode(address + 2);
+                } else if (instruction == Instruction::ADD_IR || instruction == Instruction::LD_FR ||
+                           instruction == Instruction::LD_IAR || instruction == Instruction::LD_RAI) {
+                    known_I = false; // Moved, or might be depending on the quirks.
+                } else if (instruction == Instruction::DRW_RRC && known_I && (opcode & 0x0F) != 0) {
+                    analysis.sprites.push_back(Analysis::Region {I, static_cast<std::size_t>(opcode & 0x0F)});
+                }
+
+                block.end = address + 2;
+                bool ends {flow(rom, address, next)};
+                if (ends || leaders.count(block.end) != 0 || reached.count(block.end) == 0) {
+                    block.successors = next;
+                    break;
+                }
+            }
+
+            std::sort(block.successors.begin(), block.successors.end());
+            block.successors.erase(std::unique(block.successors.begin(), block.successors.end()), block.successors.end());
+            analysis.blocks[leader] = block;
+        }
+
+        // Sprites in order, overlapping ones merged, marked on the map unless they're code as well.
+        std::sort(analysis.sprites.begin(), analysis.sprites.end(),
+                  [](const Analysis::Region& a, const Analysis::Region& b) { return a.start < b.start; });
+        std::vector<Analysis::Region> merged;
+        for (const Analysis::Region& sprite : analysis.sprites) {
+            if (!merged.empty() && sprite.start <= merged.back().start + merged.back().length) {
+                merged.back().length = std::max(merged.back().length, sprite.start + sprite.length - merged.back().start);
+            } else merged.push_back(sprite);
+        }
+
+        analysis.sprites = merged;
+        for (const Analysis::Region& sprite : analysis.sprites) {
+            for (std::size_t i {0}; i < sprite.length && sprite.start + i < Memory::SIZE; ++i) {
+                if (analysis.map[sprite.start + i] != Analysis::Kind::CODE) analysis.map[sprite.start + i] = Analysis::Kind::SPRITE;
+            }
+        }
+
+        return analysis;
+    }
+
+    std::vector<addr> Analysis::instructions() const {
+        std::vector<addr> found;
+        for (const std::pair<const addr, Block>& entry : blocks) {
+            for (addr address {entry.second.start}; address < entry.second.end; address += 2) found.push_back(address);
+        }
+
+        std::sort(found.begin(), found.end());
+        found.erase(std::unique(found.begin(), found.end()), found.end());
+        return found;
+    }
+
+    void Analysis::write(std::ostream& stream) const {
+        std::ios::fmtflags flags {stream.flags()};
+        stream << std::hex << std::uppercase << std::setfill('0');
+        for (const std::pair<const addr, Block>& entry : blocks) {
+            stream << "block 0x" << std::setw(3) << entry.second.start << "-0x" << std::setw(3) << entry.second.end - 1;
+            for (std::size_t i {0}; i < entry.second.successors.size(); ++i)
+                stream << (i == 0 ? " -> " : ", ") << "0x" << std::setw(3) << entry.second.successors[i];
+            stream << '\n';
+        }
+
+        // Runs of the same kind, ends inclusive, like the blocks.
+        for (std::size_t start {0}; start < map.size(); ) {
+            std::size_t end {start};
+            while (end + 1 < map.size() && map[end + 1] == map[start]) ++end;
+            if (map[start] != Kind::NONE)
+                stream << kind_name(map[start]) << " 0x" << std::setw(3) << start << "-0x" << std::setw(3) << end << '\n';
+            start = end + 1;
+        }
+
+        stream.flags(flags);
+    }
+
+    void Analysis::write_dot(std::ostream& stream) const {
+        std::ios::fmtflags flags {stream.flags()};
+        stream << std::hex << std::uppercase << std::setfill('0') << "digraph cfg {\n    node [shape=box, fontname=monospace];\n";
+        for (const std::pair<const addr, Block>& entry : blocks) {
+            stream << "    b" << std::setw(3) << entry.first << " [label=\"0x" << std::setw(3) << entry.second.start
+                   << "-0x" << std::setw(3) << entry.second.end - 1 << "\"];\n";
+            for (addr successor : entry.second.successors) {
+                if (blocks.count(successor) != 0) stream << "    b" << std::setw(3) << entry.first << " -> b" << std::setw(3) << successor << ";\n";
+            }
+        }
+
+        stream << "}\n";
+        stream.flags(flags);
+    }
+
+    const char* Analysis::kind_name(Kind kind) {
+        switch (kind) {
+        case Kind::NONE: return "none";
+        case Kind::DATA: return "data";
+        case Kind::CODE: return "code";
+        case Kind::SPRITE: return "sprite";
+        default: return "unknown";
+        }
+    }
+}
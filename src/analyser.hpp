@@ -0,0 +1,49 @@
+#ifndef CH8_ANALYSER_HPP
+#define CH8_ANALYSER_HPP
+
+#include <map>
+#include <vector>
+#include <ostream>
+#include "definitions.hpp"
+#include "memory.hpp"
+
+namespace ch8 {
+    // What a ROM looks like without running it, found by disassembling recursively from 0x200
+    // and following every jump, call and skip. JP V0, nnn is assumed to index a table of jumps
+    // at nnn, which is how ROMs use it. Code only reachable some other way, e.g. written at
+    // runtime, is missed and shows up as data.
+    struct Analysis {
+        enum class Kind : byte {
+            NONE, // Outside of the ROM.
+            DATA, // In the ROM, but never reached.
+            CODE, // Part of an instruction that's reached.
+            SPRITE // Data that's drawn, from an LD I, nnn before a DRW in the same block.
+        };
+
+        struct Block {
+            addr start, end; // Instructions from start up to, but not including, end.
+            std::vector<addr> successors; // Where it can go next, calls included, in address order.
+        };
+
+        struct Region {
+            addr start;
+            std::size_t length;
+        };
+
+        std::vector<Kind> map; // By address, for all of memory.
+        std::map<addr, Block> blocks; // By start.
+        std::vector<Region> sprites; // Merged where they overlap, in address order.
+
+        std::vector<addr> instructions() const; // Addresses of every instruction reached, in order.
+        void write(std::ostream&) const; // Blocks, then regions of the map, one per line.
+        void write_dot(std::ostream&) const; // Control-flow graph for Graphviz.
+        static const char* kind_name(Kind); // E.g. "sprite".
+    };
+
+    class Analyser {
+    public:
+        static Analysis analyse(const byte*, std::size_t); // Program of size k, loaded at 0x200. Throws if it doesn't fit.
+    };
+}
+
+#endif
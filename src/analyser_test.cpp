@@ -0,0 +1,82 @@
+#include <sstream>
+#include "catch.hpp"
+#include "analyser.hpp"
+#include "processor.hpp"
+
+namespace {
+    const ch8::byte program[] = {
+        0x00, 0xE0, // 0x200: CLS
+        0x22, 0x10, // 0x202: CALL 0x210
+        0x30, 0x01, // 0x204: SE V0, 0x01
+        0x12, 0x04, // 0x206: JP 0x204
+        0xB2, 0x0C, // 0x208: JP V0, 0x20C
+        0x00, 0xFD, // 0x20A: EXIT
+        0x12, 0x0A, // 0x20C: JP 0x20A, the jump table
+        0x12, 0x00, // 0x20E: JP 0x200
+        0xA2, 0x18, // 0x210: LD I, 0x218
+        0xD0, 0x15, // 0x212: DRW V0, V1, 5
+        0x00, 0xEE, // 0x214: RET
+        0xFF, 0xFF, // 0x216: Never reached.
+        0xF0, 0x90, 0x90, 0x90, 0xF0, // 0x218: Sprite of a zero.
+        0xAA // 0x21D: Never used.
+    };
+}
+
+TEST_CASE("Analyser finds blocks and where they go.", "[analyser]") {
+    ch8::Analysis analysis {ch8::Analyser::analyse(program, sizeof(program))};
+    REQUIRE(analysis.blocks.size() == 8);
+    REQUIRE(analysis.blocks.at(0x200).end == 0x204);
+    REQUIRE(analysis.blocks.at(0x200).successors == (std::vector<ch8::addr> {0x204, 0x210})); // Call and return.
+    REQUIRE(analysis.blocks.at(0x204).successors == (std::vector<ch8::addr> {0x206, 0x208})); // Skip.
+    REQUIRE(analysis.blocks.at(0x206).successors == (std::vector<ch8::addr> {0x204}));
+    REQUIRE(analysis.blocks.at(0x208).successors == (std::vector<ch8::addr> {0x20C, 0x20E})); // Jump table.
+    REQUIRE(analysis.blocks.at(0x20A).successors.empty());
+    REQUIRE(analysis.blocks.at(0x20E).successors == (std::vector<ch8::addr> {0x200}));
+    REQUIRE(analysis.blocks.at(0x210).end == 0x216);
+    REQUIRE(analysis.blocks.at(0x210).successors.empty());
+    REQUIRE(analysis.instructions().size() == 11);
+    REQUIRE(analysis.instructions().back() == 0x214);
+}
+
+TEST_CASE("Analyser separates code, data and sprites.", "[analyser]") {
+    ch8::Analysis analysis {ch8::Analyser::analyse(program, sizeof(program))};
+    REQUIRE(analysis.map[0x1FF] == ch8::Analysis::Kind::NONE);
+    REQUIRE(analysis.map[0x200] == ch8::Analysis::Kind::CODE);
+    REQUIRE(analysis.map[0x215] == ch8::Analysis::Kind::CODE);
+    REQUIRE(analysis.map[0x216] == ch8::Analysis::Kind::DATA);
+    REQUIRE(analysis.map[0x218] == ch8::Analysis::Kind::SPRITE);
+    REQUIRE(analysis.map[0x21C] == ch8::Analysis::Kind::SPRITE);
+    REQUIRE(analysis.map[0x21D] == ch8::Analysis::Kind::DATA);
+    REQUIRE(analysis.map[0x21E] == ch8::Analysis::Kind::NONE);
+    REQUIRE(analysis.sprites.size() == 1);
+    REQUIRE(analysis.sprites[0].start == 0x218);
+    REQUIRE(analysis.sprites[0].length == 5);
+
+    std::ostringstream stream;
+    analysis.write(stream);
+    REQUIRE(stream.str().find("block 0x208-0x209 -> 0x20C, 0x20E\n") != std::string::npos);
+    REQUIRE(stream.str().find("code 0x200-0x215\ndata 0x216-0x217\nsprite 0x218-0x21C\ndata 0x21D-0x21D\n") != std::string::npos);
+    stream.str("");
+    analysis.write_dot(stream);
+    REQUIRE(stream.str().find("b208 -> b20C;") != std::string::npos);
+}
+
+TEST_CASE("Analyser stops at the end of the ROM and rejects ones that don't fit.", "[analyser]") {
+    const ch8::byte falls_off[] = {0x60, 0x01, 0x70}; // LD V0, 0x01 then half an instruction.
+    ch8::Analysis analysis {ch8::Analyser::analyse(falls_off, sizeof(falls_off))};
+    REQUIRE(analysis.blocks.size() == 1);
+    REQUIRE(analysis.blocks.at(0x200).end == 0x202);
+    REQUIRE(analysis.map[0x202] == ch8::Analysis::Kind::DATA);
+
+    std::vector<ch8::byte> huge(ch8::Memory::PROGRAM_SIZE + 1);
+    REQUIRE_THROWS_AS(ch8::Analyser::analyse(huge.data(), huge.size()), const std::length_error&);
+}
+
+TEST_CASE("Warming the predecode cache doesn't change what runs.", "[analyser]") {
+    ch8::Memory warmed_memory {program, sizeof(program)}, cold_memory {program, sizeof(program)};
+    ch8::Processor warmed {warmed_memory, 0}, cold {cold_memory, 0};
+    warmed.warm(ch8::Analyser::analyse(program, sizeof(program)).instructions());
+    REQUIRE(warmed.run(100) == cold.run(100));
+    REQUIRE(warmed.register_state(ch8::Processor::Register::PC) == cold.register_state(ch8::Processor::Register::PC));
+    REQUIRE(warmed.register_state(ch8::Processor::Register::SP) == cold.register_state(ch8::Processor::Register::SP));
+}
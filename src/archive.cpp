@@ -0,0 +1,167 @@
+#include "archive.hpp"
+#include "memory.hpp"
+#include "hash.hpp"
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+namespace ch8 {
+    namespace {
+        const char MAGIC[8] = {'C', 'H', '8', 'P', 'A', 'C', 'K', '\0'};
+
+        std::uint64_t get(const byte* data, std::size_t size) {
+            std::uint64_t value {0};
+            for (std::size_t i {size}; i > 0; --i) value = (value << 8) | data[i - 1];
+            return value;
+        }
+
+        void put(std::vector<byte>& data, std::uint64_t value, std::size_t size) {
+            for (std::size_t i {0}; i < size; ++i, value >>= 8) data.push_back(static_cast<byte>(value));
+        }
+    }
+
+    constexpr std::uint32_t Archive::VERSION;
+    constexpr std::size_t Archive::HEADER_SIZE;
+    constexpr std::size_t Archive::ENTRY_SIZE;
+    Archive::Archive(const std::string& path) : file {path} {
+        if (file.size() < HEADER_SIZE || std::memcmp(file.data(), MAGIC, sizeof(MAGIC)) != 0)
+            throw std::runtime_error {"Couldn't open archive " + path + ", not an archive."};
+        if (get(file.data() + 8, 4) != VERSION)
+            throw std::runtime_error {"Couldn't open archive " + path + ", unsupported version."};
+
+        // Tables are checked once here, so lookups only need to check what the entries point to.
+        count = get(file.data() + 12, 4);
+        try {
+            entries = bytes(get(file.data() + 16, 8), count * ENTRY_SIZE).data;
+            names = bytes(get(file.data() + 24, 8), count * 4).data;
+        } catch (const std::out_of_range&) {
+            throw std::runtime_error {"Couldn't open archive " + path + ", tables are truncated."};
+        }
+
+        for (std::size_t i {0}; i < count; ++i) {
+            if (get(names + i * 4, 4) >= count) throw std::runtime_error {"Couldn't open archive " + path + ", bad name table."};
+        }
+    }
+
+    Span Archive::bytes(std::uint64_t offset, std::uint64_t size) const {
+        if (offset > file.size() || size > file.size() - offset)
+            throw std::out_of_range {"Couldn't read archive, entry is outside of it."};
+        return Span {file.data() + offset, static_cast<std::size_t>(size)};
+    }
+
+    std::uint64_t Archive::entry_hash(std::size_t i) const {
+        return get(entries + i * ENTRY_SIZE, 8);
+    }
+
+    Span Archive::entry_name(std::size_t i) const {
+        const byte* entry {entries + i * ENTRY_SIZE};
+        return bytes(get(entry + 20, 4), get(entry + 24, 4));
+    }
+
+    Span Archive::entry_rom(std::size_t i) const {
+        const byte* entry {entries + i * ENTRY_SIZE};
+        return bytes(get(entry + 8, 8), get(entry + 16, 4));
+    }
+
+    Archive::Entry Archive::entry(std::size_t i) const {
+        if (i >= count) throw std::out_of_range {"Couldn't read archive, no such entry."};
+        Span name {entry_name(i)};
+        return Entry {entry_hash(i), std::string {reinterpret_cast<const char*>(name.data), name.size}, entry_rom(i)};
+    }
+
+    bool Archive::find(std::uint64_t hash, Span& rom) const {
+        std::size_t low {0}, high {count};
+        while (low < high) {
+            std::size_t middle {low + (high - low) / 2};
+            if (entry_hash(middle) < hash) low = middle + 1;
+            else high = middle;
+        }
+
+        if (low == count || entry_hash(low) != hash) return false;
+        rom = entry_rom(low);
+        return true;
+    }
+
+    bool Archive::find(const std::string& name, Span& rom) const {
+        // Compared in place, same ordering as std::string uses when the archive is written.
+        auto compare = [&](std::size_t entry) {
+            Span entry_name_span {entry_name(entry)};
+            return -name.compare(0, std::string::npos, reinterpret_cast<const char*>(entry_name_span.data), entry_name_span.size);
+        };
+
+        std::size_t low {0}, high {count};
+        while (low < high) {
+            std::size_t middle {low + (high - low) / 2};
+            if (compare(get(names + middle * 4, 4)) < 0) low = middle + 1;
+            else high = middle;
+        }
+
+        if (low == count) return false;
+        std::size_t entry {static_cast<std::size_t>(get(names + low * 4, 4))};
+        if (compare(entry) != 0) return false;
+        rom = entry_rom(entry);
+        return true;
+    }
+
+    void Archive::write(std::ostream& stream, const std::vector<Rom>& roms) {
+        struct Pending {
+            std::uint64_t hash;
+            const Rom* rom;
+        };
+
+        std::vector<Pending> pending;
+        for (const Rom& rom : roms) {
+            if (rom.data.size() > Memory::PROGRAM_SIZE) throw std::invalid_argument {"ROM " + rom.name + " doesn't fit in memory."};
+            pending.push_back(Pending {Hash::xxh64(rom.data.data(), rom.data.size()), &rom});
+        }
+
+        std::stable_sort(pending.begin(), pending.end(),
+                         [](const Pending& a, const Pending& b) { return a.hash < b.hash; });
+        std::vector<std::uint32_t> by_name(pending.size());
+        for (std::uint32_t i {0}; i < by_name.size(); ++i) by_name[i] = i;
+        std::sort(by_name.begin(), by_name.end(),
+                  [&](std::uint32_t a, std::uint32_t b) { return pending[a].rom->name < pending[b].rom->name; });
+        for (std::size_t i {1}; i < by_name.size(); ++i) {
+            if (pending[by_name[i]].rom->name == pending[by_name[i - 1]].rom->name)
+                throw std::invalid_argument {"ROM " + pending[by_name[i]].rom->name + " is in the archive twice."};
+        }
+
+        std::uint64_t entries_offset {HEADER_SIZE};
+        std::uint64_t names_offset {entries_offset + pending.size() * ENTRY_SIZE};
+        std::uint64_t strings_offset {names_offset + pending.size() * 4};
+        std::uint64_t images_offset {strings_offset};
+        for (const Pending& rom : pending) images_offset += rom.rom->name.size();
+
+        std::vector<byte> tables;
+        tables.insert(tables.end(), MAGIC, MAGIC + sizeof(MAGIC));
+        put(tables, VERSION, 4);
+        put(tables, pending.size(), 4);
+        put(tables, entries_offset, 8);
+        put(tables, names_offset, 8);
+
+        std::vector<byte> images;
+        std::map<std::uint64_t, std::uint64_t> stored; // Hash to offset, images are deduplicated.
+        std::uint64_t string_offset {strings_offset};
+        for (const Pending& rom : pending) {
+            auto image = stored.find(rom.hash);
+            if (image == stored.end()) {
+                image = stored.emplace(rom.hash, images_offset + images.size()).first;
+                images.insert(images.end(), rom.rom->data.begin(), rom.rom->data.end());
+            }
+
+            put(tables, rom.hash, 8);
+            put(tables, image->second, 8);
+            put(tables, rom.rom->data.size(), 4);
+            put(tables, string_offset, 4);
+            put(tables, rom.rom->name.size(), 4);
+            put(tables, 0, 4);
+            string_offset += rom.rom->name.size();
+        }
+
+        for (std::uint32_t entry : by_name) put(tables, entry, 4);
+        for (const Pending& rom : pending) tables.insert(tables.end(), rom.rom->name.begin(), rom.rom->name.end());
+        stream.write(reinterpret_cast<const char*>(tables.data()), tables.size());
+        stream.write(reinterpret_cast<const char*>(images.data()), images.size());
+        if (!stream) throw std::runtime_error {"Couldn't write archive."};
+    }
+}
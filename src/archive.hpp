@@ -0,0 +1,62 @@
+#ifndef CH8_ARCHIVE_HPP
+#define CH8_ARCHIVE_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include "definitions.hpp"
+#include "loader.hpp"
+
+namespace ch8 {
+    // Single file holding many ROMs, so a sweep maps one file instead of opening
+    // thousands. Everything is little endian, the layout of version 1 being:
+    //
+    //     Header: "CH8PACK\0", u32 version, u32 count, u64 entries, u64 names.
+    //     Entries: count * {u64 xxh64, u64 offset, u32 size, u32 name offset, u32 name size, u32 zero},
+    //              sorted by hash, so lookups by hash are a binary search.
+    //     Names: count * u32 entry index, sorted by ROM name, the same but by name.
+    //     Strings and then ROM images, identical images are only stored once.
+    //
+    // ROM spans point straight into the mapping, ready to be handed to Memory.
+    class Archive {
+    public:
+        struct Rom {
+            std::string name;
+            std::vector<byte> data;
+        };
+
+        struct Entry {
+            std::uint64_t hash; // XXH64 of the ROM image, with seed 0.
+            std::string name;
+            Span rom;
+        };
+
+        explicit Archive(const std::string&); // Maps the archive, throws std::runtime_error if invalid.
+        std::size_t size() const { return count; }
+        Entry entry(std::size_t) const; // In hash order.
+        bool find(std::uint64_t, Span&) const; // O(log n) by hash, false if not found.
+        bool find(const std::string&, Span&) const; // O(log n) by name, false if not found.
+
+        // Writes an archive, throws std::invalid_argument for duplicate names or ROMs that don't fit.
+        static void write(std::ostream&, const std::vector<Rom>&);
+
+        static constexpr std::uint32_t VERSION {1};
+        static constexpr std::size_t HEADER_SIZE {32};
+        static constexpr std::size_t ENTRY_SIZE {32};
+
+    private:
+        std::uint64_t entry_hash(std::size_t) const;
+        Span entry_name(std::size_t) const;
+        Span entry_rom(std::size_t) const;
+        Span bytes(std::uint64_t, std::uint64_t) const; // Bounds checked view into the mapping.
+
+        MappedFile file;
+        std::size_t count;
+        const byte* entries;
+        const byte* names;
+    };
+}
+
+#endif
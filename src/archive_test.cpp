@@ -0,0 +1,105 @@
+#include "catch.hpp"
+#include "archive.hpp"
+#include "loader.hpp"
+#include "memory.hpp"
+#include "hash.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+    // Writes an archive to a fresh temporary file, which is removed when going out of scope.
+    struct TemporaryArchive {
+        explicit TemporaryArchive(const std::string& contents) {
+            char name[] = "/tmp/chip-8_archive_XXXXXX";
+            int descriptor {mkstemp(name)};
+            REQUIRE(descriptor != -1);
+            REQUIRE(write(descriptor, contents.data(), contents.size()) == static_cast<ssize_t>(contents.size()));
+            close(descriptor);
+            path = name;
+        }
+
+        ~TemporaryArchive() { unlink(path.c_str()); }
+        std::string path;
+    };
+
+    std::string pack(const std::vector<ch8::Archive::Rom>& roms) {
+        std::ostringstream stream;
+        ch8::Archive::write(stream, roms);
+        return stream.str();
+    }
+}
+
+TEST_CASE("Packing and finding ROMs.", "[archive, lookup]") {
+    std::vector<ch8::Archive::Rom> roms {
+        {"PONG", {0x6A, 0x02, 0x6B, 0x0C}},
+        {"BRIX", {0x6E, 0x05, 0x65, 0x00, 0x6B, 0x06}},
+        {"PONG2", {0x6A, 0x02, 0x6B, 0x0C}}, // Same image as PONG.
+        {"MAZE", {0xA2, 0x1E}}
+    };
+
+    std::string contents {pack(roms)};
+    TemporaryArchive file {contents};
+    ch8::Archive archive {file.path};
+    REQUIRE(archive.size() == roms.size());
+
+    for (const ch8::Archive::Rom& rom : roms) {
+        ch8::Span by_name;
+        REQUIRE(archive.find(rom.name, by_name));
+        REQUIRE(std::vector<ch8::byte>(by_name.data, by_name.data + by_name.size) == rom.data);
+
+        ch8::Span by_hash;
+        REQUIRE(archive.find(ch8::Hash::xxh64(rom.data.data(), rom.data.size()), by_hash));
+        REQUIRE(by_hash.data == by_name.data);
+    }
+
+    ch8::Span pong, pong2;
+    archive.find("PONG", pong);
+    archive.find("PONG2", pong2);
+    REQUIRE(pong.data == pong2.data); // Stored once.
+    std::size_t tables {ch8::Archive::HEADER_SIZE + roms.size() * (ch8::Archive::ENTRY_SIZE + 4)};
+    REQUIRE(contents.size() == tables + 17 + 12); // Names, then images without the copy of PONG.
+
+    ch8::Span missing;
+    REQUIRE_FALSE(archive.find("PON", missing));
+    REQUIRE_FALSE(archive.find("ZZZ", missing));
+    REQUIRE_FALSE(archive.find(std::uint64_t {42}, missing));
+
+    for (std::size_t i {1}; i < archive.size(); ++i)
+        REQUIRE(archive.entry(i - 1).hash <= archive.entry(i).hash);
+    REQUIRE_THROWS_AS(archive.entry(archive.size()), const std::out_of_range&);
+}
+
+TEST_CASE("Loading ROMs from archives.", "[archive, loader]") {
+    std::vector<ch8::Archive::Rom> roms {{"PONG", {0x6A, 0x02}}, {"BRIX", {0x6E, 0x05}}};
+    TemporaryArchive file {pack(roms)};
+    ch8::Loader loader;
+
+    ch8::Memory memory {loader.load(file.path + "#BRIX")};
+    REQUIRE(memory.read(0x200) == 0x6E);
+    REQUIRE(memory.read(0x201) == 0x05);
+
+    std::ostringstream reference;
+    reference << file.path << "#xxh64:" << std::hex << ch8::Hash::xxh64(roms[0].data.data(), roms[0].data.size());
+    REQUIRE(loader.load(reference.str()).data[0] == 0x6A);
+    REQUIRE(&loader.archive(file.path) == &loader.archive(file.path)); // Opened only once.
+
+    REQUIRE_THROWS_AS(loader.load(file.path + "#TETRIS"), const std::runtime_error&);
+    REQUIRE_THROWS_AS(loader.load(file.path + "#xxh64:zz"), const std::runtime_error&);
+}
+
+TEST_CASE("Rejecting bad archives.", "[archive, errors]") {
+    REQUIRE_THROWS_AS(pack({{"PONG", {0x00}}, {"PONG", {0x01}}}), const std::invalid_argument&);
+    REQUIRE_THROWS_AS(pack({{"HUGE", std::vector<ch8::byte>(ch8::Memory::PROGRAM_SIZE + 1)}}), const std::invalid_argument&);
+
+    TemporaryArchive not_archive {"CH8PACX, not an archive at all but long enough for a header."};
+    REQUIRE_THROWS_AS(ch8::Archive {not_archive.path}, const std::runtime_error&);
+
+    std::string truncated {pack({{"PONG", {0x6A, 0x02}}})};
+    truncated.resize(ch8::Archive::HEADER_SIZE + 8);
+    TemporaryArchive truncated_archive {truncated};
+    REQUIRE_THROWS_AS(ch8::Archive {truncated_archive.path}, const std::runtime_error&);
+}
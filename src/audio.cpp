@@ -0,0 +1,118 @@
+#include "audio.hpp"
+#include <cmath>
+#include <algorithm>
+
+namespace ch8 {
+    namespace {
+        constexpr float LOUDNESS {0.25f}; // Of a full scale square wave, which is loud.
+        constexpr double RAMP {0.005}; // Seconds from silent to full volume, and back.
+        const double PI {std::acos(-1.0)};
+    }
+
+    constexpr std::size_t AudioMessage::PATTERN_SIZE;
+    constexpr std::size_t AudioQueue::CAPACITY;
+    bool AudioQueue::push(const AudioMessage& message) {
+        std::size_t at {tail.load(std::memory_order_relaxed)};
+        if (at - head.load(std::memory_order_acquire) == CAPACITY) return false;
+        messages[at % CAPACITY] = message;
+        tail.store(at + 1, std::memory_order_release); // Publishes the message written above.
+        return true;
+    }
+
+    bool AudioQueue::pop(AudioMessage& message) {
+        std::size_t at {head.load(std::memory_order_relaxed)};
+        if (tail.load(std::memory_order_acquire) == at) return false;
+        message = messages[at % CAPACITY];
+        head.store(at + 1, std::memory_order_release); // Hands the slot back to the producer.
+        return true;
+    }
+
+    constexpr std::size_t AudioEngine::TAPS;
+    constexpr std::size_t AudioEngine::PHASES;
+    constexpr std::size_t AudioEngine::LANES;
+    constexpr std::size_t AudioEngine::PATTERN_BITS;
+    const byte AudioEngine::BEEP[AudioMessage::PATTERN_SIZE] = {
+        0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00,
+        0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00
+    };
+
+    AudioEngine::AudioEngine(AudioQueue& messages, double samples_per_second) : queue {messages}, rate {samples_per_second} {
+        AudioMessage silent {{0}, 64, false};
+        std::copy(BEEP, BEEP + AudioMessage::PATTERN_SIZE, silent.pattern);
+        apply(silent);
+    }
+
+    double AudioEngine::frequency(byte pitch) {
+        return 4000.0 * std::pow(2.0, (pitch - 64) / 48.0);
+    }
+
+    void AudioEngine::apply(const AudioMessage& message) {
+        // Centered on zero, so patterns that are mostly (or all) ones or zeros don't thump when started.
+        std::size_t ones {0};
+        for (std::size_t i {0}; i < PATTERN_BITS; ++i) ones += (message.pattern[i / 8] >> (7 - i % 8)) & 1;
+        float mean {static_cast<float>(ones) / PATTERN_BITS};
+        for (std::size_t j {0}; j < PATTERN_BITS + TAPS; ++j) {
+            std::size_t i {(j + PATTERN_BITS - (TAPS / 2 - 1)) % PATTERN_BITS}; // Window starts this far before.
+            samples[j] = 2.0f * (((message.pattern[i / 8] >> (7 - i % 8)) & 1) - mean);
+        }
+
+        double played {frequency(message.pitch)};
+        step = played / rate;
+        double wanted {std::min(1.0, rate / played)}; // Anything above the output's Nyquist rate is cut too.
+        if (wanted != cutoff) design(wanted);
+        target = message.playing ? 1.0f : 0.0f;
+    }
+
+    void AudioEngine::design(double fraction) {
+        cutoff = fraction;
+        for (std::size_t phase {0}; phase < PHASES; ++phase) {
+            double sum {0.0}, taps[TAPS];
+            for (std::size_t k {0}; k < TAPS; ++k) {
+                double x {static_cast<double>(phase) / PHASES + TAPS / 2 - 1 - static_cast<double>(k)}; // From the output sample.
+                double sinc {x == 0.0 ? 1.0 : std::sin(PI * fraction * x) / (PI * fraction * x)};
+                double blackman {0.42 + 0.5 * std::cos(2.0 * PI * x / TAPS) + 0.08 * std::cos(4.0 * PI * x / TAPS)};
+                taps[k] = sinc * blackman;
+                sum += taps[k];
+            }
+
+            for (std::size_t k {0}; k < TAPS; ++k) filters[phase][k] = static_cast<float>(taps[k] / sum); // Unity gain.
+        }
+    }
+
+    void AudioEngine::render(float* output, std::size_t count) {
+        // Only the newest state matters, every message has all of it.
+        AudioMessage message, newest;
+        bool received {false};
+        while (queue.pop(message)) {
+            newest = message;
+            received = true;
+        }
+
+        if (received) apply(newest);
+        const float ramp {static_cast<float>(1.0 / (RAMP * rate))};
+        for (std::size_t i {0}; i < count; ++i) {
+            if (volume == 0.0f && target == 0.0f) {
+                std::fill(output + i, output + count, 0.0f);
+                return;
+            }
+
+            std::size_t whole {static_cast<std::size_t>(position)};
+            const float* filter {filters[static_cast<std::size_t>((position - whole) * PHASES)]};
+            const float* window {samples + whole};
+
+            // Partial sums kept apart, so the products vectorize without reassociating floats.
+            float lanes[LANES] = {0.0f};
+            for (std::size_t k {0}; k < TAPS; k += LANES) {
+                for (std::size_t l {0}; l < LANES; ++l) lanes[l] += filter[k + l] * window[k + l];
+            }
+
+            float sum {0.0f};
+            for (std::size_t l {0}; l < LANES; ++l) sum += lanes[l];
+            volume = volume < target ? std::min(target, volume + ramp) : std::max(target, volume - ramp);
+            output[i] = sum * volume * LOUDNESS;
+
+            position += step;
+            if (position >= PATTERN_BITS) position -= PATTERN_BITS;
+        }
+    }
+}
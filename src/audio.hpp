@@ -0,0 +1,63 @@
+#ifndef CH8_AUDIO_HPP
+#define CH8_AUDIO_HPP
+
+#include <atomic>
+#include <cstddef>
+#include "definitions.hpp"
+
+namespace ch8 {
+    // What should be playing, sent by the emulation thread whenever any of it changes.
+    struct AudioMessage {
+        static constexpr std::size_t PATTERN_SIZE {16};
+        byte pattern[PATTERN_SIZE]; // 128 1-bit samples, the first in the top bit, as loaded by F002.
+        byte pitch; // How fast they're played, as set by FX3A.
+        bool playing; // While the sound timer runs.
+    };
+
+    // Lock-free ring with a single producer and a single consumer, like TraceRing, but fixed in
+    // size and never waited on by either side. Every message has the whole state, so whenever
+    // it's full the producer just sends its newest one again later, nothing else is lost.
+    class AudioQueue {
+    public:
+        static constexpr std::size_t CAPACITY {16};
+        bool push(const AudioMessage&); // Producer only, false if the ring is full.
+        bool pop(AudioMessage&); // Consumer only, false if the ring is empty.
+
+    private:
+        AudioMessage messages[CAPACITY];
+        alignas(64) std::atomic<std::size_t> head {0}; // Next to pop, only moved by the consumer.
+        alignas(64) std::atomic<std::size_t> tail {0}; // Next to push, only moved by the producer.
+    };
+
+    // Plays the pattern on a loop at its pitch, resampled to the output rate by windowed sincs,
+    // so its edges don't alias. Filters are tabulated for PHASES offsets between two samples, of
+    // TAPS samples each, which makes every output sample a dot product the compiler vectorizes
+    // (build with NATIVE=YES for AVX2). Starting and stopping ramp the volume, to avoid clicks.
+    class AudioEngine {
+    public:
+        static constexpr std::size_t TAPS {16};
+        static constexpr std::size_t PHASES {128};
+        static constexpr std::size_t LANES {8}; // Partial sums per output sample, a vector's worth.
+        static constexpr std::size_t PATTERN_BITS {AudioMessage::PATTERN_SIZE * 8};
+        static const byte BEEP[AudioMessage::PATTERN_SIZE]; // Square wave for other profiles, 250 Hz at pitch 64.
+
+        AudioEngine(AudioQueue&, double); // Takes messages from the queue, and renders this many samples a second.
+        void render(float*, std::size_t); // Mono, from the audio thread only. Never waits, never allocates.
+        static double frequency(byte); // Pattern samples a second for a pitch, 4000 * 2^((pitch - 64) / 48).
+
+    private:
+        void apply(const AudioMessage&);
+        void design(double); // Fills the filters for a cutoff, as a fraction of the pattern's Nyquist rate.
+
+        AudioQueue& queue;
+        double rate;
+        double position {0.0}; // In pattern samples, since the start of the loop.
+        double step {0.0}; // Pattern samples for every output sample.
+        double cutoff {0.0};
+        float volume {0.0f}, target {0.0f};
+        alignas(64) float filters[PHASES][TAPS];
+        alignas(64) float samples[PATTERN_BITS + TAPS]; // Without DC, and looped past the end so windows never wrap.
+    };
+}
+
+#endif
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "catch.hpp"
+#include "audio.hpp"
+
+namespace {
+    ch8::AudioMessage beep(bool playing) {
+        ch8::AudioMessage message {{0}, 64, playing};
+        std::copy(ch8::AudioEngine::BEEP, ch8::AudioEngine::BEEP + ch8::AudioMessage::PATTERN_SIZE, message.pattern);
+        return message;
+    }
+}
+
+TEST_CASE("Audio queues keep messages in order, without waiting.", "[audio]") {
+    ch8::AudioQueue queue;
+    ch8::AudioMessage message {beep(true)};
+    for (std::size_t i {0}; i < ch8::AudioQueue::CAPACITY; ++i) {
+        message.pitch = static_cast<ch8::byte>(i);
+        REQUIRE(queue.push(message));
+    }
+
+    REQUIRE(!queue.push(message)); // Full.
+    for (std::size_t i {0}; i < ch8::AudioQueue::CAPACITY; ++i) {
+        REQUIRE(queue.pop(message));
+        REQUIRE(message.pitch == i);
+    }
+
+    REQUIRE(!queue.pop(message)); // Empty.
+    REQUIRE(queue.push(message));
+}
+
+TEST_CASE("Audio pitch is XO-CHIP's.", "[audio]") {
+    REQUIRE(ch8::AudioEngine::frequency(64) == Approx(4000.0));
+    REQUIRE(ch8::AudioEngine::frequency(112) == Approx(8000.0));
+    REQUIRE(ch8::AudioEngine::frequency(16) == Approx(2000.0));
+}
+
+TEST_CASE("Audio engines play patterns at their pitch, and stop without clicks.", "[audio]") {
+    ch8::AudioQueue queue;
+    ch8::AudioEngine engine {queue, 48000.0};
+    std::vector<float> output(48000, 1.0f);
+    engine.render(output.data(), output.size());
+    REQUIRE(std::all_of(output.begin(), output.end(), [](float sample) { return sample == 0.0f; }));
+
+    REQUIRE(queue.push(beep(true)));
+    engine.render(output.data(), output.size()); // A second of it, 250 Hz at pitch 64.
+    float loudest {0.0f};
+    std::size_t crossings {0};
+    for (std::size_t i {4800}; i < output.size(); ++i) { // Past the ramp up.
+        loudest = std::max(loudest, std::fabs(output[i]));
+        if ((output[i - 1] < 0.0f) != (output[i] < 0.0f)) ++crossings;
+    }
+
+    REQUIRE(loudest > 0.2f);
+    REQUIRE(loudest < 0.35f); // Some ringing at the edges, but not much.
+    REQUIRE(crossings >= 440);
+    REQUIRE(crossings <= 460);
+
+    REQUIRE(queue.push(beep(false)));
+    engine.render(output.data(), 480);
+    REQUIRE(std::fabs(output[0]) <= loudest); // Ramps down, doesn't cut off.
+    REQUIRE(std::all_of(output.begin() + 240, output.begin() + 480, [](float sample) { return sample == 0.0f; }));
+}
+
+TEST_CASE("Audio engines only apply the newest message.", "[audio]") {
+    ch8::AudioQueue queue;
+    ch8::AudioEngine engine {queue, 48000.0};
+    REQUIRE(queue.push(beep(true)));
+    REQUIRE(queue.push(beep(false)));
+
+    std::vector<float> output(480, 1.0f);
+    engine.render(output.data(), output.size());
+    REQUIRE(std::all_of(output.begin(), output.end(), [](float sample) { return sample == 0.0f; }));
+
+    ch8::AudioMessage high {beep(true)};
+    high.pitch = 255; // Pattern samples come faster than output ones, so the filter cuts lower.
+    REQUIRE(queue.push(high));
+    engine.render(output.data(), output.size());
+    REQUIRE(std::all_of(output.begin(), output.end(), [](float sample) { return std::fabs(sample) < 0.35f; }));
+}
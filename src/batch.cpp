@@ -0,0 +1,243 @@
+#include "batch.hpp"
+#include "hash.hpp"
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <algorithm>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+
+namespace ch8 {
+    namespace {
+        Movie read_movie(const std::string& path) {
+            if (path == "-") return Movie {};
+            std::ifstream stream {path};
+            if (!stream) throw std::runtime_error {"Couldn't open movie " + path + '.'};
+            return Movie::parse(stream);
+        }
+
+        void write_json_string(std::ostream& stream, const std::string& string) {
+            stream << '"';
+            for (char c : string) {
+                if (c == '"' || c == '\\') stream << '\\' << c;
+                else if (static_cast<unsigned char>(c) < 0x20) {
+                    stream << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                           << static_cast<unsigned>(c) << std::dec;
+                } else stream << c;
+            }
+
+            stream << '"';
+        }
+
+        void write_csv_string(std::ostream& stream, const std::string& string) {
+            stream << '"';
+            for (char c : string) {
+                if (c == '"') stream << "\"\"";
+                else stream << c;
+            }
+
+            stream << '"';
+        }
+
+        void write_hash(std::ostream& stream, std::uint64_t hash) {
+            stream << std::hex << std::setw(16) << std::setfill('0') << hash << std::dec;
+        }
+    }
+
+    constexpr std::size_t Batch::DEFAULT_CYCLES_PER_FRAME;
+    Batch::Batch(std::size_t workers, std::size_t frame_cycles)
+        : scheduler {workers}, cycles_per_frame {frame_cycles} {
+        if (cycles_per_frame == 0) throw std::invalid_argument {"Need at least one cycle per frame."};
+    }
+
+    std::vector<Job> Batch::parse_manifest(std::istream& stream) {
+        std::vector<Job> jobs;
+        std::string line;
+        std::size_t line_number {0};
+        while (std::getline(stream, line)) {
+            ++line_number;
+            // Comments start at a '#' leading a field, one inside of a field is an archive reference.
+            std::size_t comment {line.find('#')};
+            while (comment != std::string::npos && comment > 0 && line[comment - 1] != ' ' && line[comment - 1] != '\t')
+                comment = line.find('#', comment + 1);
+            if (comment != std::string::npos) line.erase(comment);
+            if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+            Job job;
+            job.seed = 0; // Same seed as everybody else, unless specified.
+            std::istringstream fields {line};
+            if (!(fields >> job.rom >> job.movie >> job.cycles))
+                throw std::runtime_error {"Couldn't parse manifest, bad job on line " + std::to_string(line_number) + '.'};
+            if (!(fields >> job.seed) && !fields.eof())
+                throw std::runtime_error {"Couldn't parse manifest, bad seed on line " + std::to_string(line_number) + '.'};
+            jobs.push_back(job);
+        }
+
+        return jobs;
+    }
+
+    std::vector<Result> Batch::run(const std::vector<Job>& jobs) {
+        std::vector<Result> results(jobs.size());
+        scheduler.run(jobs.size(), [&](std::size_t job, std::size_t) {
+            results[job] = run_job(jobs[job]); // Each slot is only touched by one worker.
+        });
+
+        return results;
+    }
+
+    Result Batch::run_job(const Job& job) {
+        try {
+            Span rom {loader.load(job.rom)}; // Packs are only mapped once, by whoever gets there first.
+            Movie movie {read_movie(job.movie)};
+            return execute(rom.data, rom.size, movie, job.cycles, job.seed);
+        } catch (const std::exception& error) {
+            Result result; // Execution never throws, so these are errors about the job itself.
+            result.message = error.what();
+            return result;
+        }
+    }
+
+    Result Batch::execute(const byte* program, std::size_t program_size, const Movie& movie,
+                          std::size_t budget, unsigned seed) const {
+        Result result;
+        auto begin = std::chrono::steady_clock::now();
+        Memory memory {image(program, program_size)};
+        Processor processor {memory, seed};
+        processor.profile(quirk_database.lookup(program, program_size));
+        std::unique_ptr<HardwareCounters> counters {measuring ? new HardwareCounters : nullptr}; // Opened by each worker for itself.
+        if (counters) counters->start();
+
+        // Same as the window frontend, keys are sampled and timers tick once per frame.
+        for (std::size_t frame {0}; result.cycles < budget && processor.running(); ++frame) {
+            processor.key_mask(movie.keys(frame));
+            std::size_t slice {std::min(cycles_per_frame, budget - result.cycles)};
+            result.cycles += processor.run(slice);
+            processor.tick_timers();
+        }
+
+        if (counters) {
+            counters->stop();
+            counters->operations(result.cycles);
+            std::lock_guard<std::mutex> guard {hardware_lock};
+            hardware_total.add(counters->read());
+        }
+
+        if (processor.trapped()) {
+            const Processor::Trap& trap {processor.trap()};
+            std::ostringstream message;
+            message << Processor::trap_name(trap.kind) << " at 0x" << std::hex << std::setfill('0')
+                    << std::setw(3) << trap.PC << ", opcode 0x" << std::setw(4) << trap.opcode << '.';
+            result.status = Result::Status::FAULT;
+            result.message = message.str();
+        } else if (processor.running()) result.status = Result::Status::BUDGET;
+        else result.status = Result::Status::EXIT;
+
+        auto end = std::chrono::steady_clock::now();
+        result.wall_time = std::chrono::duration<double> {end - begin}.count();
+        result.state_hash = state_hash(memory, processor);
+        result.display_hash = display_hash(processor);
+        return result;
+    }
+
+    HardwareCounters::Reading Batch::hardware() const {
+        std::lock_guard<std::mutex> guard {hardware_lock};
+        return hardware_total;
+    }
+
+    Memory::Image Batch::image(const byte* program, std::size_t program_size) const {
+        std::uint64_t hash {Hash::xxh64(program, program_size)};
+        std::lock_guard<std::mutex> guard {images_lock};
+        Memory::Image existing {images[hash].lock()};
+        if (existing && program_size <= Memory::PROGRAM_SIZE && std::memcmp(existing->data() + 0x200, program, program_size) == 0 &&
+            std::all_of(existing->begin() + 0x200 + program_size, existing->end(), [](byte b) { return b == 0; }))
+            return existing; // Only freed once the last job running it is done.
+
+        // ROMs nobody runs anymore are dropped here, so long job lists don't keep one entry each.
+        for (auto entry = images.begin(); entry != images.end();) {
+            if (entry->second.expired()) entry = images.erase(entry);
+            else ++entry;
+        }
+
+        Memory::Image created {Memory::image(program, program_size)};
+        images[hash] = created;
+        return created;
+    }
+
+    std::uint64_t Batch::state_hash(const Memory& memory, const Processor& processor) {
+        std::uint64_t hash {Hash::FNV_BASIS};
+        for (int r {static_cast<int>(Processor::Register::V0)}; r <= static_cast<int>(Processor::Register::SP); ++r) {
+            word state {processor.register_state(static_cast<Processor::Register>(r))};
+            byte bytes[2] = {static_cast<byte>(state >> 8), static_cast<byte>(state)};
+            hash = Hash::fnv1a(bytes, sizeof(bytes), hash);
+        }
+
+        for (addr address {0x200}; memory.valid(address); ++address) {
+            byte data {memory.read(address)};
+            hash = Hash::fnv1a(&data, 1, hash);
+        }
+
+        return hash;
+    }
+
+    std::uint64_t Batch::display_hash(const Processor& processor) {
+        if (processor.high_resolution()) // Packed words, in host order, fine since hashes are only compared on one host.
+            return Hash::fnv1a(reinterpret_cast<const byte*>(processor.high_display()),
+                               Processor::PLANES * Processor::HIGH_WIDTH * Processor::HIGH_HEIGHT / 8);
+        return Hash::fnv1a(processor.display_buffer(), Processor::SCREEN_WIDTH * Processor::SCREEN_HEIGHT);
+    }
+
+    const char* Batch::status_name(Result::Status status) {
+        switch (status) {
+        case Result::Status::EXIT: return "exit";
+        case Result::Status::BUDGET: return "budget";
+        case Result::Status::FAULT: return "fault";
+        case Result::Status::ERROR: return "error";
+        }
+
+        return "unknown";
+    }
+
+    void Batch::write_csv(std::ostream& stream, const std::vector<Job>& jobs, const std::vector<Result>& results) {
+        stream << "rom,movie,seed,status,cycles,state_hash,display_hash,wall_time,message" << std::endl;
+        for (std::size_t i {0}; i < jobs.size(); ++i) {
+            write_csv_string(stream, jobs[i].rom);
+            stream << ',';
+            write_csv_string(stream, jobs[i].movie);
+            stream << ',' << jobs[i].seed << ',' << status_name(results[i].status) << ','
+                   << results[i].cycles << ',';
+            write_hash(stream, results[i].state_hash);
+            stream << ',';
+            write_hash(stream, results[i].display_hash);
+            stream << ',' << std::fixed << std::setprecision(6) << results[i].wall_time << ',';
+            write_csv_string(stream, results[i].message);
+            stream << std::endl;
+        }
+    }
+
+    void Batch::write_json(std::ostream& stream, const std::vector<Job>& jobs, const std::vector<Result>& results) {
+        stream << '[' << std::endl;
+        for (std::size_t i {0}; i < jobs.size(); ++i) {
+            stream << "  {\"rom\": ";
+            write_json_string(stream, jobs[i].rom);
+            stream << ", \"movie\": ";
+            write_json_string(stream, jobs[i].movie);
+            stream << ", \"seed\": " << jobs[i].seed
+                   << ", \"status\": \"" << status_name(results[i].status) << '"'
+                   << ", \"cycles\": " << results[i].cycles
+                   << ", \"state_hash\": \"";
+            write_hash(stream, results[i].state_hash);
+            stream << "\", \"display_hash\": \"";
+            write_hash(stream, results[i].display_hash);
+            stream << "\", \"wall_time\": " << std::fixed << std::setprecision(6) << results[i].wall_time;
+            if (!results[i].message.empty()) {
+                stream << ", \"message\": ";
+                write_json_string(stream, results[i].message);
+            }
+
+            stream << '}' << (i + 1 < jobs.size() ? "," : "") << std::endl;
+        }
+
+        stream << ']' << std::endl;
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef CH8_BATCH_HPP
+#define CH8_BATCH_HPP
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include "definitions.hpp"
+#include "processor.hpp"
+#include "scheduler.hpp"
+#include "loader.hpp"
+#include "memory.hpp"
+#include "movie.hpp"
+#include "quirks.hpp"
+#include "hardware.hpp"
+
+namespace ch8 {
+    // A manifest has one job per line: "<rom path> <movie path> <cycle budget> [seed]",
+    // where the movie can be '-' if the ROM should run without any input at all. ROMs
+    // inside of a pack file can be referred to as "<pack path>@<offset>:<size>", and ROMs
+    // in an archive as "<archive path>#<name>" or "<archive path>#xxh64:<hash>".
+    struct Job {
+        std::string rom;
+        std::string movie;
+        std::size_t cycles;
+        unsigned seed;
+    };
+
+    struct Result {
+        enum class Status {
+            EXIT, // Program ran EXIT (00FD) before the budget ran out.
+            BUDGET, // Every cycle in the budget was spent.
+            FAULT, // Processor threw, e.g. invalid instruction.
+            ERROR // Job couldn't even start, bad ROM or movie.
+        };
+
+        Status status {Status::ERROR};
+        std::size_t cycles {0};
+        std::uint64_t state_hash {0};
+        std::uint64_t display_hash {0};
+        double wall_time {0.0}; // In seconds, not counting any file I/O.
+        std::string message; // What went wrong for faults and errors.
+    };
+
+    // Runs many ROMs headless, without any window, across all cores. Each job gets its own
+    // Memory and Processor on the worker's stack, only the unwritten pages of a ROM are shared.
+    class Batch {
+    public:
+        Batch(std::size_t, std::size_t); // Workers (zero for one per core) and cycles per 60 Hz frame.
+        static std::vector<Job> parse_manifest(std::istream&); // Throws std::runtime_error if malformed.
+        std::vector<Result> run(const std::vector<Job>&); // Results are in the same order as the jobs.
+        Result run_job(const Job&); // Loads the ROM and movie of the job, then executes it.
+        Result execute(const byte*, std::size_t, const Movie&, std::size_t, unsigned) const;
+        std::size_t workers() const { return scheduler.workers(); }
+        void quirks(const QuirkDatabase& database) { quirk_database = database; } // Profiles for ROMs that need one.
+        void measure(bool enabled) { measuring = enabled; } // Host CPU counters around every job's execution.
+        HardwareCounters::Reading hardware() const; // Summed over every job measured, per emulated instruction.
+
+        static void write_csv(std::ostream&, const std::vector<Job>&, const std::vector<Result>&);
+        static void write_json(std::ostream&, const std::vector<Job>&, const std::vector<Result>&);
+        static const char* status_name(Result::Status);
+
+        static std::uint64_t state_hash(const Memory&, const Processor&); // Registers and program memory.
+        static std::uint64_t display_hash(const Processor&); // Only the display buffer.
+
+        static constexpr std::size_t DEFAULT_CYCLES_PER_FRAME {10}; // Roughly 600 instructions per second.
+
+    private:
+        Scheduler scheduler;
+        Loader loader; // Shared by all workers, ROM files are mapped and never copied.
+        std::size_t cycles_per_frame;
+        QuirkDatabase quirk_database; // Empty unless given, so everything runs with the legacy profile.
+        bool measuring {false};
+        mutable std::mutex hardware_lock;
+        mutable HardwareCounters::Reading hardware_total;
+
+        Memory::Image image(const byte*, std::size_t) const; // Same image for jobs running the same ROM.
+        mutable std::mutex images_lock;
+        mutable std::map<std::uint64_t, std::weak_ptr<const std::array<byte, Memory::SIZE>>> images; // By xxh64.
+    };
+}
+
+#endif
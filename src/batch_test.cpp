@@ -0,0 +1,68 @@
+#include "catch.hpp"
+#include "batch.hpp"
+#include <sstream>
+
+TEST_CASE("Parsing batch manifests.", "[batch, manifest]") {
+    std::istringstream stream {"# rom movie cycles seed\nroms/a.ch8 - 1000\n\nroms/b.ch8 b.movie 50 7\n"};
+    std::vector<ch8::Job> jobs {ch8::Batch::parse_manifest(stream)};
+    REQUIRE(jobs.size() == 2);
+    REQUIRE(jobs[0].rom == "roms/a.ch8");
+    REQUIRE(jobs[0].movie == "-");
+    REQUIRE(jobs[0].cycles == 1000);
+    REQUIRE(jobs[0].seed == 0); // Default seed when not given.
+    REQUIRE(jobs[1].movie == "b.movie");
+    REQUIRE(jobs[1].seed == 7);
+
+    std::istringstream archived {"roms.c8p#PONG - 10 # Trailing comment.\n"};
+    REQUIRE(ch8::Batch::parse_manifest(archived)[0].rom == "roms.c8p#PONG");
+
+    std::istringstream missing_cycles {"roms/a.ch8 -\n"};
+    REQUIRE_THROWS(ch8::Batch::parse_manifest(missing_cycles));
+}
+
+TEST_CASE("Executing jobs headless.", "[batch, execute]") {
+    ch8::Batch batch {1, 4};
+    const ch8::byte loop[] = {0x70, 0x01, 0x12, 0x00}; // ADD V0, 1; JP 0x200.
+    ch8::Result budget {batch.execute(loop, sizeof(loop), ch8::Movie {}, 100, 0)};
+    REQUIRE(budget.status == ch8::Result::Status::BUDGET);
+    REQUIRE(budget.cycles == 100); // Never more than the budget.
+
+    const ch8::byte exits[] = {0x60, 0x05, 0x00, 0xFD}; // LD V0, 5; EXIT.
+    ch8::Result exited {batch.execute(exits, sizeof(exits), ch8::Movie {}, 100, 0)};
+    REQUIRE(exited.status == ch8::Result::Status::EXIT);
+    REQUIRE(exited.cycles == 2);
+
+    const ch8::byte invalid[] = {0xFF, 0xFF}; // Not an instruction.
+    ch8::Result faulted {batch.execute(invalid, sizeof(invalid), ch8::Movie {}, 100, 0)};
+    REQUIRE(faulted.status == ch8::Result::Status::FAULT);
+    REQUIRE(!faulted.message.empty());
+
+    ch8::Result missing {batch.run_job(ch8::Job {"does/not/exist.ch8", "-", 10, 0})};
+    REQUIRE(missing.status == ch8::Result::Status::ERROR);
+
+    std::ostringstream csv;
+    ch8::Batch::write_csv(csv, {ch8::Job {"does/not/exist.ch8", "-", 10, 0}}, {missing});
+    REQUIRE(csv.str().find(",message\n") != std::string::npos);
+    REQUIRE(csv.str().find(",\"" + missing.message + "\"\n") != std::string::npos); // Why it failed, quoted.
+}
+
+TEST_CASE("Batch results are reproducible.", "[batch, hashes]") {
+    // LD V2, 1; RND V0, 0xFF; LD F, V0; DRW V1, V1, 5; SKP V2; JP 0x202; EXIT.
+    const ch8::byte program[] = {0x62, 0x01, 0xC0, 0xFF, 0xF0, 0x29, 0xD1, 0x15,
+                                 0xE2, 0x9E, 0x12, 0x02, 0x00, 0xFD};
+    std::istringstream stream {"3 0002\n"}; // Presses key 1 at frame 3, the one in V2.
+    ch8::Movie movie {ch8::Movie::parse(stream)};
+    ch8::Batch single {1, 4}, many {4, 4};
+
+    ch8::Result first {single.execute(program, sizeof(program), movie, 1000, 42)};
+    ch8::Result second {many.execute(program, sizeof(program), movie, 1000, 42)};
+    REQUIRE(first.status == ch8::Result::Status::EXIT); // Key press ends the loop.
+    REQUIRE(first.cycles == 16); // LD, two loops of five, then the third sees the key and skips to EXIT.
+    REQUIRE(first.state_hash == second.state_hash);
+    REQUIRE(first.display_hash == second.display_hash);
+
+    ch8::Result unpressed {single.execute(program, sizeof(program), ch8::Movie {}, 1000, 42)};
+    ch8::Result reseeded {single.execute(program, sizeof(program), ch8::Movie {}, 1000, 43)};
+    REQUIRE(unpressed.status == ch8::Result::Status::BUDGET);
+    REQUIRE(unpressed.state_hash != reseeded.state_hash); // Different seed, different RND.
+}
@@ -0,0 +1,74 @@
+#include "bench.hpp"
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+namespace ch8 {
+    namespace {
+        double time(const Bench::Body& body, std::size_t iterations) {
+            auto begin = std::chrono::steady_clock::now();
+            body(iterations);
+            auto end = std::chrono::steady_clock::now();
+            return std::chrono::duration<double> {end - begin}.count();
+        }
+    }
+
+    Bench::Bench(std::size_t sample_count, double seconds) : samples {sample_count}, sample_time {seconds} {
+        if (samples == 0 || !(sample_time > 0.0)) throw std::invalid_argument {"Need samples that take some time."};
+    }
+
+    const Bench::Result& Bench::run(const std::string& name, const Body& body) {
+        std::size_t iterations {1};
+        while (time(body, iterations) < sample_time && iterations < (std::size_t {1} << 40)) iterations *= 2;
+
+        std::vector<double> seconds(samples);
+        for (double& sample : seconds) sample = time(body, iterations);
+        measured.push_back(summarise(name, iterations, std::move(seconds)));
+        return measured.back();
+    }
+
+    Bench::Result Bench::summarise(const std::string& name, std::size_t iterations, std::vector<double> seconds) {
+        Result result;
+        result.name = name;
+        result.iterations = iterations;
+        result.samples = seconds.size();
+        if (seconds.empty() || iterations == 0) return result;
+
+        for (double& sample : seconds) sample = sample * 1e9 / iterations;
+        std::sort(seconds.begin(), seconds.end());
+        std::size_t middle {seconds.size() / 2};
+        result.median = seconds.size() % 2 == 1 ? seconds[middle] : (seconds[middle - 1] + seconds[middle]) / 2;
+        result.mean = std::accumulate(seconds.begin(), seconds.end(), 0.0) / seconds.size();
+        double squares {0.0};
+        for (double sample : seconds) squares += (sample - result.mean) * (sample - result.mean);
+        result.deviation = seconds.size() > 1 ? std::sqrt(squares / (seconds.size() - 1)) : 0.0;
+        result.minimum = seconds.front();
+        return result;
+    }
+
+    void Bench::write_csv(std::ostream& stream, const std::vector<Result>& results) {
+        stream << "name,iterations,samples,median_ns,mean_ns,deviation_ns,minimum_ns\n" << std::fixed << std::setprecision(3);
+        for (const Result& result : results) {
+            stream << result.name << ',' << result.iterations << ',' << result.samples << ',' << result.median << ','
+                   << result.mean << ',' << result.deviation << ',' << result.minimum << '\n';
+        }
+
+        stream.unsetf(std::ios::floatfield);
+    }
+
+    void Bench::write_json(std::ostream& stream, const std::vector<Result>& results) {
+        stream << "[\n" << std::fixed << std::setprecision(3);
+        for (std::size_t i {0}; i < results.size(); ++i) {
+            const Result& result {results[i]};
+            stream << "  {\"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+                   << ", \"samples\": " << result.samples << ", \"median_ns\": " << result.median
+                   << ", \"mean_ns\": " << result.mean << ", \"deviation_ns\": " << result.deviation
+                   << ", \"minimum_ns\": " << result.minimum << '}' << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+
+        stream << "]\n";
+        stream.unsetf(std::ios::floatfield);
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef CH8_BENCH_HPP
+#define CH8_BENCH_HPP
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <functional>
+#include <stdexcept>
+#include "definitions.hpp"
+
+namespace ch8 {
+    // Times small pieces of code. The iterations per sample are first doubled until a
+    // sample takes long enough for the clock not to matter, which doubles as warmup,
+    // then the samples are timed and summarised in nanoseconds per iteration.
+    class Bench {
+    public:
+        struct Result {
+            std::string name;
+            std::size_t iterations {0}; // Per sample.
+            std::size_t samples {0};
+            double median {0.0}, mean {0.0}, deviation {0.0}, minimum {0.0}; // Nanoseconds per iteration.
+        };
+
+        using Body = std::function<void(std::size_t)>; // Runs the code being measured n times.
+        Bench(std::size_t, double); // Samples per benchmark and seconds per sample. Throws if either is zero.
+        const Result& run(const std::string&, const Body&); // Runs and records a benchmark.
+        const std::vector<Result>& results() const { return measured; }
+        static Result summarise(const std::string&, std::size_t, std::vector<double>); // From seconds per sample.
+
+        static void write_csv(std::ostream&, const std::vector<Result>&);
+        static void write_json(std::ostream&, const std::vector<Result>&);
+
+        // Makes the compiler believe a value is used, so the code computing it isn't thrown away.
+        template<typename T>
+        static void keep(const T& value) {
+#if defined(__GNUC__)
+            asm volatile("" : : "r,m"(value) : "memory");
+#else
+            static volatile char sink;
+            sink = *reinterpret_cast<const volatile char*>(&value);
+#endif
+        }
+
+    private:
+        std::size_t samples;
+        double sample_time;
+        std::vector<Result> measured;
+    };
+}
+
+#endif
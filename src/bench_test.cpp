@@ -0,0 +1,33 @@
+#include <sstream>
+#include <string>
+#include <vector>
+#include "catch.hpp"
+#include "bench.hpp"
+
+TEST_CASE("Benchmark samples are summarised per iteration.", "[bench]") {
+    ch8::Bench::Result result {ch8::Bench::summarise("example", 1000, {4e-6, 1e-6, 2e-6, 3e-6})};
+    REQUIRE(result.samples == 4);
+    REQUIRE(result.minimum == Approx(1.0));
+    REQUIRE(result.median == Approx(2.5));
+    REQUIRE(result.mean == Approx(2.5));
+    REQUIRE(result.deviation == Approx(1.2910).epsilon(0.001));
+
+    ch8::Bench bench {3, 1e-4};
+    std::size_t calls {0};
+    const ch8::Bench::Result& measured {bench.run("loop", [&calls](std::size_t n) {
+        for (std::size_t i {0}; i < n; ++i) ch8::Bench::keep(++calls);
+    })};
+
+    REQUIRE(measured.samples == 3);
+    REQUIRE(measured.iterations > 1);
+    REQUIRE(measured.minimum > 0.0);
+    REQUIRE(bench.results().size() == 1);
+
+    std::ostringstream csv, json;
+    ch8::Bench::write_csv(csv, bench.results());
+    ch8::Bench::write_json(json, bench.results());
+    REQUIRE(csv.str().find("name,iterations,samples,median_ns") == 0);
+    REQUIRE(csv.str().find("\nloop,") != std::string::npos);
+    REQUIRE(json.str().find("{\"name\": \"loop\"") != std::string::npos);
+    REQUIRE_THROWS_AS(ch8::Bench(0, 1.0), const std::invalid_argument&);
+}
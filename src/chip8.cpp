@@ -0,0 +1,164 @@
+#include "chip8.h"
+#include <new>
+#include <memory>
+#include <cstring>
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+
+#include "memory.hpp"
+#include "processor.hpp"
+#include "definitions.hpp"
+
+struct chip8 {
+    explicit chip8(unsigned random_seed) : seed {random_seed} {}
+    ch8::Memory initial {nullptr, 0}; // Freshly loaded ROM, used when resetting.
+    ch8::Memory memory {nullptr, 0};
+    ch8::Processor processor {memory, 0};
+    char error[256] {}; // Fixed size, so reporting an error can't itself throw.
+    unsigned seed;
+};
+
+namespace {
+    chip8_status fail(chip8* machine, chip8_status status, const char* message) {
+        std::strncpy(machine->error, message, sizeof(machine->error) - 1);
+        return status;
+    }
+
+    // Runs an entry point's body, turning whatever it throws into a status, since nothing may
+    // unwind into C. Memory allocates its pages, and copies them on the first write after a reset.
+    template<typename Body>
+    chip8_status guarded(chip8* machine, Body body) {
+        try { return body(); }
+        catch (const std::bad_alloc&) { return fail(machine, CHIP8_OUT_OF_MEMORY, "Out of memory."); }
+        catch (const std::invalid_argument& error) { return fail(machine, CHIP8_INVALID_ARGUMENT, error.what()); }
+        catch (const std::exception& error) {
+            machine->processor.halt(); // Can't tell how far it got.
+            return fail(machine, CHIP8_FAULT, error.what());
+        }
+    }
+}
+
+static_assert(CHIP8_SCREEN_WIDTH == ch8::Processor::SCREEN_WIDTH, "C API has a different screen width.");
+static_assert(CHIP8_SCREEN_HEIGHT == ch8::Processor::SCREEN_HEIGHT, "C API has a different screen height.");
+
+extern "C" {
+    chip8* chip8_create(unsigned seed) {
+        try {
+            std::unique_ptr<chip8> machine {new chip8 {seed}}; // Its memory allocates too, not just the new.
+            machine->processor.reset(seed);
+            return machine.release();
+        } catch (const std::exception&) {
+            return nullptr;
+        }
+    }
+
+    void chip8_destroy(chip8* machine) {
+        delete machine;
+    }
+
+    chip8_status chip8_load(chip8* machine, const unsigned char* rom, size_t size) {
+        if (machine == nullptr || (rom == nullptr && size != 0)) return CHIP8_INVALID_ARGUMENT;
+        if (size > ch8::Memory::PROGRAM_SIZE) return fail(machine, CHIP8_ROM_TOO_LARGE, "ROM doesn't fit in program memory.");
+        chip8_status status {guarded(machine, [machine, rom, size]() {
+            machine->initial = ch8::Memory {rom, size};
+            return CHIP8_OK;
+        })};
+
+        return status == CHIP8_OK ? chip8_reset(machine, machine->seed) : status;
+    }
+
+    chip8_status chip8_reset(chip8* machine, unsigned seed) {
+        if (machine == nullptr) return CHIP8_INVALID_ARGUMENT;
+        return guarded(machine, [machine, seed]() {
+            machine->seed = seed;
+            machine->memory = machine->initial;
+            machine->processor.reset(seed);
+            machine->error[0] = '\0';
+            return CHIP8_OK;
+        });
+    }
+
+    chip8_status chip8_run(chip8* machine, size_t cycles, size_t* executed) {
+        if (machine == nullptr) return CHIP8_INVALID_ARGUMENT;
+        bool trapped_before {machine->processor.trapped()};
+        size_t taken {0};
+        // Faults trap, but predecoding and copying pages on write both allocate.
+        chip8_status status {guarded(machine, [machine, cycles, &taken]() {
+            taken = machine->processor.run(cycles);
+            return CHIP8_OK;
+        })};
+
+        if (executed != nullptr) *executed = taken;
+        if (status != CHIP8_OK) {
+            machine->processor.halt();
+            return status;
+        }
+
+        if (!machine->processor.trapped() || trapped_before) return CHIP8_OK;
+
+        const ch8::Processor::Trap& trap {machine->processor.trap()};
+        std::snprintf(machine->error, sizeof(machine->error), "%s at 0x%03X, opcode 0x%04X.",
+                      ch8::Processor::trap_name(trap.kind), trap.PC, trap.opcode);
+        return CHIP8_FAULT;
+    }
+
+    int chip8_running(const chip8* machine) {
+        return machine != nullptr && machine->processor.running();
+    }
+
+    void chip8_tick_timers(chip8* machine) {
+        if (machine != nullptr) machine->processor.tick_timers();
+    }
+
+    const unsigned char* chip8_framebuffer(const chip8* machine) {
+        if (machine == nullptr) return nullptr;
+        return machine->processor.display_buffer();
+    }
+
+    int chip8_framebuffer_updated(chip8* machine) {
+        if (machine == nullptr || !machine->processor.display_updated()) return 0;
+        machine->processor.updated_display();
+        return 1;
+    }
+
+    chip8_status chip8_set_key(chip8* machine, unsigned key, int pressed) {
+        if (machine == nullptr || key > 0x0F) return CHIP8_INVALID_ARGUMENT;
+        if (pressed) machine->processor.key_pressed(static_cast<ch8::byte>(key));
+        else machine->processor.key_released(static_cast<ch8::byte>(key));
+        return CHIP8_OK;
+    }
+
+    void chip8_set_keys(chip8* machine, unsigned short mask) {
+        if (machine != nullptr) machine->processor.key_mask(mask);
+    }
+
+    size_t chip8_snapshot_size(void) {
+        return sizeof(ch8::Processor::Snapshot);
+    }
+
+    chip8_status chip8_snapshot(const chip8* machine, void* buffer, size_t size) {
+        if (machine == nullptr || buffer == nullptr || size < sizeof(ch8::Processor::Snapshot))
+            return CHIP8_INVALID_ARGUMENT;
+        ch8::Processor::Snapshot snapshot;
+        machine->processor.save(snapshot);
+        std::memcpy(buffer, &snapshot, sizeof(snapshot)); // Buffer might not be aligned for it.
+        return CHIP8_OK;
+    }
+
+    chip8_status chip8_restore(chip8* machine, const void* buffer, size_t size) {
+        if (machine == nullptr || buffer == nullptr || size < sizeof(ch8::Processor::Snapshot))
+            return CHIP8_INVALID_ARGUMENT;
+        ch8::Processor::Snapshot snapshot;
+        std::memcpy(&snapshot, buffer, sizeof(snapshot));
+        return guarded(machine, [machine, &snapshot]() {
+            machine->processor.restore(snapshot);
+            return CHIP8_OK;
+        });
+    }
+
+    const char* chip8_last_error(const chip8* machine) {
+        if (machine == nullptr) return "No machine given.";
+        return machine->error;
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef CHIP8_H
+#define CHIP8_H
+
+/* Flat C interface to the interpreter core, built as libchip8.so. Nothing in here
+ * ever throws, failures are reported through the return codes, and the message of
+ * the last failure on a machine can be fetched with chip8_last_error. Machines are
+ * independent, but a single machine must not be used from several threads at once. */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct chip8 chip8;
+
+typedef enum chip8_status {
+    CHIP8_OK = 0,
+    CHIP8_INVALID_ARGUMENT, /* Null pointers, wrong buffer sizes, bad key numbers... */
+    CHIP8_ROM_TOO_LARGE, /* ROM doesn't fit between 0x200 and 0xFFF. */
+    CHIP8_FAULT, /* Invalid instruction or memory access, machine has stopped. */
+    CHIP8_OUT_OF_MEMORY /* Couldn't allocate, a machine that was running has stopped. */
+} chip8_status;
+
+#define CHIP8_SCREEN_WIDTH 64
+#define CHIP8_SCREEN_HEIGHT 32
+
+chip8* chip8_create(unsigned seed); /* Empty machine, NULL if it couldn't be allocated. */
+void chip8_destroy(chip8* machine); /* Accepts NULL. */
+chip8_status chip8_load(chip8* machine, const unsigned char* rom, size_t size); /* Also resets. */
+chip8_status chip8_reset(chip8* machine, unsigned seed); /* Back to the state right after loading. */
+chip8_status chip8_run(chip8* machine, size_t cycles, size_t* executed); /* Executed may be NULL, and is 0 if it ran out of memory. */
+int chip8_running(const chip8* machine); /* Zero once the ROM has exited or faulted. */
+void chip8_tick_timers(chip8* machine); /* Call at 60 Hz of emulated time. */
+
+/* CHIP8_SCREEN_WIDTH * CHIP8_SCREEN_HEIGHT bytes, one per pixel, rows first. Bit p is lit on plane p,
+ * so pixels are 0 or 1, and 0 to 3 in builds with XO_CHIP=YES where XO-CHIP draws on two planes.
+ * The pointer stays valid and is updated in place until the machine is destroyed. */
+const unsigned char* chip8_framebuffer(const chip8* machine);
+int chip8_framebuffer_updated(chip8* machine); /* Non-zero once after each change to the display. */
+
+chip8_status chip8_set_key(chip8* machine, unsigned key, int pressed);
+void chip8_set_keys(chip8* machine, unsigned short mask); /* Bit k is the state of key k. */
+
+size_t chip8_snapshot_size(void);
+chip8_status chip8_snapshot(const chip8* machine, void* buffer, size_t size);
+chip8_status chip8_restore(chip8* machine, const void* buffer, size_t size);
+
+const char* chip8_last_error(const chip8* machine); /* Empty string if nothing has failed. */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,65 @@
+#include "catch.hpp"
+#include "chip8.h"
+#include <vector>
+
+TEST_CASE("C API loads and runs ROMs.", "[chip8, run]") {
+    const unsigned char program[] = {0x60, 0x08, 0xF0, 0x29, 0xD1, 0x15, 0x00, 0xFD}; // LD V0, 8; LD F, V0; DRW V1, V1, 5; EXIT.
+    chip8* machine {chip8_create(0)};
+    REQUIRE(machine != nullptr);
+    REQUIRE(chip8_load(machine, program, sizeof(program)) == CHIP8_OK);
+    REQUIRE(chip8_running(machine));
+
+    size_t executed {0};
+    REQUIRE(chip8_run(machine, 100, &executed) == CHIP8_OK);
+    REQUIRE(executed == 4); // Stops at EXIT.
+    REQUIRE(!chip8_running(machine));
+    REQUIRE(chip8_framebuffer_updated(machine));
+    REQUIRE(!chip8_framebuffer_updated(machine)); // Only reported once.
+    REQUIRE(chip8_framebuffer(machine)[0] == 1); // Top left of the 8 glyph.
+    REQUIRE(chip8_framebuffer(machine)[CHIP8_SCREEN_WIDTH + 1] == 0); // Hole in the 8 glyph.
+    chip8_destroy(machine);
+}
+
+TEST_CASE("C API reports errors instead of throwing.", "[chip8, errors]") {
+    chip8* machine {chip8_create(0)};
+    std::vector<unsigned char> huge(0x10000); // Too big for any build, even with XO-CHIP's memory.
+    REQUIRE(chip8_load(machine, huge.data(), huge.size()) == CHIP8_ROM_TOO_LARGE);
+    REQUIRE(chip8_last_error(machine)[0] != '\0');
+    REQUIRE(chip8_set_key(machine, 0x10, 1) == CHIP8_INVALID_ARGUMENT);
+    REQUIRE(chip8_load(nullptr, nullptr, 0) == CHIP8_INVALID_ARGUMENT);
+
+    const unsigned char invalid[] = {0xFF, 0xFF};
+    size_t executed {42};
+    REQUIRE(chip8_load(machine, invalid, sizeof(invalid)) == CHIP8_OK);
+    REQUIRE(chip8_last_error(machine)[0] == '\0'); // Cleared on load.
+    REQUIRE(chip8_run(machine, 10, &executed) == CHIP8_FAULT);
+    REQUIRE(executed == 0);
+    REQUIRE(!chip8_running(machine)); // Faults stop the machine.
+    chip8_destroy(machine);
+    chip8_destroy(nullptr);
+}
+
+TEST_CASE("C API snapshots and restores machines.", "[chip8, snapshot]") {
+    const unsigned char program[] = {0xC0, 0xFF, 0xA3, 0x00, 0xF0, 0x33, 0x71, 0x01, 0x12, 0x00}; // RND V0; LD I, 0x300; LD B, V0; ADD V1, 1; JP 0x200.
+    chip8* machine {chip8_create(5)};
+    REQUIRE(chip8_load(machine, program, sizeof(program)) == CHIP8_OK);
+    REQUIRE(chip8_run(machine, 7, nullptr) == CHIP8_OK);
+
+    std::vector<unsigned char> snapshot(chip8_snapshot_size());
+    REQUIRE(chip8_snapshot(machine, snapshot.data(), 10) == CHIP8_INVALID_ARGUMENT); // Too small.
+    REQUIRE(chip8_snapshot(machine, snapshot.data(), snapshot.size()) == CHIP8_OK);
+    REQUIRE(chip8_run(machine, 50, nullptr) == CHIP8_OK);
+    std::vector<unsigned char> expected(chip8_snapshot_size());
+    REQUIRE(chip8_snapshot(machine, expected.data(), expected.size()) == CHIP8_OK);
+
+    // Restoring and running the same amount must end up in the exact same state, RNG included.
+    REQUIRE(chip8_restore(machine, snapshot.data(), snapshot.size()) == CHIP8_OK);
+    REQUIRE(chip8_run(machine, 50, nullptr) == CHIP8_OK);
+    std::vector<unsigned char> actual(chip8_snapshot_size());
+    REQUIRE(chip8_snapshot(machine, actual.data(), actual.size()) == CHIP8_OK);
+    REQUIRE(actual == expected);
+
+    std::vector<unsigned char> garbage(chip8_snapshot_size(), 0xAB);
+    REQUIRE(chip8_restore(machine, garbage.data(), garbage.size()) == CHIP8_INVALID_ARGUMENT);
+    chip8_destroy(machine);
+}
@@ -0,0 +1,92 @@
+#include "counters.hpp"
+#include <mutex>
+#include <vector>
+#include <iomanip>
+#include <utility>
+#include <algorithm>
+
+namespace ch8 {
+    namespace {
+        std::mutex registry_lock;
+        std::vector<const Counters*> live; // Threads still running.
+        Counters retired; // Threads that are gone.
+
+        // Keeps a thread's counters visible to sum() for as long as the thread lives.
+        struct Registration {
+            Counters counters;
+            Registration() {
+                std::lock_guard<std::mutex> guard {registry_lock};
+                live.push_back(&counters);
+            }
+
+            ~Registration() {
+                std::lock_guard<std::mutex> guard {registry_lock};
+                retired.add(counters);
+                live.erase(std::find(live.begin(), live.end(), &counters));
+            }
+        };
+
+        double share(std::uint64_t part, std::uint64_t whole) {
+            return whole == 0 ? 0.0 : 100.0 * part / whole;
+        }
+    }
+
+    constexpr std::size_t Counters::INSTRUCTIONS;
+    void Counters::add(const Counters& other) {
+        for (std::size_t i {0}; i < INSTRUCTIONS; ++i) instructions[i] += other.instructions[i];
+        for (std::size_t i {0}; i < 16; ++i) classes[i] += other.classes[i];
+        skips_taken += other.skips_taken;
+        skips_not_taken += other.skips_not_taken;
+        draws += other.draws;
+        collisions += other.collisions;
+    }
+
+    std::uint64_t Counters::total() const {
+        std::uint64_t count {0};
+        for (std::uint64_t executions : instructions) count += executions;
+        return count;
+    }
+
+    void Counters::report(std::ostream& stream) const {
+        std::uint64_t executed {total()};
+        std::vector<std::pair<std::uint64_t, std::size_t>> sorted;
+        for (std::size_t i {0}; i < INSTRUCTIONS; ++i) if (instructions[i] != 0) sorted.emplace_back(instructions[i], i);
+        std::stable_sort(sorted.begin(), sorted.end(), [](const std::pair<std::uint64_t, std::size_t>& a,
+                                                          const std::pair<std::uint64_t, std::size_t>& b) { return a.first > b.first; });
+
+        stream << std::fixed << std::setprecision(1) << "Executed " << executed << " instructions." << std::endl;
+        for (const std::pair<std::uint64_t, std::size_t>& entry : sorted) {
+            stream << "  " << std::left << std::setw(8) << Interpreter::name(static_cast<Instruction>(entry.second))
+                   << std::right << std::setw(14) << entry.first << std::setw(7) << share(entry.first, executed) << '%' << std::endl;
+        }
+
+        sorted.clear();
+        for (std::size_t i {0}; i < 16; ++i) if (classes[i] != 0) sorted.emplace_back(classes[i], i);
+        std::stable_sort(sorted.begin(), sorted.end(), [](const std::pair<std::uint64_t, std::size_t>& a,
+                                                          const std::pair<std::uint64_t, std::size_t>& b) { return a.first > b.first; });
+        stream << "By opcode class:" << std::endl;
+        for (const std::pair<std::uint64_t, std::size_t>& entry : sorted) {
+            stream << "  " << std::hex << std::uppercase << entry.second << "xxx" << std::dec << std::nouppercase
+                   << std::setw(17) << entry.first << std::setw(7) << share(entry.first, executed) << '%' << std::endl;
+        }
+
+        std::uint64_t skips {skips_taken + skips_not_taken};
+        stream << "Skips: " << skips_taken << " taken, " << skips_not_taken << " not taken ("
+               << share(skips_taken, skips) << "% taken)." << std::endl
+               << "Draws: " << draws << ", " << collisions << " collided ("
+               << share(collisions, draws) << "% collided)." << std::endl;
+        stream.unsetf(std::ios::floatfield);
+    }
+
+    Counters& Counters::local() {
+        thread_local Registration registration;
+        return registration.counters;
+    }
+
+    Counters Counters::sum() {
+        std::lock_guard<std::mutex> guard {registry_lock};
+        Counters total {retired};
+        for (const Counters* counters : live) total.add(*counters);
+        return total;
+    }
+}
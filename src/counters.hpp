@@ -0,0 +1,42 @@
+#ifndef CH8_COUNTERS_HPP
+#define CH8_COUNTERS_HPP
+
+#include <cstdint>
+#include <ostream>
+#include "definitions.hpp"
+#include "interpreter.hpp"
+
+// Execution counters are only kept in profiling builds (make PROFILE=YES), in every
+// other build the statement given here isn't even compiled, so it costs nothing.
+#ifdef CH8_PROFILE
+#define CH8_COUNT(statement) do { statement; } while (false)
+#else
+#define CH8_COUNT(statement) do { } while (false)
+#endif
+
+namespace ch8 {
+    // What the processor did, per thread and on its own cache line, so workers never share one.
+    struct alignas(64) Counters {
+        static constexpr std::size_t INSTRUCTIONS {static_cast<std::size_t>(Instruction::INVALID) + 1};
+        std::uint64_t instructions[INSTRUCTIONS] = {0}; // By decoded instruction, invalid ones included.
+        std::uint64_t classes[16] = {0}; // By the upper nibble of the opcode.
+        std::uint64_t skips_taken {0}, skips_not_taken {0};
+        std::uint64_t draws {0}, collisions {0};
+
+        void executed(Instruction instruction, word opcode) {
+            ++instructions[static_cast<std::size_t>(instruction)];
+            ++classes[opcode >> 12];
+        }
+
+        void skipped(bool taken) { ++(taken ? skips_taken : skips_not_taken); }
+        void drew(bool collided) { ++draws; collisions += collided; }
+        void add(const Counters&);
+        std::uint64_t total() const; // Instructions executed.
+        void report(std::ostream&) const; // Instructions and classes by count, most executed first.
+
+        static Counters& local(); // This thread's counters.
+        static Counters sum(); // Every thread's counters, finished ones included. Racy unless they're idle.
+    };
+}
+
+#endif
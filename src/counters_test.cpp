@@ -0,0 +1,54 @@
+#include <sstream>
+#include <string>
+#include "catch.hpp"
+#include "counters.hpp"
+#include "processor.hpp"
+#include "memory.hpp"
+
+TEST_CASE("Counters add up and report by count.", "[counters]") {
+    ch8::Counters counters;
+    counters.executed(ch8::Instruction::DRW_RRC, 0xD015);
+    counters.executed(ch8::Instruction::DRW_RRC, 0xD125);
+    counters.executed(ch8::Instruction::ADD_RC, 0x7001);
+    counters.skipped(true);
+    counters.skipped(false);
+    counters.skipped(false);
+    counters.drew(true);
+    REQUIRE(counters.total() == 3);
+    REQUIRE(counters.classes[0xD] == 2);
+    REQUIRE(counters.skips_not_taken == 2);
+
+    ch8::Counters sum;
+    sum.add(counters);
+    sum.add(counters);
+    REQUIRE(sum.instructions[static_cast<std::size_t>(ch8::Instruction::DRW_RRC)] == 4);
+    REQUIRE(sum.collisions == 2);
+
+    std::ostringstream report;
+    counters.report(report);
+    std::string text {report.str()};
+    REQUIRE(text.find("Executed 3 instructions.") == 0);
+    REQUIRE(text.find("DRW_RRC") < text.find("ADD_RC")); // Most executed first.
+    REQUIRE(text.find("Dxxx") < text.find("7xxx"));
+    REQUIRE(text.find("1 taken, 2 not taken (33.3% taken)") != std::string::npos);
+    REQUIRE(text.find("SYS_A") == std::string::npos); // Nothing that never ran.
+}
+
+#ifdef CH8_PROFILE
+TEST_CASE("Every executed instruction is counted.", "[counters]") {
+    // 200: ADD V0, 1; SE V0, 0x03; JP 0x200; EXIT, run both fused and stepped.
+    const ch8::byte program[] = {0x70, 0x01, 0x30, 0x03, 0x12, 0x00, 0x00, 0xFD};
+    for (bool stepped : {false, true}) {
+        ch8::Counters before {ch8::Counters::local()};
+        ch8::Memory memory {program, sizeof(program)};
+        ch8::Processor processor {memory, 0};
+        if (stepped) while (processor.running()) processor.step();
+        else processor.run(100);
+
+        const ch8::Counters& after {ch8::Counters::local()};
+        REQUIRE(after.total() - before.total() == 9);
+        REQUIRE(after.skips_taken - before.skips_taken == 1);
+        REQUIRE(after.skips_not_taken - before.skips_not_taken == 2);
+    }
+}
+#endif
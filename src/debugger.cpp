@@ -0,0 +1,150 @@
+#include "debugger.hpp"
+#include <cctype>
+#include <cstdlib>
+#include <algorithm>
+
+namespace ch8 {
+    namespace {
+        enum class Access { NONE, READ, WRITE };
+
+        // What an instruction does to memory, always starting at I, and how many bytes of it.
+        Access access(Instruction instruction, word opcode, std::size_t& length) {
+            std::size_t x = (opcode >> 8) & 0x0F, y = (opcode >> 4) & 0x0F, n = opcode & 0x0F;
+            switch (instruction) {
+            case Instruction::DRW_RRC: length = n; return Access::READ; // Per plane at low resolution, see sprite_length().
+            case Instruction::LD_BR: length = 3; return Access::WRITE;
+            case Instruction::LD_IAR: length = x + 1; return Access::WRITE;
+            case Instruction::LD_RAI: length = x + 1; return Access::READ;
+            case Instruction::SAVE_RR: length = (x > y ? x - y : y - x) + 1; return Access::WRITE;
+            case Instruction::LOAD_RR: length = (x > y ? x - y : y - x) + 1; return Access::READ;
+            case Instruction::AUDIO: length = 16; return Access::READ;
+            default: length = 0; return Access::NONE;
+            }
+        }
+
+        // What a sprite reads depends on the screen: 16x16 sprites for DXY0 when high, and rows for every selected plane.
+        std::size_t sprite_length(const Processor& processor, word opcode) {
+            std::size_t n = opcode & 0x0F, planes {0};
+            for (std::size_t p {0}; p < Processor::PLANES; ++p) planes += processor.selected_planes() >> p & 1;
+            return (processor.high_resolution() && n == 0 ? 32 : n) * planes;
+        }
+
+        // Anything that might not fall through to the next instruction.
+        bool ends_block(Instruction instruction) {
+            switch (instruction) {
+            case Instruction::SYS_A: case Instruction::RET: case Instruction::JP_A: case Instruction::CALL_A:
+            case Instruction::SE_RC: case Instruction::SNE_RC: case Instruction::SE_RR: case Instruction::SNE_RR:
+            case Instruction::JP_V0A: case Instruction::SKP_R: case Instruction::SKNP_R: case Instruction::LD_RK:
+            case Instruction::LD_IL: case Instruction::EXIT: case Instruction::INVALID: return true;
+            default: return false;
+            }
+        }
+
+        addr number(const std::string& text) {
+            std::size_t used {0};
+            unsigned long value {0};
+            try { value = std::stoul(text, &used, 0); }
+            catch (const std::exception&) { used = 0; }
+            if (used == 0 || used != text.size() || value > 0xFFFF)
+                throw std::invalid_argument {"Couldn't parse breakpoint, bad number " + text + '.'};
+            return static_cast<addr>(value);
+        }
+
+        Processor::Register register_named(const std::string& name) {
+            if (name == "I") return Processor::Register::I;
+            if (name == "PC") return Processor::Register::PC;
+            if (name == "SP") return Processor::Register::SP;
+            if (name == "DT") return Processor::Register::DT;
+            if (name == "ST") return Processor::Register::ST;
+            if (name.size() == 2 && (name[0] == 'V' || name[0] == 'v') && std::isxdigit(static_cast<unsigned char>(name[1])))
+                return static_cast<Processor::Register>(std::strtoul(name.c_str() + 1, nullptr, 16));
+            throw std::invalid_argument {"Couldn't parse breakpoint, unknown register " + name + '.'};
+        }
+    }
+
+    void Debugger::watch(std::bitset<Memory::SIZE>& watched, addr address, std::size_t length) {
+        for (std::size_t i {0}; i < length && address + i < Memory::SIZE; ++i) watched.set(address + i);
+    }
+
+    bool Debugger::watched(const std::bitset<Memory::SIZE>& watched, addr address, std::size_t length, addr& found) {
+        for (std::size_t i {0}; i < length && address + i < Memory::SIZE; ++i) {
+            if (watched.test(address + i)) {
+                found = static_cast<addr>(address + i);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void Debugger::add(const std::string& text) {
+        std::size_t operation {text.find('=')};
+        if (operation != std::string::npos) {
+            bool equal {operation == 0 || text[operation - 1] != '!'};
+            std::string name {text.substr(0, equal ? operation : operation - 1)};
+            condition(Condition {register_named(name), equal, number(text.substr(operation + 1))});
+        } else if (text.compare(0, 2, "r:") == 0 || text.compare(0, 2, "w:") == 0) {
+            std::size_t plus {text.find('+')};
+            addr address {number(text.substr(2, plus == std::string::npos ? std::string::npos : plus - 2))};
+            std::size_t length {plus == std::string::npos ? std::size_t {1} : number(text.substr(plus + 1))};
+            if (text[0] == 'r') watch_reads(address, length);
+            else watch_writes(address, length);
+        } else breakpoint(number(text));
+    }
+
+    bool Debugger::check(const Processor& processor, const Memory& memory) {
+        last_hit = Hit {Hit::Kind::NONE, 0x0000, 0x0000};
+        if (resuming) {
+            resuming = false;
+            return false;
+        }
+
+        addr PC {processor.register_state(Processor::Register::PC)};
+        if (PC < Memory::SIZE && breakpoints.test(PC)) last_hit = Hit {Hit::Kind::BREAKPOINT, PC, 0x0000};
+        for (const Condition& checked : conditions) {
+            if (last_hit.kind == Hit::Kind::NONE && (processor.register_state(checked.reg) == checked.value) == checked.equal)
+                last_hit = Hit {Hit::Kind::CONDITION, PC, 0x0000};
+        }
+
+        if (last_hit.kind == Hit::Kind::NONE && memory.readable(PC) && memory.readable(PC + 1)) {
+            word opcode = memory.load(PC) << 8 | memory.load(PC + 1);
+            std::size_t length;
+            Instruction instruction {Interpreter::decode(opcode >> 8, opcode & 0xFF)};
+            Access kind {access(instruction, opcode, length)};
+            if (instruction == Instruction::DRW_RRC) length = sprite_length(processor, opcode);
+            addr I {processor.register_state(Processor::Register::I)}, found;
+            if (kind == Access::READ && watched(reads, I, length, found)) last_hit = Hit {Hit::Kind::READ, PC, found};
+            if (kind == Access::WRITE && watched(writes, I, length, found)) last_hit = Hit {Hit::Kind::WRITE, PC, found};
+        }
+
+        return last_hit.kind != Hit::Kind::NONE;
+    }
+
+    std::size_t Debugger::block(const Memory& memory, addr PC) const {
+        constexpr std::size_t LONGEST {256}; // Bounds the scan, a block this long simply gets checked twice.
+        std::size_t length {0};
+        for (addr address {PC}; length < LONGEST && memory.readable(address) && memory.readable(address + 1); address += 2) {
+            if (length != 0 && breakpoints.test(address)) break;
+            word opcode = memory.load(address) << 8 | memory.load(address + 1);
+            Instruction instruction {Interpreter::decode(opcode >> 8, opcode & 0xFF)};
+            std::size_t bytes;
+            Access kind {access(instruction, opcode, bytes)};
+            if (length != 0 && kind != Access::NONE) break; // Starts a block of its own, so it's checked first.
+            ++length;
+            if (ends_block(instruction) || kind == Access::WRITE) break; // Stores might change what comes next.
+        }
+
+        return std::max<std::size_t>(length, 1);
+    }
+
+    const char* Debugger::hit_name(Hit::Kind kind) {
+        switch (kind) {
+        case Hit::Kind::NONE: return "nothing";
+        case Hit::Kind::BREAKPOINT: return "breakpoint";
+        case Hit::Kind::CONDITION: return "condition";
+        case Hit::Kind::READ: return "read watchpoint";
+        case Hit::Kind::WRITE: return "write watchpoint";
+        default: return "unknown";
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef CH8_DEBUGGER_HPP
+#define CH8_DEBUGGER_HPP
+
+#include <bitset>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include "definitions.hpp"
+#include "processor.hpp"
+#include "memory.hpp"
+
+namespace ch8 {
+    // Breakpoints on the PC, register conditions and memory watchpoints, for a processor
+    // given this with Processor::debug. Nothing is checked unless it is, after that run()
+    // checks at the start of every basic block, where blocks end at anything that might
+    // jump and before anything touching memory, so watchpoints stop right before the access.
+    // Conditions are only checked there too, so they stop once a block ends after they hold.
+    class Debugger {
+    public:
+        struct Hit {
+            enum class Kind {
+                NONE, // Nothing hit (yet).
+                BREAKPOINT, // PC reached a breakpoint.
+                CONDITION, // A register condition held.
+                READ, // The instruction at PC is about to read a watched address.
+                WRITE // Same, but write.
+            };
+
+            Kind kind;
+            addr PC;
+            addr address; // Watched address for reads and writes, zero otherwise.
+        };
+
+        struct Condition {
+            Processor::Register reg;
+            bool equal; // Otherwise not equal.
+            word value;
+        };
+
+        void breakpoint(addr address) { breakpoints.set(address % Memory::SIZE); }
+        void clear(addr address) { breakpoints.reset(address % Memory::SIZE); }
+        void watch_reads(addr address, std::size_t length) { watch(reads, address, length); }
+        void watch_writes(addr address, std::size_t length) { watch(writes, address, length); }
+        void condition(const Condition& added) { conditions.push_back(added); }
+
+        // One of "0x2A4" (breakpoint), "r:0x300", "w:0x300", "r:0x300+16" (watchpoints, one byte
+        // unless given a length), "V3=0x10", "I!=0x300" (conditions). Throws std::invalid_argument.
+        void add(const std::string&);
+
+        // True if the processor should stop before the instruction at PC, which is recorded in hit().
+        // Always false the first time after resume(), so the same instruction can then execute.
+        bool check(const Processor&, const Memory&);
+        std::size_t block(const Memory&, addr) const; // Instructions that can execute without checking again.
+        const Hit& hit() const { return last_hit; }
+        void resume() { resuming = true; }
+        static const char* hit_name(Hit::Kind); // E.g. "breakpoint", for reporting.
+
+    private:
+        std::bitset<Memory::SIZE> breakpoints, reads, writes;
+        std::vector<Condition> conditions;
+        Hit last_hit {Hit::Kind::NONE, 0x0000, 0x0000};
+        bool resuming {false};
+        static void watch(std::bitset<Memory::SIZE>&, addr, std::size_t);
+        static bool watched(const std::bitset<Memory::SIZE>&, addr, std::size_t, addr&); // First one watched, if any.
+    };
+}
+
+#endif
@@ -0,0 +1,164 @@
+#include "catch.hpp"
+#include "debugger.hpp"
+#include "processor.hpp"
+#include "memory.hpp"
+
+namespace {
+    // Counts V0 from 5 up to 10, storing it at 0x300 each time, then draws from there and exits.
+    const ch8::byte counting[] = {
+        0x60, 0x05, // 0x200: LD V0, 0x05
+        0x70, 0x01, // 0x202: ADD V0, 0x01
+        0xA3, 0x00, // 0x204: LD I, 0x300
+        0xF0, 0x55, // 0x206: LD [I], V0
+        0x30, 0x0A, // 0x208: SE V0, 0x0A
+        0x12, 0x02, // 0x20A: JP 0x202
+        0xD0, 0x15, // 0x20C: DRW V0, V1, 5
+        0x00, 0xFD  // 0x20E: EXIT
+    };
+
+    ch8::word state(const ch8::Processor& processor, ch8::Processor::Register reg) { return processor.register_state(reg); }
+}
+
+TEST_CASE("Debugger blocks end at jumps and before memory accesses.", "[debugger]") {
+    ch8::Memory memory {counting, sizeof(counting)};
+    ch8::Debugger debugger;
+    REQUIRE(debugger.block(memory, 0x200) == 3); // Up to the store, which is checked on its own.
+    REQUIRE(debugger.block(memory, 0x206) == 1); // Stores end blocks too.
+    REQUIRE(debugger.block(memory, 0x208) == 1); // Skips might not fall through.
+    REQUIRE(debugger.block(memory, 0x20C) == 2);
+    debugger.breakpoint(0x204);
+    REQUIRE(debugger.block(memory, 0x200) == 2);
+}
+
+TEST_CASE("Debugger stops before breakpoints until resumed.", "[debugger]") {
+    ch8::Memory memory {counting, sizeof(counting)};
+    ch8::Processor processor {memory, 0};
+    ch8::Debugger debugger;
+    debugger.breakpoint(0x208);
+    processor.debug(&debugger);
+
+    REQUIRE(processor.run(1000) == 4);
+    REQUIRE(processor.running());
+    REQUIRE(debugger.hit().kind == ch8::Debugger::Hit::Kind::BREAKPOINT);
+    REQUIRE(debugger.hit().PC == 0x208);
+    REQUIRE(state(processor, ch8::Processor::Register::V0) == 6);
+    processor.step(); // Still stopped.
+    REQUIRE(state(processor, ch8::Processor::Register::PC) == 0x208);
+
+    debugger.resume();
+    REQUIRE(processor.run(1000) == 5); // Around the loop once more.
+    REQUIRE(state(processor, ch8::Processor::Register::V0) == 7);
+    debugger.clear(0x208);
+    debugger.resume();
+    processor.run(1000);
+    REQUIRE_FALSE(processor.running());
+    REQUIRE(state(processor, ch8::Processor::Register::V0) == 10);
+}
+
+TEST_CASE("Debugger watchpoints stop right before the access.", "[debugger]") {
+    ch8::Memory memory {counting, sizeof(counting)};
+    ch8::Processor processor {memory, 0};
+    ch8::Debugger debugger;
+    debugger.add("w:0x2FE+4");
+    debugger.add("r:0x304");
+    processor.debug(&debugger);
+
+    processor.run(1000);
+    REQUIRE(debugger.hit().kind == ch8::Debugger::Hit::Kind::WRITE);
+    REQUIRE(debugger.hit().PC == 0x206);
+    REQUIRE(debugger.hit().address == 0x300);
+    REQUIRE(memory.read(0x300) == 0x00); // Not written yet.
+
+    debugger = ch8::Debugger {}; // Only the read watchpoint left.
+    debugger.add("r:0x304");
+    debugger.resume();
+    processor.run(1000);
+    REQUIRE(debugger.hit().kind == ch8::Debugger::Hit::Kind::READ);
+    REQUIRE(debugger.hit().PC == 0x20C);
+    REQUIRE(debugger.hit().address == 0x304);
+    REQUIRE(memory.read(0x300) == 10);
+}
+
+TEST_CASE("Debugger read watchpoints cover whole sprites.", "[debugger]") {
+    const ch8::byte large[] = {
+        0x00, 0xFF, // 0x200: HIGH
+        0xA3, 0x00, // 0x202: LD I, 0x300
+        0xD0, 0x10, // 0x204: DRW V0, V1, 0, reading 32 bytes
+        0x00, 0xFD  // 0x206: EXIT
+    };
+
+    ch8::Memory memory {large, sizeof(large)};
+    ch8::Processor processor {memory, 0};
+    processor.profile(ch8::Profile::SUPER_CHIP);
+    ch8::Debugger debugger;
+    debugger.watch_reads(0x31F, 1);
+    processor.debug(&debugger);
+    processor.run(1000);
+    REQUIRE(debugger.hit().kind == ch8::Debugger::Hit::Kind::READ);
+    REQUIRE(debugger.hit().PC == 0x204);
+    REQUIRE(debugger.hit().address == 0x31F);
+    if (ch8::Processor::PLANES < 2) return;
+
+    const ch8::byte planes[] = {
+        0xA3, 0x00, // 0x200: LD I, 0x300
+        0xF3, 0x01, // 0x202: PLANE 3
+        0xD0, 0x12, // 0x204: DRW V0, V1, 2, reading 2 bytes for each plane
+        0x00, 0xFD  // 0x206: EXIT
+    };
+
+    ch8::Memory xo_memory {planes, sizeof(planes)};
+    ch8::Processor xo {xo_memory, 0};
+    xo.profile(ch8::Profile::XO_CHIP);
+    ch8::Debugger second;
+    second.watch_reads(0x303, 1); // Only the second plane's rows.
+    xo.debug(&second);
+    xo.run(1000);
+    REQUIRE(second.hit().kind == ch8::Debugger::Hit::Kind::READ);
+    REQUIRE(second.hit().PC == 0x204);
+}
+
+TEST_CASE("Debugger conditions stop at the next block once they hold.", "[debugger]") {
+    ch8::Memory memory {counting, sizeof(counting)};
+    ch8::Processor processor {memory, 0};
+    ch8::Debugger debugger;
+    debugger.add("V0=0x08");
+    processor.debug(&debugger);
+
+    processor.run(1000);
+    REQUIRE(debugger.hit().kind == ch8::Debugger::Hit::Kind::CONDITION);
+    REQUIRE(debugger.hit().PC == 0x206); // The block with the ADD ends before the store.
+    REQUIRE(state(processor, ch8::Processor::Register::V0) == 8);
+
+    ch8::Debugger other;
+    other.add("I!=0x000");
+    processor.debug(&other);
+    REQUIRE(processor.run(1000) == 0);
+    REQUIRE(other.hit().kind == ch8::Debugger::Hit::Kind::CONDITION);
+}
+
+TEST_CASE("Debugged runs end up where plain ones do.", "[debugger]") {
+    ch8::Memory plain_memory {counting, sizeof(counting)}, debugged_memory {counting, sizeof(counting)};
+    ch8::Processor plain {plain_memory, 0}, debugged {debugged_memory, 0};
+    ch8::Debugger debugger;
+    debugger.breakpoint(0x800); // Armed, but never hit.
+    debugged.debug(&debugger);
+
+    REQUIRE(plain.run(1000) == debugged.run(1000));
+    REQUIRE_FALSE(debugged.running());
+    for (int r {static_cast<int>(ch8::Processor::Register::V0)}; r <= static_cast<int>(ch8::Processor::Register::SP); ++r)
+        REQUIRE(state(plain, static_cast<ch8::Processor::Register>(r)) == state(debugged, static_cast<ch8::Processor::Register>(r)));
+    REQUIRE(plain_memory.read(0x300) == debugged_memory.read(0x300));
+}
+
+TEST_CASE("Debugger parses breakpoints, watchpoints and conditions.", "[debugger]") {
+    ch8::Debugger debugger;
+    REQUIRE_NOTHROW(debugger.add("0x2A4"));
+    REQUIRE_NOTHROW(debugger.add("r:0x300+16"));
+    REQUIRE_NOTHROW(debugger.add("w:768"));
+    REQUIRE_NOTHROW(debugger.add("VF=1"));
+    REQUIRE_NOTHROW(debugger.add("DT!=0"));
+    REQUIRE_THROWS_AS(debugger.add("0x2G4"), const std::invalid_argument&);
+    REQUIRE_THROWS_AS(debugger.add("VG=1"), const std::invalid_argument&);
+    REQUIRE_THROWS_AS(debugger.add("r:"), const std::invalid_argument&);
+    REQUIRE_THROWS_AS(debugger.add(""), const std::invalid_argument&);
+}
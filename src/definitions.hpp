@@ -7,6 +7,12 @@ namespace ch8 {
     using byte = unsigned char; // Most registers are 8-bit, and thus of this type.
     using word = unsigned short; // Some special registers like the PC and I register are word sized.
     using addr = word; // Easier to read addresses, same thing as the 16-bit word.
+
+    // Non-owning view of some bytes, usually a ROM inside of a mapped file.
+    struct Span {
+        const byte* data;
+        std::size_t size;
+    };
 }
 
 #endif
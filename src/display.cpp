@@ -0,0 +1,32 @@
+#include "display.hpp"
+#include "processor.hpp"
+
+namespace ch8 {
+    namespace {
+        const byte shades[4] {0x00, 0xFF, 0xAA, 0x55}; // By the planes a pixel is set in.
+    }
+
+    void Display::rgba8888(const byte* pixels, byte* rgba) {
+        for (std::size_t i {0}; i < Processor::SCREEN_WIDTH * Processor::SCREEN_HEIGHT; ++i) {
+            // Only vary the game screen between shades of grey for now...
+            rgba[i*4] = 0xFF; // Alpha channel for some reason...
+            rgba[i*4 + 1] = shades[pixels[i] & 3];
+            rgba[i*4 + 2] = shades[pixels[i] & 3];
+            rgba[i*4 + 3] = shades[pixels[i] & 3];
+        }
+    }
+
+    void Display::rgba8888(const std::uint64_t* rows, byte* rgba) {
+        constexpr std::size_t PLANE_WORDS {Processor::HIGH_HEIGHT * 2};
+        for (std::size_t y {0}; y < Processor::HIGH_HEIGHT; ++y) {
+            for (std::size_t x {0}; x < Processor::HIGH_WIDTH; ++x) {
+                byte pixel {0};
+                for (std::size_t p {0}; p < Processor::PLANES; ++p)
+                    pixel |= ((rows[p * PLANE_WORDS + y * 2 + x / 64] >> (63 - x % 64)) & 1) << p;
+                byte* out {rgba + (y * Processor::HIGH_WIDTH + x) * 4};
+                out[0] = 0xFF;
+                out[1] = out[2] = out[3] = shades[pixel];
+            }
+        }
+    }
+}
@@ -0,0 +1,19 @@
+#ifndef CH8_DISPLAY_HPP
+#define CH8_DISPLAY_HPP
+
+#include <cstdint>
+#include "definitions.hpp"
+
+namespace ch8 {
+    // Conversions from the processor's display buffer to what frontends draw.
+    class Display {
+    public:
+        // Every pixel of a display buffer (0 or 1) to 4 bytes: 0xFF, then black or white
+        // in the other three, which is SDL_PIXELFORMAT_RGBA8888 on little-endian hosts.
+        // XO-CHIP's second plane adds two greys, for pixels only in it and those in both.
+        static void rgba8888(const byte*, byte*);
+        static void rgba8888(const std::uint64_t*, byte*); // Same, from the packed 128x64 high resolution planes.
+    };
+}
+
+#endif
@@ -0,0 +1,122 @@
+#include "environment.hpp"
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+
+namespace ch8 {
+    Environment::Environment(const byte* program, std::size_t program_size, Observation observation_format,
+                             byte* observation_buffer, std::size_t frame_cycles)
+        : initial_memory {program, program_size}, machine_memory {initial_memory},
+          machine_processor {machine_memory, 0}, format {observation_format},
+          observation_slot {observation_buffer}, cycles_per_frame {frame_cycles} {
+        if (observation_slot == nullptr) throw std::invalid_argument {"Environment needs an observation buffer."};
+        if (format == Observation::BYTES) machine_processor.bind_display(observation_slot);
+        observe();
+    }
+
+    std::size_t Environment::observation_size(Observation observation_format) {
+        std::size_t pixels {Processor::SCREEN_WIDTH * Processor::SCREEN_HEIGHT};
+        if (observation_format == Observation::PACKED) return pixels / 8;
+        else return pixels;
+    }
+
+    void Environment::reset(unsigned seed) {
+        machine_memory = initial_memory;
+        machine_processor.reset(seed);
+        finished = false;
+        observe();
+    }
+
+    Environment::Result Environment::step(word action, std::size_t frameskip) {
+        Result result;
+        if (finished) {
+            result.done = true;
+            return result;
+        }
+
+        bool ended {false};
+        for (std::size_t frame {0}; frame < frameskip && machine_processor.running() && !ended; ++frame) {
+            machine_processor.key_mask(action);
+            result.cycles += machine_processor.run(cycles_per_frame);
+            machine_processor.tick_timers();
+            ended = done && done(machine_memory, machine_processor);
+        }
+
+        result.faulted = machine_processor.trapped();
+
+        observe();
+        if (reward) result.reward = reward(machine_memory, machine_processor);
+        result.done = result.faulted || !machine_processor.running() || ended;
+        finished = result.done;
+        return result;
+    }
+
+    namespace {
+        // SUPER-CHIP's screen at the size of the usual one, with the planes lit anywhere in the 2x2 each pixel covers.
+        void halve(const std::uint64_t* planes, byte* pixels) {
+            for (std::size_t y {0}; y < Processor::SCREEN_HEIGHT; ++y) {
+                for (std::size_t x {0}; x < Processor::SCREEN_WIDTH; ++x) {
+                    byte pixel {0};
+                    for (std::size_t p {0}; p < Processor::PLANES; ++p) {
+                        const std::uint64_t* rows {planes + (p * Processor::HIGH_HEIGHT + y * 2) * 2}; // Both it covers.
+                        std::size_t column {x * 2};
+                        std::uint64_t lit {((rows[column / 64] | rows[2 + column / 64]) >> (62 - column % 64)) & 3};
+                        pixel |= (lit != 0) << p;
+                    }
+
+                    pixels[y * Processor::SCREEN_WIDTH + x] = pixel;
+                }
+            }
+        }
+    }
+
+    void Environment::observe() {
+        // The slot shows the halved screen while high, so the low one is kept aside until it's back.
+        if (format == Observation::BYTES) {
+            byte* screen {machine_processor.high_resolution() ? low_screen : observation_slot};
+            if (machine_processor.display_buffer() != screen) machine_processor.bind_display(screen);
+        }
+
+        if (!machine_processor.display_updated()) return;
+        machine_processor.updated_display();
+        const byte* display {machine_processor.display_buffer()};
+        byte halved[Processor::SCREEN_WIDTH * Processor::SCREEN_HEIGHT];
+        if (machine_processor.high_resolution()) {
+            halve(machine_processor.high_display(), halved);
+            display = halved;
+        }
+
+        if (format == Observation::BYTES) {
+            if (display != observation_slot) std::memcpy(observation_slot, display, sizeof(halved));
+            return;
+        }
+
+        // Pixels hold a bit per plane, any of them counts as lit.
+        for (std::size_t i {0}; i < observation_size(format); ++i, display += 8) {
+            observation_slot[i] = (display[0] != 0) << 7 | (display[1] != 0) << 6 | (display[2] != 0) << 5 |
+                                  (display[3] != 0) << 4 | (display[4] != 0) << 3 | (display[5] != 0) << 2 |
+                                  (display[6] != 0) << 1 | (display[7] != 0);
+        }
+    }
+
+    EnvironmentBatch::EnvironmentBatch(const byte* program, std::size_t program_size, std::size_t count,
+                                       Environment::Observation format, byte* observations, std::size_t frame_cycles) {
+        std::size_t slot_size {Environment::observation_size(format)};
+        for (std::size_t i {0}; i < count; ++i) {
+            environments.emplace_back(new Environment {program, program_size, format,
+                                                       observations + i * slot_size, frame_cycles});
+        }
+    }
+
+    void EnvironmentBatch::reset(unsigned seed) {
+        for (std::size_t i {0}; i < environments.size(); ++i) {
+            environments[i]->reset(seed + static_cast<unsigned>(i));
+        }
+    }
+
+    void EnvironmentBatch::step(const word* actions, std::size_t frameskip, Environment::Result* results) {
+        for (std::size_t i {0}; i < environments.size(); ++i) {
+            results[i] = environments[i]->step(actions[i], frameskip);
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef CH8_ENVIRONMENT_HPP
+#define CH8_ENVIRONMENT_HPP
+
+#include <memory>
+#include <vector>
+#include <functional>
+#include "definitions.hpp"
+#include "processor.hpp"
+#include "memory.hpp"
+
+namespace ch8 {
+    // Reinforcement learning style interface around a single machine. Observations are
+    // never allocated by the environment, they are written straight into a slot of a
+    // buffer owned by the caller. For BYTES the processor draws into the slot directly,
+    // for PACKED the slot is refreshed (8 pixels per byte, MSB is leftmost, rows first)
+    // only after steps where the display actually changed. SUPER-CHIP's 128x64 screen is
+    // observed halved, a pixel is lit if any of the 2x2 it covers is, and copied like PACKED.
+    class Environment {
+    public:
+        enum class Observation {
+            PACKED, // 1 bit per pixel, lit on any plane, SCREEN_WIDTH * SCREEN_HEIGHT / 8 bytes.
+            BYTES // 1 byte per pixel, bit p is plane p, same layout as Processor::display_buffer.
+        };
+
+        struct Result {
+            double reward {0.0}; // Whatever the reward hook said, zero without one.
+            bool done {false}; // Program exited, faulted or the done hook said so.
+            bool faulted {false}; // Processor threw, the environment needs a reset.
+            std::size_t cycles {0}; // Instructions executed during the step.
+        };
+
+        // The reward hook is called once per step and the done hook after every frame (neither per
+        // instruction), usually to peek at the game's score or lives in memory, or at a register.
+        using RewardHook = std::function<double(const Memory&, const Processor&)>;
+        using DoneHook = std::function<bool(const Memory&, const Processor&)>;
+
+        Environment(const byte*, std::size_t, Observation, byte*, std::size_t); // ROM, observation slot, cycles/frame.
+        Environment(const Environment&) = delete; // Processor refers to our own memory.
+        Environment& operator=(const Environment&) = delete;
+
+        void reset(unsigned); // Reloads the ROM and reseeds, the observation is cleared too.
+        Result step(word, std::size_t); // Holds the key mask for n frames (frameskip), stops early if done.
+        void reward_hook(RewardHook hook) { reward = std::move(hook); }
+        void done_hook(DoneHook hook) { done = std::move(hook); }
+        void profile(Profile quirks) { machine_processor.profile(quirks); } // Kept across resets, legacy until set.
+
+        const byte* observation() const { return observation_slot; }
+        const Memory& memory() const { return machine_memory; }
+        const Processor& processor() const { return machine_processor; }
+        static std::size_t observation_size(Observation); // Size of one slot in bytes.
+
+    private:
+        void observe(); // Packs the display into the slot, if it changed.
+
+        Memory initial_memory; // Pristine copy of the ROM, resets are a plain copy.
+        Memory machine_memory;
+        Processor machine_processor;
+        Observation format;
+        byte* observation_slot;
+        byte low_screen[Processor::SCREEN_WIDTH * Processor::SCREEN_HEIGHT]; // Drawn on instead of the slot while high.
+        std::size_t cycles_per_frame;
+        RewardHook reward;
+        DoneHook done;
+        bool finished {false};
+    };
+
+    // M environments over the same ROM, with observations laid out one after the other in
+    // a single caller buffer of M * observation_size bytes, ready to be handed to a model.
+    class EnvironmentBatch {
+    public:
+        EnvironmentBatch(const byte*, std::size_t, std::size_t, Environment::Observation, byte*, std::size_t);
+        std::size_t size() const { return environments.size(); }
+        Environment& operator[](std::size_t i) { return *environments[i]; }
+        void reset(unsigned); // Environment i gets seed + i.
+        void step(const word*, std::size_t, Environment::Result*); // M actions in, M results out.
+
+    private:
+        std::vector<std::unique_ptr<Environment>> environments;
+    };
+}
+
+#endif
@@ -0,0 +1,115 @@
+#include "catch.hpp"
+#include "environment.hpp"
+#include <vector>
+
+namespace {
+    // LD V0, 0; DRW V0, V0, 1 (sprite at 0x20C); SKP V1; JP 0x204; ADD V2, 1; EXIT; 0xFF.
+    // Draws a line once, then keeps waiting until key 0 is pressed before it exits.
+    const ch8::byte program[] = {0x60, 0x00, 0xA2, 0x0C, 0xD0, 0x01, 0xE1, 0x9E,
+                                 0x12, 0x06, 0x72, 0x01, 0xFF, 0x00};
+}
+
+TEST_CASE("Environment writes packed observations into the caller's buffer.", "[environment, packed]") {
+    std::vector<ch8::byte> observations(ch8::Environment::observation_size(ch8::Environment::Observation::PACKED), 0xAA);
+    REQUIRE(observations.size() == 64 * 32 / 8);
+    ch8::Environment environment {program, sizeof(program), ch8::Environment::Observation::PACKED, observations.data(), 4};
+    REQUIRE(environment.observation() == observations.data());
+    REQUIRE(observations[0] == 0x00); // Initial screen is cleared.
+
+    ch8::Environment::Result result {environment.step(0x0000, 2)};
+    REQUIRE(!result.done);
+    REQUIRE(result.cycles == 8);
+    REQUIRE(observations[0] == 0xFF); // Sprite line is the top left 8 pixels.
+    REQUIRE(observations[1] == 0x00);
+}
+
+TEST_CASE("Environment draws byte observations in place.", "[environment, bytes]") {
+    std::vector<ch8::byte> observations(ch8::Environment::observation_size(ch8::Environment::Observation::BYTES));
+    ch8::Environment environment {program, sizeof(program), ch8::Environment::Observation::BYTES, observations.data(), 4};
+    REQUIRE(environment.processor().display_buffer() == observations.data()); // No copy at all.
+    environment.step(0x0000, 1);
+    REQUIRE(observations[7] == 1);
+    REQUIRE(observations[8] == 0);
+}
+
+TEST_CASE("Environment observes SUPER-CHIP's screen halved.", "[environment, high]") {
+    const ch8::byte high[] = {0x00, 0xFF, 0xA0, 0x00, 0xD0, 0x01, 0x12, 0x06}; // HIGH; LD I, 0x000; DRW V0, V0, 1; JP 0x206.
+    std::vector<ch8::byte> packed(ch8::Environment::observation_size(ch8::Environment::Observation::PACKED));
+    std::vector<ch8::byte> bytes(ch8::Environment::observation_size(ch8::Environment::Observation::BYTES));
+    ch8::Environment packed_environment {high, sizeof(high), ch8::Environment::Observation::PACKED, packed.data(), 4};
+    ch8::Environment bytes_environment {high, sizeof(high), ch8::Environment::Observation::BYTES, bytes.data(), 4};
+    packed_environment.profile(ch8::Profile::SUPER_CHIP);
+    bytes_environment.profile(ch8::Profile::SUPER_CHIP);
+    packed_environment.step(0x0000, 1);
+    bytes_environment.step(0x0000, 1);
+
+    REQUIRE(packed[0] == 0xC0); // Font zero's top row, 0xF0, is 4 high resolution pixels.
+    REQUIRE(packed[8] == 0x00);
+    REQUIRE(bytes[0] == 1);
+    REQUIRE(bytes[1] == 1);
+    REQUIRE(bytes[2] == 0);
+    REQUIRE(bytes[64] == 0);
+
+    packed_environment.reset(0); // Back to low resolution, with the same profile.
+    REQUIRE(packed[0] == 0x00);
+    REQUIRE(packed_environment.processor().profile() == ch8::Profile::SUPER_CHIP);
+
+    // LD I, 0x000; DRW V0, V0, 1; HIGH; DRW V0, V0, 1; JP 0x208. The low screen isn't lost under the halved one.
+    const ch8::byte both[] = {0xA0, 0x00, 0xD0, 0x01, 0x00, 0xFF, 0xD0, 0x01, 0x12, 0x08};
+    ch8::Environment switching {both, sizeof(both), ch8::Environment::Observation::BYTES, bytes.data(), 4};
+    switching.profile(ch8::Profile::SUPER_CHIP);
+    switching.step(0x0000, 1);
+    REQUIRE(bytes[1] == 1);
+    REQUIRE(bytes[2] == 0);
+    REQUIRE(switching.processor().display_buffer()[2] == 1);
+    REQUIRE(switching.processor().display_buffer()[3] == 1);
+
+    switching.reset(0); // Draws into the slot again.
+    REQUIRE(switching.processor().display_buffer() == bytes.data());
+    REQUIRE(bytes[1] == 0);
+}
+
+TEST_CASE("Environment hooks, done flags and resets.", "[environment, hooks]") {
+    std::vector<ch8::byte> observations(ch8::Environment::observation_size(ch8::Environment::Observation::PACKED));
+    ch8::Environment environment {program, sizeof(program), ch8::Environment::Observation::PACKED, observations.data(), 4};
+    environment.reward_hook([](const ch8::Memory&, const ch8::Processor& processor) {
+        return static_cast<double>(processor.register_state(ch8::Processor::Register::V2));
+    });
+
+    REQUIRE(environment.step(0x0000, 1).reward == 0.0);
+    ch8::Environment::Result result {environment.step(0x0001, 5)};
+    REQUIRE(result.done); // Key 0 is pressed, so the program exits.
+    REQUIRE(result.reward == 1.0);
+    REQUIRE(environment.step(0x0001, 1).done); // Stays done until reset.
+
+    environment.reset(7);
+    REQUIRE(observations[0] == 0x00); // Screen is cleared on reset.
+    REQUIRE(environment.processor().register_state(ch8::Processor::Register::PC) == 0x200);
+    environment.done_hook([](const ch8::Memory&, const ch8::Processor&) { return true; });
+    REQUIRE(environment.step(0x0000, 1).done);
+
+    environment.reset(7);
+    std::size_t frames {0};
+    environment.done_hook([&frames](const ch8::Memory&, const ch8::Processor&) { return ++frames == 2; });
+    result = environment.step(0x0000, 5);
+    REQUIRE(result.done); // Stops early, after the frame the hook said so.
+    REQUIRE(frames == 2);
+    REQUIRE(result.cycles == 8);
+}
+
+TEST_CASE("Environment batches share one observation buffer.", "[environment, batch]") {
+    const std::size_t slot {ch8::Environment::observation_size(ch8::Environment::Observation::PACKED)};
+    std::vector<ch8::byte> observations(3 * slot);
+    ch8::EnvironmentBatch batch {program, sizeof(program), 3, ch8::Environment::Observation::PACKED, observations.data(), 4};
+    REQUIRE(batch.size() == 3);
+    REQUIRE(batch[2].observation() == observations.data() + 2 * slot);
+
+    const ch8::word actions[3] = {0x0000, 0x0001, 0x0000};
+    ch8::Environment::Result results[3];
+    batch.reset(0);
+    batch.step(actions, 3, results);
+    REQUIRE(!results[0].done);
+    REQUIRE(results[1].done); // Only the one pressing key 0.
+    REQUIRE(!results[2].done);
+    REQUIRE(observations[2 * slot] == 0xFF);
+}
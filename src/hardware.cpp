@@ -0,0 +1,134 @@
+#include "hardware.hpp"
+#include <iomanip>
+
+#ifdef __linux__
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+namespace ch8 {
+    namespace {
+#ifdef __linux__
+        int open_event(HardwareCounters::Event event) {
+            perf_event_attr attributes;
+            std::memset(&attributes, 0, sizeof(attributes));
+            attributes.size = sizeof(attributes);
+            attributes.disabled = 1;
+            attributes.exclude_kernel = 1; // Allowed without privileges, and the kernel isn't ours anyway.
+            attributes.exclude_hv = 1;
+            attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            switch (event) {
+                case HardwareCounters::Event::CYCLES:
+                    attributes.type = PERF_TYPE_HARDWARE;
+                    attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+                    break;
+                case HardwareCounters::Event::INSTRUCTIONS:
+                    attributes.type = PERF_TYPE_HARDWARE;
+                    attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+                    break;
+                case HardwareCounters::Event::BRANCH_MISSES:
+                    attributes.type = PERF_TYPE_HARDWARE;
+                    attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+                    break;
+                case HardwareCounters::Event::L1D_MISSES:
+                    attributes.type = PERF_TYPE_HW_CACHE;
+                    attributes.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                    break;
+            }
+
+            return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0)); // This thread, any CPU.
+        }
+#endif
+    }
+
+    constexpr std::size_t HardwareCounters::EVENTS;
+    HardwareCounters::HardwareCounters() {
+        for (std::size_t i {0}; i < EVENTS; ++i) {
+#ifdef __linux__
+            descriptors[i] = open_event(static_cast<Event>(i));
+#else
+            descriptors[i] = -1;
+#endif
+        }
+    }
+
+    HardwareCounters::~HardwareCounters() {
+#ifdef __linux__
+        for (int descriptor : descriptors) if (descriptor >= 0) close(descriptor);
+#endif
+    }
+
+    bool HardwareCounters::available() const {
+        for (int descriptor : descriptors) if (descriptor >= 0) return true;
+        return false;
+    }
+
+    void HardwareCounters::start() {
+#ifdef __linux__
+        for (int descriptor : descriptors) if (descriptor >= 0) ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    void HardwareCounters::stop() {
+#ifdef __linux__
+        for (int descriptor : descriptors) if (descriptor >= 0) ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+    }
+
+    HardwareCounters::Reading HardwareCounters::read() const {
+        Reading reading;
+        reading.operations = executed;
+#ifdef __linux__
+        for (std::size_t i {0}; i < EVENTS; ++i) {
+            std::uint64_t values[3]; // Count, time enabled and time running.
+            if (descriptors[i] < 0 || ::read(descriptors[i], values, sizeof(values)) != sizeof(values)) continue;
+            reading.available[i] = true;
+            reading.counts[i] = values[2] == 0 ? values[0] : static_cast<std::uint64_t>(static_cast<double>(values[0]) * values[1] / values[2]);
+        }
+#endif
+        return reading;
+    }
+
+    const char* HardwareCounters::name(Event event) {
+        switch (event) {
+            case Event::CYCLES: return "cycles";
+            case Event::INSTRUCTIONS: return "instructions";
+            case Event::BRANCH_MISSES: return "branch misses";
+            case Event::L1D_MISSES: return "L1d misses";
+        }
+
+        return "unknown";
+    }
+
+    double HardwareCounters::Reading::per_operation(Event event) const {
+        return !has(event) || operations == 0 ? 0.0 : static_cast<double>(count(event)) / operations;
+    }
+
+    void HardwareCounters::Reading::add(const Reading& other) {
+        for (std::size_t i {0}; i < EVENTS; ++i) {
+            available[i] = available[i] || other.available[i];
+            counts[i] += other.counts[i];
+        }
+
+        operations += other.operations;
+    }
+
+    void HardwareCounters::Reading::report(std::ostream& stream, const char* operation) const {
+        std::ios::fmtflags flags {stream.flags()};
+        stream << std::fixed << std::setprecision(3);
+        bool any {false};
+        for (std::size_t i {0}; i < EVENTS; ++i) {
+            if (!available[i]) continue;
+            stream << (any ? ", " : "") << per_operation(static_cast<Event>(i)) << ' ' << name(static_cast<Event>(i));
+            any = true;
+        }
+
+        if (any) stream << " per " << operation << '.' << std::endl;
+        else stream << "No hardware counters available." << std::endl;
+        stream.flags(flags);
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef CH8_HARDWARE_HPP
+#define CH8_HARDWARE_HPP
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include "definitions.hpp"
+
+namespace ch8 {
+    // Host CPU counters from perf_event_open, for the calling thread and only in user space.
+    // Anything the kernel or machine won't count (not Linux, no PMU in a VM, perf_event_paranoid)
+    // is just unavailable, so runs never fail because of them.
+    class HardwareCounters {
+    public:
+        enum class Event { CYCLES, INSTRUCTIONS, BRANCH_MISSES, L1D_MISSES };
+        static constexpr std::size_t EVENTS {4};
+
+        // What was counted while running some number of emulated instructions, or iterations.
+        struct Reading {
+            std::array<std::uint64_t, EVENTS> counts {{}}; // Scaled up if the kernel had to multiplex.
+            std::array<bool, EVENTS> available {{}};
+            std::uint64_t operations {0};
+
+            std::uint64_t count(Event event) const { return counts[static_cast<std::size_t>(event)]; }
+            bool has(Event event) const { return available[static_cast<std::size_t>(event)]; }
+            double per_operation(Event) const; // Zero if unavailable or nothing ran.
+            void add(const Reading&); // Sums, for totals over runs or threads.
+            void report(std::ostream&, const char*) const; // One line, operations named by the second argument.
+        };
+
+        HardwareCounters();
+        ~HardwareCounters();
+        HardwareCounters(const HardwareCounters&) = delete;
+        HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+        bool available() const; // At least one event is being counted.
+        void start(); // Counts accumulate over every start() and stop() pair.
+        void stop();
+        void operations(std::uint64_t count) { executed += count; }
+        Reading read() const;
+        static const char* name(Event);
+
+    private:
+        std::array<int, EVENTS> descriptors;
+        std::uint64_t executed {0};
+    };
+}
+
+#endif
@@ -0,0 +1,47 @@
+#include <sstream>
+#include "catch.hpp"
+#include "hardware.hpp"
+
+// Whether anything gets counted depends on the kernel and machine, so only what has
+// to hold either way is checked, plus actual counts when they're there.
+TEST_CASE("Hardware counters are counted only between starts and stops.", "[hardware]") {
+    ch8::HardwareCounters counters;
+    volatile unsigned sink {0};
+    for (unsigned i {0}; i < 100000; ++i) sink = sink + i; // Not counted.
+    counters.start();
+    for (unsigned i {0}; i < 100000; ++i) sink = sink + i;
+    counters.stop();
+    counters.operations(100000);
+
+    ch8::HardwareCounters::Reading reading {counters.read()};
+    REQUIRE(reading.operations == 100000);
+    if (reading.has(ch8::HardwareCounters::Event::INSTRUCTIONS)) {
+        REQUIRE(reading.count(ch8::HardwareCounters::Event::INSTRUCTIONS) >= 100000);
+        REQUIRE(reading.per_operation(ch8::HardwareCounters::Event::INSTRUCTIONS) >= 1.0);
+        REQUIRE(reading.count(ch8::HardwareCounters::Event::INSTRUCTIONS) < 100000 * 100);
+    } else REQUIRE(reading.per_operation(ch8::HardwareCounters::Event::INSTRUCTIONS) == 0.0);
+    REQUIRE(counters.available() == (reading.has(ch8::HardwareCounters::Event::CYCLES) ||
+                                     reading.has(ch8::HardwareCounters::Event::INSTRUCTIONS) ||
+                                     reading.has(ch8::HardwareCounters::Event::BRANCH_MISSES) ||
+                                     reading.has(ch8::HardwareCounters::Event::L1D_MISSES)));
+}
+
+TEST_CASE("Hardware counter readings add up and report per operation.", "[hardware]") {
+    ch8::HardwareCounters::Reading total, reading;
+    reading.available[static_cast<std::size_t>(ch8::HardwareCounters::Event::BRANCH_MISSES)] = true;
+    reading.counts[static_cast<std::size_t>(ch8::HardwareCounters::Event::BRANCH_MISSES)] = 5;
+    reading.operations = 20;
+    total.add(reading);
+    total.add(reading);
+    REQUIRE(total.operations == 40);
+    REQUIRE(total.count(ch8::HardwareCounters::Event::BRANCH_MISSES) == 10);
+    REQUIRE(total.per_operation(ch8::HardwareCounters::Event::BRANCH_MISSES) == Approx(0.25));
+    REQUIRE_FALSE(total.has(ch8::HardwareCounters::Event::CYCLES));
+
+    std::ostringstream stream;
+    total.report(stream, "dispatch");
+    REQUIRE(stream.str() == "0.250 branch misses per dispatch.\n");
+    stream.str("");
+    ch8::HardwareCounters::Reading {}.report(stream, "dispatch");
+    REQUIRE(stream.str() == "No hardware counters available.\n");
+}
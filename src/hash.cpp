@@ -0,0 +1,74 @@
+#include "hash.hpp"
+
+namespace ch8 {
+    namespace {
+        constexpr std::uint64_t XXH_PRIME1 {0x9E3779B185EBCA87};
+        constexpr std::uint64_t XXH_PRIME2 {0xC2B2AE3D27D4EB4F};
+        constexpr std::uint64_t XXH_PRIME3 {0x165667B19E3779F9};
+        constexpr std::uint64_t XXH_PRIME4 {0x85EBCA77C2B2AE63};
+        constexpr std::uint64_t XXH_PRIME5 {0x27D4EB2F165667C5};
+
+        std::uint64_t rotate_left(std::uint64_t value, int amount) { return (value << amount) | (value >> (64 - amount)); }
+        std::uint64_t read64(const byte* data) { // Little endian, regardless of the host.
+            std::uint64_t value {0};
+            for (int i {7}; i >= 0; --i) value = (value << 8) | data[i];
+            return value;
+        }
+
+        std::uint64_t read32(const byte* data) {
+            return static_cast<std::uint64_t>(data[0]) | static_cast<std::uint64_t>(data[1]) << 8 |
+                   static_cast<std::uint64_t>(data[2]) << 16 | static_cast<std::uint64_t>(data[3]) << 24;
+        }
+
+        std::uint64_t xxh_round(std::uint64_t accumulator, std::uint64_t input) {
+            accumulator += input * XXH_PRIME2;
+            return rotate_left(accumulator, 31) * XXH_PRIME1;
+        }
+
+        std::uint64_t xxh_merge(std::uint64_t accumulator, std::uint64_t value) {
+            accumulator ^= xxh_round(0, value);
+            return accumulator * XXH_PRIME1 + XXH_PRIME4;
+        }
+    }
+
+    constexpr std::uint64_t Hash::FNV_BASIS;
+    constexpr std::uint64_t Hash::FNV_PRIME;
+    std::uint64_t Hash::fnv1a(const byte* data, std::size_t size, std::uint64_t hash) {
+        for (std::size_t i {0}; i < size; ++i) {
+            hash ^= data[i];
+            hash *= FNV_PRIME;
+        }
+
+        return hash;
+    }
+
+    std::uint64_t Hash::xxh64(const byte* data, std::size_t size, std::uint64_t seed) {
+        const byte* end {data + size};
+        std::uint64_t hash;
+        if (size >= 32) {
+            std::uint64_t v1 {seed + XXH_PRIME1 + XXH_PRIME2}, v2 {seed + XXH_PRIME2};
+            std::uint64_t v3 {seed}, v4 {seed - XXH_PRIME1};
+            for (; data + 32 <= end; data += 32) {
+                v1 = xxh_round(v1, read64(data));
+                v2 = xxh_round(v2, read64(data + 8));
+                v3 = xxh_round(v3, read64(data + 16));
+                v4 = xxh_round(v4, read64(data + 24));
+            }
+
+            hash = rotate_left(v1, 1) + rotate_left(v2, 7) + rotate_left(v3, 12) + rotate_left(v4, 18);
+            hash = xxh_merge(xxh_merge(xxh_merge(xxh_merge(hash, v1), v2), v3), v4);
+        } else hash = seed + XXH_PRIME5;
+
+        hash += size;
+        for (; data + 8 <= end; data += 8) hash = rotate_left(hash ^ xxh_round(0, read64(data)), 27) * XXH_PRIME1 + XXH_PRIME4;
+        for (; data + 4 <= end; data += 4) hash = rotate_left(hash ^ (read32(data) * XXH_PRIME1), 23) * XXH_PRIME2 + XXH_PRIME3;
+        for (; data < end; ++data) hash = rotate_left(hash ^ (*data * XXH_PRIME5), 11) * XXH_PRIME1;
+
+        hash ^= hash >> 33;
+        hash *= XXH_PRIME2;
+        hash ^= hash >> 29;
+        hash *= XXH_PRIME3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef CH8_HASH_HPP
+#define CH8_HASH_HPP
+
+#include <cstdint>
+#include "definitions.hpp"
+
+namespace ch8 {
+    class Hash {
+    public:
+        // 64-bit FNV-1a, cheap and good enough for telling machine states apart. The last
+        // argument allows chaining several buffers together, pass the previous hash there.
+        static std::uint64_t fnv1a(const byte*, std::size_t, std::uint64_t = FNV_BASIS);
+        // 64-bit xxHash (XXH64), used for identifying ROMs. Much better distributed than the
+        // above, which matters when tens of thousands of ROMs are looked up by their hash.
+        static std::uint64_t xxh64(const byte*, std::size_t, std::uint64_t = 0);
+
+        static constexpr std::uint64_t FNV_BASIS {0xCBF29CE484222325};
+        static constexpr std::uint64_t FNV_PRIME {0x00000100000001B3};
+    };
+}
+
+#endif
@@ -0,0 +1,30 @@
+#include "catch.hpp"
+#include "hash.hpp"
+#include <cstring>
+#include <vector>
+
+namespace {
+    std::uint64_t xxh64(const char* text, std::uint64_t seed = 0) {
+        return ch8::Hash::xxh64(reinterpret_cast<const ch8::byte*>(text), std::strlen(text), seed);
+    }
+}
+
+TEST_CASE("XXH64 matches the reference implementation.", "[hash, xxh64]") {
+    REQUIRE(xxh64("") == 0xEF46DB3751D8E999ull);
+    REQUIRE(xxh64("abc") == 0x44BC2CF5AD770999ull);
+    REQUIRE(xxh64("The quick brown fox jumps over the lazy dog") == 0x0B242D361FDA71BCull); // Stripes, then a tail.
+    REQUIRE(xxh64("abc", 0x9E3779B97F4A7C15ull) == 0x2ED0F59D6B43AC8Bull);
+
+    std::vector<ch8::byte> counting(100);
+    for (std::size_t i {0}; i < counting.size(); ++i) counting[i] = static_cast<ch8::byte>(i);
+    REQUIRE(ch8::Hash::xxh64(counting.data(), counting.size()) == 0x6AC1E58032166597ull); // Every kind of tail.
+}
+
+TEST_CASE("FNV-1a matches the reference implementation.", "[hash, fnv1a]") {
+    REQUIRE(ch8::Hash::fnv1a(nullptr, 0) == ch8::Hash::FNV_BASIS);
+    const ch8::byte a[] = {'a'};
+    REQUIRE(ch8::Hash::fnv1a(a, 1) == 0xAF63DC4C8601EC8Cull);
+
+    const ch8::byte ab[] = {'a', 'b'};
+    REQUIRE(ch8::Hash::fnv1a(ab + 1, 1, ch8::Hash::fnv1a(ab, 1)) == ch8::Hash::fnv1a(ab, 2)); // Chained.
+}
@@ -0,0 +1,75 @@
+#include "histogram.hpp"
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
+
+namespace ch8 {
+    namespace {
+        unsigned most_significant_bit(std::uint64_t value) {
+            unsigned bit {0};
+            while (value >>= 1) ++bit;
+            return bit;
+        }
+    }
+
+    constexpr unsigned Histogram::SUB_BUCKET_BITS;
+    constexpr std::size_t Histogram::SUB_BUCKETS;
+    Histogram::Histogram() : counts(bucket(UINT64_MAX) + 1) {}
+
+    std::size_t Histogram::bucket(std::uint64_t value) {
+        if (value < 2 * SUB_BUCKETS) return value;
+        unsigned shift {most_significant_bit(value) - SUB_BUCKET_BITS}; // Leaves SUB_BUCKET_BITS + 1 bits, the top one set.
+        return shift * SUB_BUCKETS + (value >> shift);
+    }
+
+    std::uint64_t Histogram::highest(std::size_t index) {
+        if (index < 2 * SUB_BUCKETS) return index;
+        std::size_t shift {index / SUB_BUCKETS - 1};
+        std::uint64_t lowest {static_cast<std::uint64_t>(index % SUB_BUCKETS + SUB_BUCKETS) << shift};
+        return lowest + ((std::uint64_t {1} << shift) - 1);
+    }
+
+    void Histogram::record(std::uint64_t value) {
+        ++counts[bucket(value)];
+        ++recorded;
+        total += value;
+        smallest = std::min(smallest, value);
+        largest = std::max(largest, value);
+    }
+
+    void Histogram::add(const Histogram& other) {
+        for (std::size_t i {0}; i < counts.size(); ++i) counts[i] += other.counts[i];
+        recorded += other.recorded;
+        total += other.total;
+        smallest = std::min(smallest, other.smallest);
+        largest = std::max(largest, other.largest);
+    }
+
+    void Histogram::reset() {
+        std::fill(counts.begin(), counts.end(), 0);
+        recorded = total = largest = 0;
+        smallest = UINT64_MAX;
+    }
+
+    std::uint64_t Histogram::percentile(double percent) const {
+        if (recorded == 0) return 0;
+        std::uint64_t rank {static_cast<std::uint64_t>(std::ceil(std::min(std::max(percent, 0.0), 100.0) / 100.0 * recorded))};
+        std::uint64_t seen {0};
+        for (std::size_t i {0}; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= std::max<std::uint64_t>(rank, 1)) return std::min(highest(i), largest);
+        }
+
+        return largest;
+    }
+
+    void Histogram::report(std::ostream& stream, const std::string& name, double scale, const std::string& unit) const {
+        std::ios::fmtflags flags {stream.flags()};
+        stream << std::fixed << std::setprecision(1) << name << ": " << recorded << " samples";
+        const double percents[] = {50.0, 90.0, 99.0, 99.9};
+        const char* names[] = {"p50", "p90", "p99", "p99.9"};
+        for (std::size_t i {0}; i < 4; ++i) stream << ", " << names[i] << ' ' << percentile(percents[i]) / scale;
+        stream << ", max " << maximum() / scale << (unit.empty() ? "" : " ") << unit << std::endl;
+        stream.flags(flags);
+    }
+}
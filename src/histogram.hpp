@@ -0,0 +1,45 @@
+#ifndef CH8_HISTOGRAM_HPP
+#define CH8_HISTOGRAM_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include "definitions.hpp"
+
+namespace ch8 {
+    // Counts values over the whole 64-bit range with bounded relative error, like HDR histograms:
+    // values below 2 * SUB_BUCKETS are exact, above that each power of two is split into
+    // SUB_BUCKETS buckets, so percentiles are within 1 / SUB_BUCKETS of the truth. Recording is
+    // a couple of shifts and an increment, cheap enough for every frame or every key press.
+    class Histogram {
+    public:
+        static constexpr unsigned SUB_BUCKET_BITS {7};
+        static constexpr std::size_t SUB_BUCKETS {std::size_t {1} << SUB_BUCKET_BITS};
+
+        Histogram();
+        void record(std::uint64_t);
+        void add(const Histogram&);
+        void reset();
+
+        std::uint64_t count() const { return recorded; }
+        std::uint64_t minimum() const { return recorded == 0 ? 0 : smallest; }
+        std::uint64_t maximum() const { return largest; }
+        double mean() const { return recorded == 0 ? 0.0 : static_cast<double>(total) / recorded; }
+        std::uint64_t percentile(double) const; // From 0 to 100, as the largest value of its bucket.
+
+        // "<name>: <count> samples, p50 <x>, p90 <x>, p99 <x>, p99.9 <x>, max <x> <unit>",
+        // where every value is divided by the scale first, e.g. 1000 for nanoseconds in µs.
+        void report(std::ostream&, const std::string&, double = 1.0, const std::string& = "") const;
+
+        static std::size_t bucket(std::uint64_t); // Index of the bucket a value goes in.
+        static std::uint64_t highest(std::size_t); // Largest value that goes in a bucket.
+
+    private:
+        std::vector<std::uint64_t> counts;
+        std::uint64_t recorded {0}, total {0};
+        std::uint64_t smallest {UINT64_MAX}, largest {0};
+    };
+}
+
+#endif
@@ -0,0 +1,54 @@
+#include <sstream>
+#include "catch.hpp"
+#include "histogram.hpp"
+
+TEST_CASE("Histogram buckets are contiguous and within their relative error.", "[histogram]") {
+    REQUIRE(ch8::Histogram::bucket(0) == 0);
+    REQUIRE(ch8::Histogram::bucket(255) == 255);
+    REQUIRE(ch8::Histogram::highest(255) == 255);
+    for (std::size_t index {1}; index <= ch8::Histogram::bucket(UINT64_MAX); ++index) {
+        std::uint64_t lowest {ch8::Histogram::highest(index - 1) + 1};
+        REQUIRE(ch8::Histogram::bucket(lowest) == index);
+        REQUIRE(ch8::Histogram::bucket(ch8::Histogram::highest(index)) == index);
+        REQUIRE((ch8::Histogram::highest(index) - lowest) <= lowest / ch8::Histogram::SUB_BUCKETS);
+    }
+
+    REQUIRE(ch8::Histogram::highest(ch8::Histogram::bucket(UINT64_MAX)) == UINT64_MAX);
+}
+
+TEST_CASE("Histograms give percentiles, extremes and means.", "[histogram]") {
+    ch8::Histogram histogram;
+    REQUIRE(histogram.percentile(50.0) == 0);
+    REQUIRE(histogram.minimum() == 0);
+    for (std::uint64_t value {1}; value <= 1000; ++value) histogram.record(value * 1000);
+
+    REQUIRE(histogram.count() == 1000);
+    REQUIRE(histogram.minimum() == 1000);
+    REQUIRE(histogram.maximum() == 1000000);
+    REQUIRE(histogram.mean() == Approx(500500.0));
+    REQUIRE(histogram.percentile(50.0) >= 500000);
+    REQUIRE(histogram.percentile(50.0) <= 500000 + 500000 / ch8::Histogram::SUB_BUCKETS);
+    REQUIRE(histogram.percentile(99.0) >= 990000);
+    REQUIRE(histogram.percentile(99.0) <= 990000 + 990000 / ch8::Histogram::SUB_BUCKETS);
+    REQUIRE(histogram.percentile(100.0) == 1000000);
+    REQUIRE(histogram.percentile(0.0) >= 1000);
+    REQUIRE(histogram.percentile(0.0) <= 1000 + 1000 / ch8::Histogram::SUB_BUCKETS);
+
+    ch8::Histogram other;
+    other.record(5);
+    other.add(histogram);
+    REQUIRE(other.count() == 1001);
+    REQUIRE(other.minimum() == 5);
+    REQUIRE(other.maximum() == 1000000);
+    other.reset();
+    REQUIRE(other.count() == 0);
+    REQUIRE(other.maximum() == 0);
+}
+
+TEST_CASE("Histogram reports are scaled to the unit given.", "[histogram]") {
+    ch8::Histogram histogram;
+    for (int i {0}; i < 10; ++i) histogram.record(2000);
+    std::ostringstream stream;
+    histogram.report(stream, "present", 1000.0, "us");
+    REQUIRE(stream.str() == "present: 10 samples, p50 2.0, p90 2.0, p99 2.0, p99.9 2.0, max 2.0 us\n");
+}
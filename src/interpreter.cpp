@@ -1,19 +1,33 @@
 #include "interpreter.hpp"
+#include <cstdio>
 
 namespace ch8 {
     Instruction Interpreter::parse(byte inst_upper, byte inst_lower) {
+        Instruction instruction {decode(inst_upper, inst_lower)};
+        if (instruction == Instruction::INVALID) throw std::runtime_error {"Couldn't parse instruction."};
+        return instruction;
+    }
+
+    Instruction Interpreter::decode(byte inst_upper, byte inst_lower) {
         byte upper_identifier = inst_upper >> 4; // First nibble never has mangled arguments.
         byte lower_identifier = inst_lower & 0x0F; // Last nibble identifies variants of inst.
 
         if (inst_upper == 0x00 && inst_lower == 0xFD) return Instruction::EXIT;
         else if (inst_upper == 0x00 && inst_lower == 0xE0) return Instruction::CLS;
         else if (inst_upper == 0x00 && inst_lower == 0xEE) return Instruction::RET;
+        else if (inst_upper == 0x00 && (inst_lower & 0xF0) == 0xC0) return Instruction::SCD_C;
+        else if (inst_upper == 0x00 && inst_lower == 0xFB) return Instruction::SCR;
+        else if (inst_upper == 0x00 && inst_lower == 0xFC) return Instruction::SCL;
+        else if (inst_upper == 0x00 && inst_lower == 0xFE) return Instruction::LOW;
+        else if (inst_upper == 0x00 && inst_lower == 0xFF) return Instruction::HIGH;
         else if (upper_identifier == 0x00) return Instruction::SYS_A;
         else if (upper_identifier == 0x01) return Instruction::JP_A;
         else if (upper_identifier == 0x02) return Instruction::CALL_A;
         else if (upper_identifier == 0x03) return Instruction::SE_RC;
         else if (upper_identifier == 0x04) return Instruction::SNE_RC;
         else if (upper_identifier == 0x05 && lower_identifier == 0x00) return Instruction::SE_RR;
+        else if (upper_identifier == 0x05 && lower_identifier == 0x02) return Instruction::SAVE_RR;
+        else if (upper_identifier == 0x05 && lower_identifier == 0x03) return Instruction::LOAD_RR;
         else if (upper_identifier == 0x06) return Instruction::LD_RC;
         else if (upper_identifier == 0x07) return Instruction::ADD_RC;
         else if (upper_identifier == 0x08 && lower_identifier == 0x00) return Instruction::LD_RR;
@@ -32,16 +46,20 @@ namespace ch8 {
         else if (upper_identifier == 0x0D) return Instruction::DRW_RRC;
         else if (upper_identifier == 0x0E && inst_lower == 0x9E) return Instruction::SKP_R;
         else if (upper_identifier == 0x0E && inst_lower == 0xA1) return Instruction::SKNP_R;
+        else if (inst_upper == 0xF0 && inst_lower == 0x00) return Instruction::LD_IL;
+        else if (inst_upper == 0xF0 && inst_lower == 0x02) return Instruction::AUDIO;
+        else if (upper_identifier == 0x0F && inst_lower == 0x01) return Instruction::PLANE_C;
         else if (upper_identifier == 0x0F && inst_lower == 0x07) return Instruction::LD_RD;
         else if (upper_identifier == 0x0F && inst_lower == 0x0A) return Instruction::LD_RK;
         else if (upper_identifier == 0x0F && inst_lower == 0x15) return Instruction::LD_DR;
         else if (upper_identifier == 0x0F && inst_lower == 0x18) return Instruction::LD_SR;
         else if (upper_identifier == 0x0F && inst_lower == 0x1E) return Instruction::ADD_IR;
         else if (upper_identifier == 0x0F && inst_lower == 0x29) return Instruction::LD_FR;
+        else if (upper_identifier == 0x0F && inst_lower == 0x3A) return Instruction::PITCH_R;
         else if (upper_identifier == 0x0F && inst_lower == 0x33) return Instruction::LD_BR;
         else if (upper_identifier == 0x0F && inst_lower == 0x55) return Instruction::LD_IAR;
         else if (upper_identifier == 0x0F && inst_lower == 0x65) return Instruction::LD_RAI;
-        else throw std::runtime_error {"Couldn't parse instruction."};
+        else return Instruction::INVALID;
     }
 
     word Interpreter::parse_argument(Argument arg, byte inst_upper, byte inst_lower) {
@@ -55,6 +73,86 @@ namespace ch8 {
         return 0xC0DE;
     }
 
+    const char* Interpreter::name(Instruction instruction) {
+        static const char* const names[] = {
+            "SYS_A", "CLS", "RET", "JP_A", "CALL_A", "SE_RC",
+            "SNE_RC", "SE_RR", "LD_RC", "ADD_RC", "LD_RR",
+            "OR_RR", "AND_RR", "XOR_RR", "ADD_RR", "SUB_RR",
+            "SHR_RR", "SUBN_RR", "SHL_RR", "SNE_RR", "LD_IA",
+            "JP_V0A", "RND_RC", "DRW_RRC", "SKP_R", "SKNP_R",
+            "LD_RD", "LD_RK", "LD_DR", "LD_SR", "ADD_IR", "LD_FR",
+            "LD_BR", "LD_IAR", "LD_RAI", "EXIT",
+            "SCD_C", "SCR", "SCL", "LOW", "HIGH",
+            "SAVE_RR", "LOAD_RR", "LD_IL", "PLANE_C", "AUDIO", "PITCH_R",
+            "INVALID"
+        };
+
+        static_assert(sizeof(names) / sizeof(names[0]) == static_cast<std::size_t>(Instruction::INVALID) + 1,
+                      "Every instruction needs a name.");
+        return names[static_cast<std::size_t>(instruction)];
+    }
+
+    std::string Interpreter::disassemble(byte inst_upper, byte inst_lower) {
+        unsigned x {parse_argument(Argument::X, inst_upper, inst_lower)};
+        unsigned y {parse_argument(Argument::Y, inst_upper, inst_lower)};
+        unsigned address {parse_argument(Argument::ADDRESS, inst_upper, inst_lower)};
+        unsigned constant {parse_argument(Argument::CONSTANT, inst_upper, inst_lower)};
+
+        char text[24];
+        switch (decode(inst_upper, inst_lower)) {
+        case Instruction::SYS_A: std::snprintf(text, sizeof(text), "SYS 0x%03X", address); break;
+        case Instruction::CLS: return "CLS";
+        case Instruction::RET: return "RET";
+        case Instruction::JP_A: std::snprintf(text, sizeof(text), "JP 0x%03X", address); break;
+        case Instruction::CALL_A: std::snprintf(text, sizeof(text), "CALL 0x%03X", address); break;
+        case Instruction::SE_RC: std::snprintf(text, sizeof(text), "SE V%X, 0x%02X", x, constant); break;
+        case Instruction::SNE_RC: std::snprintf(text, sizeof(text), "SNE V%X, 0x%02X", x, constant); break;
+        case Instruction::SE_RR: std::snprintf(text, sizeof(text), "SE V%X, V%X", x, y); break;
+        case Instruction::LD_RC: std::snprintf(text, sizeof(text), "LD V%X, 0x%02X", x, constant); break;
+        case Instruction::ADD_RC: std::snprintf(text, sizeof(text), "ADD V%X, 0x%02X", x, constant); break;
+        case Instruction::LD_RR: std::snprintf(text, sizeof(text), "LD V%X, V%X", x, y); break;
+        case Instruction::OR_RR: std::snprintf(text, sizeof(text), "OR V%X, V%X", x, y); break;
+        case Instruction::AND_RR: std::snprintf(text, sizeof(text), "AND V%X, V%X", x, y); break;
+        case Instruction::XOR_RR: std::snprintf(text, sizeof(text), "XOR V%X, V%X", x, y); break;
+        case Instruction::ADD_RR: std::snprintf(text, sizeof(text), "ADD V%X, V%X", x, y); break;
+        case Instruction::SUB_RR: std::snprintf(text, sizeof(text), "SUB V%X, V%X", x, y); break;
+        case Instruction::SHR_RR: std::snprintf(text, sizeof(text), "SHR V%X, V%X", x, y); break;
+        case Instruction::SUBN_RR: std::snprintf(text, sizeof(text), "SUBN V%X, V%X", x, y); break;
+        case Instruction::SHL_RR: std::snprintf(text, sizeof(text), "SHL V%X, V%X", x, y); break;
+        case Instruction::SNE_RR: std::snprintf(text, sizeof(text), "SNE V%X, V%X", x, y); break;
+        case Instruction::LD_IA: std::snprintf(text, sizeof(text), "LD I, 0x%03X", address); break;
+        case Instruction::JP_V0A: std::snprintf(text, sizeof(text), "JP V0, 0x%03X", address); break;
+        case Instruction::RND_RC: std::snprintf(text, sizeof(text), "RND V%X, 0x%02X", x, constant); break;
+        case Instruction::DRW_RRC: std::snprintf(text, sizeof(text), "DRW V%X, V%X, %u", x, y, constant & 0x0F); break;
+        case Instruction::SKP_R: std::snprintf(text, sizeof(text), "SKP V%X", x); break;
+        case Instruction::SKNP_R: std::snprintf(text, sizeof(text), "SKNP V%X", x); break;
+        case Instruction::LD_RD: std::snprintf(text, sizeof(text), "LD V%X, DT", x); break;
+        case Instruction::LD_RK: std::snprintf(text, sizeof(text), "LD V%X, K", x); break;
+        case Instruction::LD_DR: std::snprintf(text, sizeof(text), "LD DT, V%X", x); break;
+        case Instruction::LD_SR: std::snprintf(text, sizeof(text), "LD ST, V%X", x); break;
+        case Instruction::ADD_IR: std::snprintf(text, sizeof(text), "ADD I, V%X", x); break;
+        case Instruction::LD_FR: std::snprintf(text, sizeof(text), "LD F, V%X", x); break;
+        case Instruction::LD_BR: std::snprintf(text, sizeof(text), "LD B, V%X", x); break;
+        case Instruction::LD_IAR: std::snprintf(text, sizeof(text), "LD [I], V%X", x); break;
+        case Instruction::LD_RAI: std::snprintf(text, sizeof(text), "LD V%X, [I]", x); break;
+        case Instruction::EXIT: return "EXIT";
+        case Instruction::SCD_C: std::snprintf(text, sizeof(text), "SCD %u", constant & 0x0F); break;
+        case Instruction::SCR: return "SCR";
+        case Instruction::SCL: return "SCL";
+        case Instruction::LOW: return "LOW";
+        case Instruction::HIGH: return "HIGH";
+        case Instruction::SAVE_RR: std::snprintf(text, sizeof(text), "SAVE V%X-V%X", x, y); break;
+        case Instruction::LOAD_RR: std::snprintf(text, sizeof(text), "LOAD V%X-V%X", x, y); break;
+        case Instruction::LD_IL: return "LD I, LONG"; // The address is in the next word.
+        case Instruction::PLANE_C: std::snprintf(text, sizeof(text), "PLANE %u", x); break;
+        case Instruction::AUDIO: return "AUDIO";
+        case Instruction::PITCH_R: std::snprintf(text, sizeof(text), "PITCH V%X", x); break;
+        default: std::snprintf(text, sizeof(text), "DW 0x%02X%02X", inst_upper, inst_lower); break; // Data, not code.
+        }
+
+        return text;
+    }
+
     constexpr byte Interpreter::font[FONT_SIZE];
     const byte* Interpreter::retrieve_font() {
         return font;
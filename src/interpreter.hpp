@@ -1,6 +1,7 @@
 #ifndef CH8_INTERPRETER_HPP
 #define CH8_INTERPRETER_HPP
 
+#include <string>
 #include <stdexcept>
 #include "definitions.hpp"
 
@@ -15,7 +16,10 @@ namespace ch8 {
         SHR_RR, SUBN_RR, SHL_RR, SNE_RR, LD_IA,
         JP_V0A, RND_RC, DRW_RRC, SKP_R, SKNP_R,
         LD_RD, LD_RK, LD_DR, LD_SR, ADD_IR, LD_FR,
-        LD_BR, LD_IAR, LD_RAI, EXIT
+        LD_BR, LD_IAR, LD_RAI, EXIT,
+        SCD_C, SCR, SCL, LOW, HIGH, // SUPER-CHIP, plain SYS in profiles without its screen.
+        SAVE_RR, LOAD_RR, LD_IL, PLANE_C, AUDIO, PITCH_R, // XO-CHIP, invalid in other profiles. LD_IL's address is the word after it.
+        INVALID // Not an instruction, the processor traps on these.
     };
 
     // Possible argumemnts to retrieve from instructiion.
@@ -26,8 +30,11 @@ namespace ch8 {
 
     class Interpreter {
     public:
-        static Instruction parse(byte, byte); // Parses upper and lower byte of instruction.
+        static Instruction parse(byte, byte); // Parses upper and lower byte of instruction. Throws if invalid.
+        static Instruction decode(byte, byte); // Same as above, but gives INVALID instead of throwing.
         static word parse_argument(Argument, byte, byte); // Retrieves argument given to instruction.
+        static const char* name(Instruction); // Same as the enumerator, e.g. "DRW_RRC".
+        static std::string disassemble(byte, byte); // Assembly of an instruction, e.g. "DRW V0, V1, 5".
         static const byte* retrieve_font(); // Retrieves font for keyboard. A total of 8x5x16 bytes.
 
         static constexpr std::size_t FONTS {16};
@@ -41,6 +41,29 @@ TEST_CASE("Parsing instructions.", "[interpreter, instruction_parser]") {
     REQUIRE(ch8::Interpreter::parse(0xFB, 0x33) == ch8::Instruction::LD_BR);
     REQUIRE(ch8::Interpreter::parse(0xFB, 0x55) == ch8::Instruction::LD_IAR);
     REQUIRE(ch8::Interpreter::parse(0xFB, 0x65) == ch8::Instruction::LD_RAI);
+
+    REQUIRE(ch8::Interpreter::parse(0x00, 0xC5) == ch8::Instruction::SCD_C);
+    REQUIRE(ch8::Interpreter::parse(0x00, 0xFB) == ch8::Instruction::SCR);
+    REQUIRE(ch8::Interpreter::parse(0x00, 0xFC) == ch8::Instruction::SCL);
+    REQUIRE(ch8::Interpreter::parse(0x00, 0xFE) == ch8::Instruction::LOW);
+    REQUIRE(ch8::Interpreter::parse(0x00, 0xFF) == ch8::Instruction::HIGH);
+    REQUIRE(ch8::Interpreter::parse(0x00, 0xFA) == ch8::Instruction::SYS_A);
+
+    REQUIRE(ch8::Interpreter::parse(0x51, 0x32) == ch8::Instruction::SAVE_RR);
+    REQUIRE(ch8::Interpreter::parse(0x51, 0x33) == ch8::Instruction::LOAD_RR);
+    REQUIRE(ch8::Interpreter::parse(0xF0, 0x00) == ch8::Instruction::LD_IL);
+    REQUIRE(ch8::Interpreter::parse(0xF2, 0x01) == ch8::Instruction::PLANE_C);
+    REQUIRE(ch8::Interpreter::parse(0xF0, 0x02) == ch8::Instruction::AUDIO);
+    REQUIRE(ch8::Interpreter::parse(0xF4, 0x3A) == ch8::Instruction::PITCH_R);
+}
+
+TEST_CASE("Decoding invalid instructions.", "[interpreter, instruction_decoder]") {
+    REQUIRE(ch8::Interpreter::decode(0xFB, 0x65) == ch8::Instruction::LD_RAI);
+    REQUIRE(ch8::Interpreter::decode(0xFF, 0xFF) == ch8::Instruction::INVALID);
+    REQUIRE(ch8::Interpreter::decode(0x51, 0x21) == ch8::Instruction::INVALID); // SE with a variant nibble.
+    REQUIRE(ch8::Interpreter::decode(0xF1, 0x00) == ch8::Instruction::INVALID); // Only F000 is followed by an address.
+    REQUIRE(ch8::Interpreter::decode(0xF1, 0x02) == ch8::Instruction::INVALID); // Same for F002.
+    REQUIRE_THROWS_AS(ch8::Interpreter::parse(0xFF, 0xFF), const std::runtime_error&);
 }
 
 TEST_CASE("Parsing arguments for instruction.", "[interpretr, argument_parser]") {
@@ -50,3 +73,19 @@ TEST_CASE("Parsing arguments for instruction.", "[interpretr, argument_parser]")
     REQUIRE(ch8::Interpreter::parse_argument(ch8::Argument::X, 0xCA, 0xBC) == 0x0A); // RND ->VA, 0xBC.
     REQUIRE(ch8::Interpreter::parse_argument(ch8::Argument::CONSTANT, 0xCA, 0xBC) == 0xBC); // RND VA, ->0xBC.
 }
+
+TEST_CASE("Disassembling instructions.", "[interpreter, disassembler]") {
+    REQUIRE(ch8::Interpreter::disassemble(0x00, 0xE0) == "CLS");
+    REQUIRE(ch8::Interpreter::disassemble(0x22, 0xA4) == "CALL 0x2A4");
+    REQUIRE(ch8::Interpreter::disassemble(0x3A, 0x05) == "SE VA, 0x05");
+    REQUIRE(ch8::Interpreter::disassemble(0x81, 0x2E) == "SHL V1, V2");
+    REQUIRE(ch8::Interpreter::disassemble(0xD0, 0x15) == "DRW V0, V1, 5");
+    REQUIRE(ch8::Interpreter::disassemble(0xF3, 0x65) == "LD V3, [I]");
+    REQUIRE(ch8::Interpreter::disassemble(0xFF, 0xFF) == "DW 0xFFFF");
+    REQUIRE(ch8::Interpreter::disassemble(0x00, 0xC5) == "SCD 5");
+    REQUIRE(ch8::Interpreter::disassemble(0x00, 0xFF) == "HIGH");
+    REQUIRE(ch8::Interpreter::disassemble(0x52, 0x52) == "SAVE V2-V5");
+    REQUIRE(ch8::Interpreter::disassemble(0xF0, 0x00) == "LD I, LONG");
+    REQUIRE(ch8::Interpreter::disassemble(0xF3, 0x01) == "PLANE 3");
+    REQUIRE(std::string {ch8::Interpreter::name(ch8::Instruction::DRW_RRC)} == "DRW_RRC");
+}
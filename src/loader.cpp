@@ -0,0 +1,127 @@
+#include "loader.hpp"
+#include "archive.hpp"
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ch8 {
+    MappedFile::MappedFile(const std::string& path) {
+        int descriptor {::open(path.c_str(), O_RDONLY)};
+        if (descriptor == -1) throw std::runtime_error {"Couldn't open " + path + ": " + std::strerror(errno) + '.'};
+
+        struct stat status;
+        if (::fstat(descriptor, &status) == -1) {
+            ::close(descriptor);
+            throw std::runtime_error {"Couldn't stat " + path + ": " + std::strerror(errno) + '.'};
+        }
+
+        mapping_size = status.st_size;
+        if (mapping_size != 0) { // Can't map empty files, but an empty ROM is still a ROM.
+            void* address {::mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, descriptor, 0)};
+            if (address == MAP_FAILED) {
+                ::close(descriptor);
+                throw std::runtime_error {"Couldn't map " + path + ": " + std::strerror(errno) + '.'};
+            }
+
+            mapping = static_cast<const byte*>(address);
+        }
+
+        ::close(descriptor); // Mapping keeps its own reference to the file.
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : mapping {other.mapping}, mapping_size {other.mapping_size} {
+        other.mapping = nullptr;
+        other.mapping_size = 0;
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            if (mapping != nullptr) ::munmap(const_cast<byte*>(mapping), mapping_size);
+            mapping = other.mapping;
+            mapping_size = other.mapping_size;
+            other.mapping = nullptr;
+            other.mapping_size = 0;
+        }
+
+        return *this;
+    }
+
+    MappedFile::~MappedFile() {
+        if (mapping != nullptr) ::munmap(const_cast<byte*>(mapping), mapping_size);
+    }
+
+    Span MappedFile::span(std::size_t offset, std::size_t length) const {
+        if (offset > mapping_size || length > mapping_size - offset)
+            throw std::out_of_range {"Couldn't slice mapped file, span is outside of it."};
+        return Span {mapping + offset, length};
+    }
+
+    Loader::Loader() = default;
+    Loader::~Loader() = default;
+    const MappedFile& Loader::map(const std::string& path) {
+        std::lock_guard<std::mutex> guard {lock};
+        std::unique_ptr<MappedFile>& file = files[path];
+        if (!file) {
+            std::unique_ptr<MappedFile> mapped {new MappedFile {path}};
+            file = std::move(mapped); // Only stored if mapping worked.
+        }
+
+        return *file;
+    }
+
+    const Archive& Loader::archive(const std::string& path) {
+        std::lock_guard<std::mutex> guard {lock};
+        std::unique_ptr<Archive>& opened = archives[path];
+        if (!opened) {
+            std::unique_ptr<Archive> archive {new Archive {path}};
+            opened = std::move(archive);
+        }
+
+        return *opened;
+    }
+
+    namespace {
+        bool exists(const std::string& path) {
+            struct stat status;
+            return ::stat(path.c_str(), &status) == 0;
+        }
+    }
+
+    Span Loader::load(const std::string& reference) {
+        // Files named like references (game#2.ch8) are still just files, only what isn't one is looked into.
+        if (exists(reference)) return map(reference).span();
+        std::size_t hash {reference.rfind('#')};
+        if (hash != std::string::npos && exists(reference.substr(0, hash))) {
+            Span rom;
+            bool found;
+            std::string key {reference.substr(hash + 1)};
+            const Archive& archive {this->archive(reference.substr(0, hash))};
+            if (key.compare(0, 6, "xxh64:") == 0) {
+                char* end;
+                std::uint64_t value {std::strtoull(key.c_str() + 6, &end, 16)};
+                if (*end != '\0' || key.size() == 6) throw std::runtime_error {"Couldn't parse ROM reference " + reference + '.'};
+                found = archive.find(value, rom);
+            } else found = archive.find(key, rom);
+
+            if (!found) throw std::runtime_error {"Couldn't find ROM " + reference + '.'};
+            return rom;
+        }
+
+        std::size_t at {reference.rfind('@')};
+        if (at == std::string::npos || !exists(reference.substr(0, at))) return map(reference).span(); // Fails to open it.
+
+        // Packed ROM, both the offset and size can be either decimal or hex (0x).
+        char* end;
+        std::string location {reference.substr(at + 1)};
+        unsigned long long offset {std::strtoull(location.c_str(), &end, 0)};
+        if (*end != ':') throw std::runtime_error {"Couldn't parse ROM reference " + reference + '.'};
+        unsigned long long length {std::strtoull(end + 1, &end, 0)};
+        if (*end != '\0') throw std::runtime_error {"Couldn't parse ROM reference " + reference + '.'};
+        return map(reference.substr(0, at)).span(offset, length);
+    }
+}
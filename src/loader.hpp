@@ -0,0 +1,59 @@
+#ifndef CH8_LOADER_HPP
+#define CH8_LOADER_HPP
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <stdexcept>
+#include "definitions.hpp"
+
+namespace ch8 {
+    // Read-only memory mapping of a whole file. ROMs are tiny, so mapping them is
+    // mostly about skipping the read into a temporary buffer, Memory copies the
+    // program straight out of the page cache. Several ROMs can share a mapping.
+    class MappedFile {
+    public:
+        MappedFile() = default; // Nothing mapped, empty span.
+        explicit MappedFile(const std::string&); // Throws std::runtime_error if it can't be mapped.
+        MappedFile(MappedFile&&) noexcept;
+        MappedFile& operator=(MappedFile&&) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile();
+
+        const byte* data() const { return mapping; }
+        std::size_t size() const { return mapping_size; }
+        Span span() const { return Span {mapping, mapping_size}; } // The entire file.
+        Span span(std::size_t, std::size_t) const; // Part of the file, throws std::out_of_range.
+
+    private:
+        const byte* mapping {nullptr};
+        std::size_t mapping_size {0};
+    };
+
+    class Archive;
+
+    // Resolves ROM references to spans, mapping each file only once even when many
+    // workers ask for ROMs in it at the same time. A reference is either a plain path,
+    // "<pack path>@<offset>:<size>" for a ROM stored somewhere inside of a pack, or
+    // "<archive path>#<name>" and "<archive path>#xxh64:<hex>" for a ROM in an archive.
+    // A reference that names an existing file is always a plain path, and the others
+    // are only looked into if what's before the '#' or '@' exists.
+    // Spans stay valid for as long as the loader lives.
+    class Loader {
+    public:
+        Loader();
+        ~Loader(); // Archive is incomplete here.
+        Span load(const std::string&); // Throws std::runtime_error or std::out_of_range.
+        const MappedFile& map(const std::string&); // Maps a file, or returns the existing mapping.
+        const Archive& archive(const std::string&); // Same as above, but for archives.
+
+    private:
+        std::mutex lock;
+        std::map<std::string, std::unique_ptr<MappedFile>> files;
+        std::map<std::string, std::unique_ptr<Archive>> archives;
+    };
+}
+
+#endif
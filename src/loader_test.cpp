@@ -0,0 +1,71 @@
+#include "catch.hpp"
+#include "loader.hpp"
+#include "memory.hpp"
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+namespace {
+    // Writes bytes to a fresh temporary file, which is removed when going out of scope.
+    struct TemporaryFile {
+        TemporaryFile(const ch8::byte* data, std::size_t size, const char* pattern = "/tmp/chip-8_loader_XXXXXX") {
+            std::string name {pattern};
+            int descriptor {mkstemp(&name[0])};
+            REQUIRE(descriptor != -1);
+            REQUIRE(write(descriptor, data, size) == static_cast<ssize_t>(size));
+            close(descriptor);
+            path = name;
+        }
+
+        ~TemporaryFile() { unlink(path.c_str()); }
+        std::string path;
+    };
+}
+
+TEST_CASE("Mapping ROM files.", "[loader, mapping]") {
+    const ch8::byte rom[] = {0x60, 0x42, 0x00, 0xFD};
+    TemporaryFile file {rom, sizeof(rom)};
+    ch8::MappedFile mapped {file.path};
+    REQUIRE(mapped.size() == sizeof(rom));
+    REQUIRE(mapped.data()[1] == 0x42);
+
+    ch8::Memory memory {mapped.span()}; // Straight from the mapping.
+    REQUIRE(memory.read(0x200) == 0x60);
+    REQUIRE(memory.read(0x203) == 0xFD);
+
+    ch8::MappedFile moved {std::move(mapped)};
+    REQUIRE(moved.size() == sizeof(rom));
+    REQUIRE(mapped.data() == nullptr); // Ownership of the mapping moved along.
+    REQUIRE_THROWS(ch8::MappedFile {"/does/not/exist.ch8"});
+
+    TemporaryFile empty {rom, 0};
+    REQUIRE(ch8::MappedFile {empty.path}.size() == 0); // Empty ROMs are fine too.
+}
+
+TEST_CASE("Loading ROMs out of a pack.", "[loader, pack]") {
+    const ch8::byte pack[] = {0xAA, 0xBB, 0x12, 0x00, 0x13, 0x00, 0xCC};
+    TemporaryFile file {pack, sizeof(pack)};
+    ch8::Loader loader;
+
+    ch8::Span first {loader.load(file.path + "@2:2")};
+    ch8::Span second {loader.load(file.path + "@0x4:0x2")};
+    REQUIRE(first.size == 2);
+    REQUIRE(first.data[0] == 0x12);
+    REQUIRE(second.data[0] == 0x13);
+    REQUIRE(first.data + 2 == second.data); // Same mapping, the pack is only mapped once.
+    REQUIRE(loader.load(file.path).size == sizeof(pack));
+
+    REQUIRE_THROWS_AS(loader.load(file.path + "@6:2"), const std::out_of_range&); // Past the end.
+    REQUIRE_THROWS(loader.load(file.path + "@2"));
+}
+
+TEST_CASE("Files named like references are still plain files.", "[loader, paths]") {
+    const ch8::byte rom[] = {0x60, 0x42, 0x00, 0xFD};
+    TemporaryFile odd {rom, sizeof(rom), "/tmp/chip-8_loader#2@1:1_XXXXXX"};
+    ch8::Loader loader;
+    REQUIRE(loader.load(odd.path).size == sizeof(rom)); // Neither an archive nor a pack.
+
+    TemporaryFile pack {rom, sizeof(rom)};
+    REQUIRE(loader.load(pack.path + "@1:1").data[0] == 0x42); // Nothing's called that, so it's a reference.
+    REQUIRE_THROWS(loader.load(pack.path + "-missing@1:1"));
+}
@@ -1,36 +1,45 @@
 #include <iostream>
-#include <iomanip>
 #include <fstream>
+#include <iomanip>
+#include <cstdlib>
 #include <string>
+#include <array>
+#include <chrono>
+#include <algorithm>
+#include <vector>
 #include <SDL.h>
 
 #include "memory.hpp"
+#include "loader.hpp"
 #include "processor.hpp"
+#include "quirks.hpp"
+#include "counters.hpp"
+#include "display.hpp"
+#include "histogram.hpp"
+#include "debugger.hpp"
+#include "audio.hpp"
 #include "definitions.hpp"
 
-// Load ROM file to memory.
-ch8::Memory load(const char* path) {
-    char* program;
-    std::size_t program_size;
-    std::ifstream program_stream { path, std::ios::binary };
-    if (program_stream) {
-        program_stream.seekg(0, std::ios::end);
-        program_size = program_stream.tellg();
-        program_stream.seekg(0, std::ios::beg);
-        program = new char[program_size];
-        program_stream.read(program, program_size);
-    } program_stream.close();
-
-    std::cout << path << " loaded, occupying " << program_size << " bytes." << std::endl;
-    ch8::Memory memory { reinterpret_cast<ch8::byte*>(program), program_size };
-    delete[] program; // Program already copied.
-    return memory; // Should use RVO semantics.
+// Maps the ROM file and copies it straight into memory, looking up its quirk profile on the way.
+ch8::Memory load(const char* path, const ch8::QuirkDatabase& quirks, ch8::Profile& profile) {
+    try {
+        ch8::MappedFile rom { path }; // Only needs to live until memory has its copy.
+        profile = quirks.lookup(rom.data(), rom.size());
+        std::cout << path << " loaded, occupying " << rom.size() << " bytes, with "
+                  << ch8::QuirkDatabase::profile_name(profile) << " quirks." << std::endl;
+        return ch8::Memory { rom.span() }; // Throws if the ROM doesn't fit in program memory.
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        std::exit(1);
+    }
 }
 
 // Print the next instruction to be executed by the processor at current PC.
 void print_instruction(const ch8::Memory& memory, ch8::addr program_counter) {
-    std::cout << "Next instruction: 0x" << std::setw(2) << std::setfill('0') << std::hex << static_cast<ch8::addr>(memory.read(program_counter))
-        << std::setw(2) << std::setfill('0') << std::hex << static_cast<ch8::addr>(memory.read(program_counter + 1)) << std::endl;
+    ch8::byte upper {memory.read(program_counter)}, lower {memory.read(program_counter + 1)};
+    std::cout << "Next instruction: 0x" << std::setw(2) << std::setfill('0') << std::hex << static_cast<ch8::addr>(upper)
+        << std::setw(2) << std::setfill('0') << std::hex << static_cast<ch8::addr>(lower)
+        << ' ' << ch8::Interpreter::disassemble(upper, lower) << std::endl;
 }
 
 // Prints display buffer (for debugging)...
@@ -42,15 +51,119 @@ void print_display(const ch8::byte* buffer) {
     }
 }
 
+// Reads the quirk database, if there is one, otherwise every ROM gets the legacy profile.
+ch8::QuirkDatabase load_quirks(const char* path) {
+    if (path == nullptr) return ch8::QuirkDatabase {};
+    std::ifstream stream { path };
+    try {
+        if (!stream) throw std::runtime_error { "Couldn't open quirk database " + std::string { path } + '.' };
+        return ch8::QuirkDatabase::parse(stream);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        std::exit(1);
+    }
+}
+
+using Clock = std::chrono::steady_clock;
+std::uint64_t nanoseconds(Clock::time_point begin, Clock::time_point end) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+}
+
+// Where the time between presented frames went, so stutter can be pinned on emulation,
+// uploading the texture, or presenting it (which includes waiting on vsync). Emulation is
+// everything else since the last present, input included, so steps don't need timing of their own.
+struct FrameStats {
+    ch8::Histogram emulation, upload, present, instructions, latency; // Nanoseconds, except instructions.
+    std::uint64_t executed {0}; // Since the last present.
+    Clock::time_point last_present {Clock::now()};
+    bool key_pending {false}; // Pressed since the last present, at key_time.
+    Clock::time_point key_time;
+    std::array<std::array<std::uint64_t, 3>, 128> recent {{}}; // Emulation, upload and present of the last frames.
+    std::size_t next_recent {0};
+
+    void presented(Clock::time_point upload_begin, Clock::time_point present_begin, Clock::time_point now) {
+        std::uint64_t emulating {nanoseconds(last_present, upload_begin)}, uploading {nanoseconds(upload_begin, present_begin)},
+                      presenting {nanoseconds(present_begin, now)};
+        emulation.record(emulating);
+        upload.record(uploading);
+        present.record(presenting);
+        instructions.record(executed);
+        if (key_pending) latency.record(nanoseconds(key_time, now));
+        recent[next_recent++ % recent.size()] = {{emulating, uploading, presenting}};
+        executed = 0;
+        last_present = now;
+        key_pending = false;
+    }
+
+    void report(std::ostream& stream) const {
+        if (present.count() == 0) return;
+        emulation.report(stream, "Emulation per frame", 1000.0, "us");
+        upload.report(stream, "Upload per frame", 1000.0, "us");
+        present.report(stream, "Present per frame", 1000.0, "us");
+        instructions.report(stream, "Instructions per frame");
+        if (latency.count() != 0) latency.report(stream, "Key to present", 1000.0, "us");
+    }
+};
+
+// Bars for the most recent frames, stacked emulation (green), upload (blue) and present (red),
+// 4 pixels per millisecond, with a line at a 60 Hz frame. Old frames scroll off to the left.
+void draw_overlay(SDL_Renderer* renderer, const FrameStats& stats) {
+    int width, height;
+    SDL_GetRendererOutputSize(renderer, &width, &height);
+    const SDL_Color colors[3] = {{0x40, 0xC0, 0x40, 0xC0}, {0x40, 0x80, 0xFF, 0xC0}, {0xFF, 0x40, 0x40, 0xC0}};
+    int bar_width {std::max(1, width / static_cast<int>(stats.recent.size()))};
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    for (std::size_t i {0}; i < stats.recent.size(); ++i) {
+        const std::array<std::uint64_t, 3>& frame {stats.recent[(stats.next_recent + i) % stats.recent.size()]};
+        int top {height};
+        for (std::size_t part {0}; part < 3; ++part) {
+            int bar_height {static_cast<int>(std::min<std::uint64_t>(frame[part] * 4 / 1000000, height))};
+            SDL_Rect bar {static_cast<int>(i) * bar_width, top - bar_height, bar_width, bar_height};
+            SDL_SetRenderDrawColor(renderer, colors[part].r, colors[part].g, colors[part].b, colors[part].a);
+            SDL_RenderFillRect(renderer, &bar);
+            top -= bar_height;
+        }
+    }
+
+    SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0x00, 0xFF);
+    SDL_RenderDrawLine(renderer, 0, height - 4 * 1000 / 60, width, height - 4 * 1000 / 60);
+    SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF); // What SDL_RenderClear uses.
+}
+
 int main(int argc, char** argv) {
-    if (argc != 2) {
+    ch8::Debugger debugger;
+    bool debugging { false };
+    std::vector<const char*> paths; // ROM, then maybe the quirk database.
+    for (int i { 1 }; i < argc; ++i) {
+        std::string argument { argv[i] };
+        if (argument == "-b" && i + 1 < argc) {
+            try { debugger.add(argv[++i]); }
+            catch (const std::exception& error) {
+                std::cerr << error.what() << std::endl;
+                return 1;
+            }
+
+            debugging = true;
+        } else paths.push_back(argv[i]);
+    }
+
+    if (paths.size() != 1 && paths.size() != 2) {
         std::cerr << "Usage: " << argv[0]
-            << " <rom path>" << std::endl;
+            << " [-b <breakpoint>]... <rom path> [quirk database]" << std::endl;
         return 1;
     }
 
-    ch8::Memory memory { load(argv[1]) }; // Loads specified ROM with program.
+    ch8::Profile profile;
+    ch8::QuirkDatabase quirks { load_quirks(paths.size() == 2 ? paths[1] : nullptr) };
+    ch8::Memory memory { load(paths[0], quirks, profile) }; // Loads specified ROM with program.
     ch8::Processor processor { memory }; // Processor needs to know about memory.
+    try { processor.profile(profile); }
+    catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+
+    if (debugging) processor.debug(&debugger); // Otherwise nothing is checked at all.
 
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
         std::cerr << "SDL_Init failed: "
@@ -58,7 +171,7 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    std::string title { "chip-8 @ " + std::string{ argv[1] } };
+    std::string title { "chip-8 @ " + std::string{ paths[0] } };
     SDL_Window* window { SDL_CreateWindow(title.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 640, 320, 0) };
     if (window == nullptr) {
         std::cerr << "SDL_CreateWindow failed: "
@@ -81,7 +194,10 @@ int main(int argc, char** argv) {
     int display_buffer_width = -1; // The size of a row in the texture below (queried by SDL_LockTexture).
     ch8::byte* display_buffer = nullptr; // We will load the buffer of the texture that is created in SDL_CreateTexture below, here.
     SDL_Texture* display_buffer_texture { SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, 64, 32) };
-    if (display_buffer_texture == nullptr) {
+    // SUPER-CHIP's high resolution screen, both are made once and picked from for every frame.
+    SDL_Texture* high_texture { SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING,
+                                                  ch8::Processor::HIGH_WIDTH, ch8::Processor::HIGH_HEIGHT) };
+    if (display_buffer_texture == nullptr || high_texture == nullptr) {
         std::cerr << "SDL_CreateTexture failed.: "
                   << SDL_GetError() << std::endl;
         SDL_DestroyRenderer(renderer);
@@ -89,8 +205,30 @@ int main(int argc, char** argv) {
         SDL_Quit();
     }
 
+    // Rendered on SDL's audio thread, which only ever hears from us through the queue.
+    ch8::AudioQueue audio_queue;
+    ch8::AudioEngine audio_engine { audio_queue, 48000.0 };
+    SDL_AudioSpec wanted {};
+    wanted.freq = 48000;
+    wanted.format = AUDIO_F32SYS;
+    wanted.channels = 1;
+    wanted.samples = 512; // Around 10ms.
+    wanted.callback = [](void* engine, Uint8* stream, int length) {
+        static_cast<ch8::AudioEngine*>(engine)->render(reinterpret_cast<float*>(stream), length / sizeof(float));
+    };
+
+    wanted.userdata = &audio_engine;
+    SDL_AudioDeviceID audio_device { SDL_InitSubSystem(SDL_INIT_AUDIO) == 0 ? SDL_OpenAudioDevice(nullptr, 0, &wanted, nullptr, 0) : 0 };
+    if (audio_device == 0) std::cerr << "No sound, SDL audio failed: " << SDL_GetError() << std::endl;
+    else SDL_PauseAudioDevice(audio_device, 0);
+
+    ch8::AudioMessage sent {};
+    bool audio_pending { false }; // The queue was full, so try again next time.
+
     bool step_mode { false };
     bool force_exit { false };
+    bool overlay { false }; // Frame times on top of the game, toggled with F1.
+    FrameStats stats;
     unsigned current_time { SDL_GetTicks() };
     unsigned interrupt_time { SDL_GetTicks() };
     while (processor.running() && !force_exit) {
@@ -121,6 +259,11 @@ int main(int argc, char** argv) {
                 } break;
             case SDL_KEYDOWN:
                 ch8::addr program_counter;
+                if (!stats.key_pending && event.key.repeat == 0) {
+                    stats.key_pending = true;
+                    stats.key_time = Clock::now();
+                }
+
                 switch (event.key.keysym.sym) {
                 case SDLK_1: processor.key_pressed(0x01); break;
                 case SDLK_2: processor.key_pressed(0x02); break;
@@ -143,6 +286,8 @@ int main(int argc, char** argv) {
                 case SDLK_v: processor.key_pressed(0x0F); break;
                 case SDLK_ESCAPE: force_exit = true;  break;
                 case SDLK_j:
+                    debugger.resume(); // Steps over a breakpoint we're stopped at.
+                    stats.last_present = Clock::now(); // Time spent paused isn't emulation.
                     processor.step(); // Very useful for debugging chip-8 programs :D.
                     processor.dump(); // Print the current state of the processor at the PC.
                     program_counter = processor.register_state(ch8::Processor::Register::PC);
@@ -150,7 +295,8 @@ int main(int argc, char** argv) {
                     std::cout << std::endl;
                     step_mode = true;
                     break;
-                case SDLK_k: step_mode = false; break;
+                case SDLK_k: debugger.resume(); step_mode = false; stats.last_present = Clock::now(); break;
+                case SDLK_F1: overlay = !overlay; break;
                 }
             default: break;
             }
@@ -162,32 +308,71 @@ int main(int argc, char** argv) {
             if (processor.sound_issued()) processor.tick_sound();
             if (processor.delay_issued()) processor.tick_delay();
             interrupt_time = current_time;
+
+            ch8::AudioMessage message {};
+            const ch8::byte* pattern { profile == ch8::Profile::XO_CHIP ? processor.audio_pattern() : ch8::AudioEngine::BEEP };
+            std::copy(pattern, pattern + ch8::AudioMessage::PATTERN_SIZE, message.pattern);
+            message.pitch = profile == ch8::Profile::XO_CHIP ? processor.audio_pitch() : 64;
+            message.playing = processor.sound_issued();
+            if (audio_pending || message.playing != sent.playing || message.pitch != sent.pitch
+                || !std::equal(message.pattern, message.pattern + ch8::AudioMessage::PATTERN_SIZE, sent.pattern)) {
+                audio_pending = audio_device != 0 && !audio_queue.push(message);
+                sent = message;
+            }
         }
 
         // Actually emulate the Chip-8 :)
-        if (!step_mode) processor.step();
+        if (!step_mode) {
+            processor.step();
+            ++stats.executed;
+            if (debugger.hit().kind != ch8::Debugger::Hit::Kind::NONE) {
+                const ch8::Debugger::Hit& hit { debugger.hit() };
+                std::cout << "Stopped on " << ch8::Debugger::hit_name(hit.kind) << " at 0x" << std::hex << hit.PC;
+                if (hit.address != 0x0000) std::cout << ", accessing 0x" << hit.address;
+                std::cout << '.' << std::endl;
+                processor.dump();
+                print_instruction(memory, hit.PC);
+                std::cout << std::endl;
+                step_mode = true; // Same as pressing J, which then steps past it.
+            }
+        }
+
         if (processor.display_updated()) {
-            SDL_LockTexture(display_buffer_texture, nullptr,
+            Clock::time_point upload_begin { Clock::now() };
+            SDL_Texture* texture { processor.high_resolution() ? high_texture : display_buffer_texture };
+            SDL_LockTexture(texture, nullptr,
                             reinterpret_cast<void**>(&display_buffer),
                             &display_buffer_width);
-            for (std::size_t i { 0 }; i < 64 * 32; ++i) {
-                // Only vary the game screen between black and white for now...
-                display_buffer[i*4] = 0xFF; // Alpha channel for some reason...
-                display_buffer[i*4 + 1] = processor.display_buffer()[i] * 0xFF;
-                display_buffer[i*4 + 2] = processor.display_buffer()[i] * 0xFF;
-                display_buffer[i*4 + 3] = processor.display_buffer()[i] * 0xFF;
-            } SDL_UnlockTexture(display_buffer_texture);
+            if (processor.high_resolution()) ch8::Display::rgba8888(processor.high_display(), display_buffer);
+            else ch8::Display::rgba8888(processor.display_buffer(), display_buffer);
+            SDL_UnlockTexture(texture);
 
+            Clock::time_point present_begin { Clock::now() };
             SDL_RenderClear(renderer);
             // Render the display buffer texture with nearest neighbor scaling.
-            SDL_RenderCopy(renderer, display_buffer_texture, nullptr, nullptr);
+            SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+            if (overlay) draw_overlay(renderer, stats);
             SDL_RenderPresent(renderer);
+            Clock::time_point presented { Clock::now() };
+            stats.presented(upload_begin, present_begin, presented);
             processor.updated_display();
         }
     }
 
+    if (processor.trapped()) {
+        const ch8::Processor::Trap& trap { processor.trap() };
+        std::cerr << "Stopped on " << ch8::Processor::trap_name(trap.kind) << " at 0x" << std::hex << std::setfill('0')
+                  << std::setw(3) << trap.PC << ", opcode 0x" << std::setw(4) << trap.opcode << '.' << std::endl;
+        processor.dump();
+    }
+
+    stats.report(std::cout);
+    CH8_COUNT(ch8::Counters::sum().report(std::cerr)); // Only in profiling builds.
+
     // As always, don't forget to free stuff :)
+    if (audio_device != 0) SDL_CloseAudioDevice(audio_device);
     SDL_DestroyTexture(display_buffer_texture);
+    SDL_DestroyTexture(high_texture);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
@@ -0,0 +1,57 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+
+#include "analyser.hpp"
+#include "loader.hpp"
+#include "definitions.hpp"
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program << " [-f text|dot] [-o <output>] <rom>" << std::endl;
+}
+
+// Disassembles a ROM recursively without running it, writing its blocks and what's code or data.
+int main(int argc, char** argv) {
+    std::string format {"text"};
+    std::string output_path, rom_path;
+
+    for (int i {1}; i < argc; ++i) {
+        std::string argument {argv[i]};
+        bool has_value {i + 1 < argc};
+        if (argument == "-f" && has_value) format = argv[++i];
+        else if (argument == "-o" && has_value) output_path = argv[++i];
+        else if (rom_path.empty() && argument[0] != '-') rom_path = argument;
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (rom_path.empty() || (format != "text" && format != "dot")) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        ch8::Loader loader;
+        ch8::Span rom {loader.load(rom_path)};
+        ch8::Analysis analysis {ch8::Analyser::analyse(rom.data, rom.size)};
+
+        std::ofstream output_file;
+        if (!output_path.empty()) {
+            output_file.open(output_path);
+            if (!output_file) throw std::runtime_error {"Couldn't open output " + output_path + '.'};
+        }
+
+        std::ostream& output {output_path.empty() ? std::cout : output_file};
+        if (format == "dot") analysis.write_dot(output);
+        else analysis.write(output);
+        std::cerr << analysis.blocks.size() << " blocks, " << analysis.instructions().size() << " instructions, "
+                  << analysis.sprites.size() << " sprite regions." << std::endl;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
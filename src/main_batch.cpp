@@ -0,0 +1,101 @@
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "batch.hpp"
+#include "counters.hpp"
+#include "definitions.hpp"
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program
+        << " [-j <workers>] [-c <cycles per frame>] [-f csv|json] [-o <output>] [-q <quirk database>] [-e] <manifest>" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::size_t workers {0}; // One per hardware thread.
+    std::size_t cycles_per_frame {ch8::Batch::DEFAULT_CYCLES_PER_FRAME};
+    std::string format {"csv"};
+    std::string output_path;
+    std::string manifest_path;
+    std::string quirks_path;
+    bool measure {false}; // Host CPU counters, reported per emulated instruction.
+
+    for (int i {1}; i < argc; ++i) {
+        std::string argument {argv[i]};
+        bool has_value {i + 1 < argc};
+        if (argument == "-j" && has_value) workers = std::strtoul(argv[++i], nullptr, 10);
+        else if (argument == "-c" && has_value) cycles_per_frame = std::strtoul(argv[++i], nullptr, 10);
+        else if (argument == "-f" && has_value) format = argv[++i];
+        else if (argument == "-o" && has_value) output_path = argv[++i];
+        else if (argument == "-q" && has_value) quirks_path = argv[++i];
+        else if (argument == "-e") measure = true;
+        else if (manifest_path.empty() && argument[0] != '-') manifest_path = argument;
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (manifest_path.empty() || (format != "csv" && format != "json") || cycles_per_frame == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<ch8::Job> jobs;
+    std::ifstream manifest_stream {manifest_path};
+    if (!manifest_stream) {
+        std::cerr << "Couldn't open manifest " << manifest_path << '.' << std::endl;
+        return 1;
+    }
+
+    try { jobs = ch8::Batch::parse_manifest(manifest_stream); }
+    catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+
+    ch8::Batch batch {workers, cycles_per_frame};
+    if (!quirks_path.empty()) {
+        std::ifstream quirks_stream {quirks_path};
+        if (!quirks_stream) {
+            std::cerr << "Couldn't open quirk database " << quirks_path << '.' << std::endl;
+            return 1;
+        }
+
+        try { batch.quirks(ch8::QuirkDatabase::parse(quirks_stream)); }
+        catch (const std::exception& error) {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+    }
+
+    batch.measure(measure);
+    std::vector<ch8::Result> results {batch.run(jobs)};
+
+    std::ofstream output_file;
+    if (!output_path.empty()) {
+        output_file.open(output_path);
+        if (!output_file) {
+            std::cerr << "Couldn't open output " << output_path << '.' << std::endl;
+            return 1;
+        }
+    }
+
+    std::ostream& output {output_path.empty() ? std::cout : output_file};
+    if (format == "json") ch8::Batch::write_json(output, jobs, results);
+    else ch8::Batch::write_csv(output, jobs, results);
+
+    std::size_t failed {0};
+    for (const ch8::Result& result : results) {
+        if (result.status == ch8::Result::Status::FAULT ||
+            result.status == ch8::Result::Status::ERROR) ++failed;
+    }
+
+    std::cerr << jobs.size() << " jobs done on " << batch.workers() << " workers, "
+              << failed << " failed." << std::endl;
+    if (measure) batch.hardware().report(std::cerr, "emulated instruction");
+    CH8_COUNT(ch8::Counters::sum().report(std::cerr)); // Only in profiling builds, every worker is idle by now.
+    return failed == 0 ? 0 : 2; // Apart from 1 for the runner itself failing, so scripts can tell.
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "audio.hpp"
+#include "bench.hpp"
+#include "display.hpp"
+#include "hardware.hpp"
+#include "interpreter.hpp"
+#include "memory.hpp"
+#include "processor.hpp"
+#include "definitions.hpp"
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program
+        << " [-s <samples>] [-t <seconds per sample>] [-f csv|json] [-o <output>] [-e] [<name filter>]" << std::endl;
+}
+
+// A handler family, measured by executing one of its instructions over and over.
+struct Family {
+    const char* name;
+    ch8::Instruction instruction;
+    ch8::word opcode;
+};
+
+int main(int argc, char** argv) {
+    std::size_t samples {20};
+    double sample_time {0.005};
+    std::string format {"csv"};
+    std::string output_path;
+    std::string filter;
+    bool measure {false}; // Host CPU counters, reported per iteration.
+
+    for (int i {1}; i < argc; ++i) {
+        std::string argument {argv[i]};
+        bool has_value {i + 1 < argc};
+        if (argument == "-s" && has_value) samples = std::strtoul(argv[++i], nullptr, 10);
+        else if (argument == "-t" && has_value) sample_time = std::strtod(argv[++i], nullptr);
+        else if (argument == "-f" && has_value) format = argv[++i];
+        else if (argument == "-o" && has_value) output_path = argv[++i];
+        else if (argument == "-e") measure = true;
+        else if (filter.empty() && argument[0] != '-') filter = argument;
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if ((format != "csv" && format != "json") || samples == 0 || !(sample_time > 0.0)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    ch8::Bench bench {samples, sample_time};
+    auto run = [&bench, &filter, measure](const std::string& name, const ch8::Bench::Body& body) {
+        if (name.find(filter) == std::string::npos) return;
+        if (!measure) {
+            std::cerr << name << ": " << bench.run(name, body).median << " ns" << std::endl;
+            return;
+        }
+
+        // Counted over every call, calibration included, which is the same code anyway.
+        ch8::HardwareCounters counters;
+        std::cerr << name << ": " << bench.run(name, [&counters, &body](std::size_t n) {
+            counters.start();
+            body(n);
+            counters.stop();
+            counters.operations(n);
+        }).median << " ns" << std::endl << "  ";
+        counters.read().report(std::cerr, "iteration");
+    };
+
+    // Every valid opcode, in order, so branches in the decoder see a realistic mix.
+    std::vector<ch8::word> opcodes;
+    for (unsigned opcode {0}; opcode <= 0xFFFF; ++opcode) {
+        if (ch8::Interpreter::decode(opcode >> 8, opcode & 0xFF) != ch8::Instruction::INVALID) opcodes.push_back(opcode);
+    }
+
+    run("interpreter/parse", [&opcodes](std::size_t n) {
+        for (std::size_t i {0}; i < n; ++i) {
+            ch8::word opcode {opcodes[i % opcodes.size()]};
+            ch8::Bench::keep(ch8::Interpreter::parse(opcode >> 8, opcode & 0xFF));
+        }
+    });
+
+    ch8::Memory memory {nullptr, 0};
+    run("memory/read", [&memory](std::size_t n) {
+        for (std::size_t i {0}; i < n; ++i) ch8::Bench::keep(memory.read(0x200 + i % ch8::Memory::PROGRAM_SIZE));
+    });
+
+    run("memory/write", [&memory](std::size_t n) {
+        for (std::size_t i {0}; i < n; ++i) memory.write(0x200 + i % ch8::Memory::PROGRAM_SIZE, static_cast<ch8::byte>(i));
+    });
+
+    // Handlers are private, so they're measured through execute(), like the debugger would.
+    const Family families[] = {
+        {"processor/jump", ch8::Instruction::JP_A, 0x1300},
+        {"processor/skip", ch8::Instruction::SE_RC, 0x3012},
+        {"processor/load", ch8::Instruction::LD_RC, 0x6012},
+        {"processor/add", ch8::Instruction::ADD_RC, 0x7012},
+        {"processor/logic", ch8::Instruction::XOR_RR, 0x8013},
+        {"processor/arithmetic", ch8::Instruction::SUB_RR, 0x8015},
+        {"processor/shift", ch8::Instruction::SHL_RR, 0x801E},
+        {"processor/random", ch8::Instruction::RND_RC, 0xC0FF},
+        {"processor/keys", ch8::Instruction::SKP_R, 0xE09E},
+        {"processor/timers", ch8::Instruction::LD_DR, 0xF015},
+        {"processor/index", ch8::Instruction::ADD_IR, 0xF01E},
+        {"processor/font", ch8::Instruction::LD_FR, 0xF029},
+        {"processor/bcd", ch8::Instruction::LD_BR, 0xF033},
+        {"processor/store", ch8::Instruction::LD_IAR, 0xFF55},
+        {"processor/restore", ch8::Instruction::LD_RAI, 0xFF65}
+    };
+
+    ch8::Processor processor {memory, 0};
+    for (const Family& family : families) {
+        run(family.name, [&processor, &family](std::size_t n) {
+            ch8::byte upper = family.opcode >> 8, lower = family.opcode & 0xFF;
+            processor.execute(ch8::Instruction::LD_IA, 0xA3, 0x00); // Somewhere every memory instruction works.
+            for (std::size_t i {0}; i < n; ++i) processor.execute(family.instruction, upper, lower);
+        });
+    }
+
+    run("processor/call", [&processor](std::size_t n) {
+        for (std::size_t i {0}; i < n; ++i) {
+            processor.execute(ch8::Instruction::CALL_A, 0x23, 0x00);
+            processor.execute(ch8::Instruction::RET, 0x00, 0xEE);
+        }
+    });
+
+    run("processor/cls", [&processor](std::size_t n) {
+        for (std::size_t i {0}; i < n; ++i) processor.execute(ch8::Instruction::CLS, 0x00, 0xE0);
+    });
+
+    // Every height, at every alignment to a byte, since rows are split over two bytes unless aligned.
+    for (ch8::byte height {1}; height <= 15; ++height) {
+        for (ch8::byte x {0}; x < 8; ++x) {
+            std::string name {"processor/draw/" + std::to_string(height) + "/" + std::to_string(x)};
+            run(name, [&processor, height, x](std::size_t n) {
+                processor.execute(ch8::Instruction::LD_RC, 0x60, x);
+                processor.execute(ch8::Instruction::LD_RC, 0x61, 0x04);
+                processor.execute(ch8::Instruction::LD_IA, 0xA0, 0x00); // Font, always readable.
+                for (std::size_t i {0}; i < n; ++i) processor.execute(ch8::Instruction::DRW_RRC, 0xD0, 0x10 | height);
+            });
+        }
+    }
+
+    std::vector<ch8::byte> rgba(ch8::Processor::SCREEN_WIDTH * ch8::Processor::SCREEN_HEIGHT * 4);
+    run("display/rgba8888", [&processor, &rgba](std::size_t n) {
+        for (std::size_t i {0}; i < n; ++i) {
+            ch8::Display::rgba8888(processor.display_buffer(), rgba.data());
+            ch8::Bench::keep(rgba[i % rgba.size()]);
+        }
+    });
+
+    // One buffer of what the window frontend asks SDL for, while a sound plays.
+    ch8::AudioQueue audio_queue;
+    ch8::AudioEngine audio_engine {audio_queue, 48000.0};
+    ch8::AudioMessage audio_message {{0}, 112, true};
+    std::copy(ch8::AudioEngine::BEEP, ch8::AudioEngine::BEEP + ch8::AudioMessage::PATTERN_SIZE, audio_message.pattern);
+    audio_queue.push(audio_message);
+    std::vector<float> audio(512);
+    run("audio/render", [&audio_engine, &audio](std::size_t n) {
+        for (std::size_t i {0}; i < n; ++i) {
+            audio_engine.render(audio.data(), audio.size());
+            ch8::Bench::keep(audio[i % audio.size()]);
+        }
+    });
+
+    std::ofstream output_file;
+    if (!output_path.empty()) {
+        output_file.open(output_path);
+        if (!output_file) {
+            std::cerr << "Couldn't open output " << output_path << '.' << std::endl;
+            return 1;
+        }
+    }
+
+    std::ostream& output {output_path.empty() ? std::cout : output_file};
+    if (format == "json") ch8::Bench::write_json(output, bench.results());
+    else ch8::Bench::write_csv(output, bench.results());
+    return 0;
+}
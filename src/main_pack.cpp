@@ -0,0 +1,87 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "archive.hpp"
+#include "definitions.hpp"
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program << " -o <archive> <rom>..." << std::endl
+        << "       " << program << " -l <archive>" << std::endl;
+}
+
+// ROMs are stored under their file name, without the directories leading to them.
+std::string rom_name(const std::string& path) {
+    std::size_t slash {path.rfind('/')};
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+int list(const std::string& path) {
+    try {
+        ch8::Archive archive {path};
+        for (std::size_t i {0}; i < archive.size(); ++i) {
+            ch8::Archive::Entry entry {archive.entry(i)};
+            std::cout << std::hex << std::setw(16) << std::setfill('0') << entry.hash << std::dec
+                << ' ' << std::setw(4) << std::setfill(' ') << entry.rom.size << ' ' << entry.name << '\n';
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::string output_path;
+    std::string list_path;
+    std::vector<std::string> rom_paths;
+
+    for (int i {1}; i < argc; ++i) {
+        std::string argument {argv[i]};
+        bool has_value {i + 1 < argc};
+        if (argument == "-o" && has_value) output_path = argv[++i];
+        else if (argument == "-l" && has_value) list_path = argv[++i];
+        else if (argument[0] != '-') rom_paths.push_back(argument);
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!list_path.empty() && output_path.empty() && rom_paths.empty()) return list(list_path);
+    if (output_path.empty() || rom_paths.empty() || !list_path.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<ch8::Archive::Rom> roms;
+    for (const std::string& path : rom_paths) {
+        std::ifstream rom_stream {path, std::ios::binary};
+        if (!rom_stream) {
+            std::cerr << "Couldn't open ROM " << path << '.' << std::endl;
+            return 1;
+        }
+
+        std::vector<ch8::byte> data {std::istreambuf_iterator<char> {rom_stream}, std::istreambuf_iterator<char> {}};
+        roms.push_back(ch8::Archive::Rom {rom_name(path), data});
+    }
+
+    std::ofstream output {output_path, std::ios::binary};
+    if (!output) {
+        std::cerr << "Couldn't open archive " << output_path << '.' << std::endl;
+        return 1;
+    }
+
+    try { ch8::Archive::write(output, roms); }
+    catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+
+    std::cerr << roms.size() << " ROMs packed into " << output_path << '.' << std::endl;
+    return 0;
+}
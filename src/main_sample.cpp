@@ -0,0 +1,94 @@
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <string>
+
+#include "batch.hpp"
+#include "loader.hpp"
+#include "movie.hpp"
+#include "memory.hpp"
+#include "processor.hpp"
+#include "quirks.hpp"
+#include "sampler.hpp"
+#include "definitions.hpp"
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program
+        << " [-n <instructions per sample>] [-b <budget>] [-c <cycles per frame>] [-m <movie>] [-q <quirk database>] [-o <output>] <rom>" << std::endl;
+}
+
+// Runs a ROM headless, like a batch job, and writes where it spent its time as folded stacks.
+int main(int argc, char** argv) {
+    std::size_t period {100};
+    std::size_t budget {10000000};
+    std::size_t cycles_per_frame {ch8::Batch::DEFAULT_CYCLES_PER_FRAME};
+    std::string movie_path, quirks_path, output_path, rom_path;
+
+    for (int i {1}; i < argc; ++i) {
+        std::string argument {argv[i]};
+        bool has_value {i + 1 < argc};
+        if (argument == "-n" && has_value) period = std::strtoul(argv[++i], nullptr, 10);
+        else if (argument == "-b" && has_value) budget = std::strtoul(argv[++i], nullptr, 10);
+        else if (argument == "-c" && has_value) cycles_per_frame = std::strtoul(argv[++i], nullptr, 10);
+        else if (argument == "-m" && has_value) movie_path = argv[++i];
+        else if (argument == "-q" && has_value) quirks_path = argv[++i];
+        else if (argument == "-o" && has_value) output_path = argv[++i];
+        else if (rom_path.empty() && argument[0] != '-') rom_path = argument;
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (rom_path.empty() || period == 0 || cycles_per_frame == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        ch8::Movie movie;
+        if (!movie_path.empty()) {
+            std::ifstream movie_stream {movie_path};
+            if (!movie_stream) throw std::runtime_error {"Couldn't open movie " + movie_path + '.'};
+            movie = ch8::Movie::parse(movie_stream);
+        }
+
+        ch8::QuirkDatabase quirks;
+        if (!quirks_path.empty()) {
+            std::ifstream quirks_stream {quirks_path};
+            if (!quirks_stream) throw std::runtime_error {"Couldn't open quirk database " + quirks_path + '.'};
+            quirks = ch8::QuirkDatabase::parse(quirks_stream);
+        }
+
+        ch8::Loader loader;
+        ch8::Span rom {loader.load(rom_path)};
+        ch8::Memory memory {rom};
+        ch8::Processor processor {memory, 0};
+        processor.profile(quirks.lookup(rom.data, rom.size));
+
+        // Same frames as a batch job, so samples line up with what the batch runner measures.
+        ch8::Sampler sampler {period};
+        std::size_t cycles {0};
+        for (std::size_t frame {0}; cycles < budget && processor.running(); ++frame) {
+            processor.key_mask(movie.keys(frame));
+            cycles += sampler.run(processor, memory, std::min(cycles_per_frame, budget - cycles));
+            processor.tick_timers();
+        }
+
+        std::ofstream output_file;
+        if (!output_path.empty()) {
+            output_file.open(output_path);
+            if (!output_file) throw std::runtime_error {"Couldn't open output " + output_path + '.'};
+        }
+
+        sampler.write_folded(output_path.empty() ? std::cout : output_file);
+        std::cerr << sampler.samples() << " samples over " << cycles << " instructions";
+        if (processor.trapped()) std::cerr << ", stopped on " << ch8::Processor::trap_name(processor.trap().kind);
+        std::cerr << '.' << std::endl;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
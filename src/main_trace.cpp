@@ -0,0 +1,125 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cstdlib>
+#include <string>
+
+#include "batch.hpp"
+#include "loader.hpp"
+#include "movie.hpp"
+#include "memory.hpp"
+#include "processor.hpp"
+#include "quirks.hpp"
+#include "trace.hpp"
+#include "definitions.hpp"
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program
+        << " -o <trace> [-b <budget>] [-c <cycles per frame>] [-m <movie>] [-q <quirk database>] <rom>" << std::endl
+        << "       " << program << " [-f <first cycle>] [-n <records>] <trace>" << std::endl;
+}
+
+// Runs a ROM headless, like a batch job, tracing every instruction.
+int record(const std::string& rom_path, const std::string& trace_path, std::size_t budget, std::size_t cycles_per_frame,
+           const std::string& movie_path, const std::string& quirks_path) {
+    ch8::Movie movie;
+    if (!movie_path.empty()) {
+        std::ifstream movie_stream {movie_path};
+        if (!movie_stream) throw std::runtime_error {"Couldn't open movie " + movie_path + '.'};
+        movie = ch8::Movie::parse(movie_stream);
+    }
+
+    ch8::QuirkDatabase quirks;
+    if (!quirks_path.empty()) {
+        std::ifstream quirks_stream {quirks_path};
+        if (!quirks_stream) throw std::runtime_error {"Couldn't open quirk database " + quirks_path + '.'};
+        quirks = ch8::QuirkDatabase::parse(quirks_stream);
+    }
+
+    ch8::Loader loader;
+    ch8::Span rom {loader.load(rom_path)};
+    ch8::Memory memory {rom};
+    ch8::Processor processor {memory, 0};
+    processor.profile(quirks.lookup(rom.data, rom.size));
+
+    std::ofstream trace_file {trace_path, std::ios::binary};
+    if (!trace_file) throw std::runtime_error {"Couldn't open trace " + trace_path + '.'};
+    ch8::TraceWriter writer {trace_file};
+    processor.trace(&writer);
+
+    std::size_t cycles {0};
+    for (std::size_t frame {0}; cycles < budget && processor.running(); ++frame) {
+        processor.key_mask(movie.keys(frame));
+        cycles += processor.run(std::min(cycles_per_frame, budget - cycles));
+        processor.tick_timers();
+    }
+
+    processor.trace(nullptr);
+    writer.close();
+    std::cerr << writer.recorded() << " instructions traced";
+    if (processor.trapped()) std::cerr << ", stopped on " << ch8::Processor::trap_name(processor.trap().kind);
+    std::cerr << '.' << std::endl;
+    return 0;
+}
+
+// Prints records as "<cycle> <PC> <opcode> <assembly> -> <what changed>".
+int print(const std::string& trace_path, std::uint64_t first, std::uint64_t count) {
+    std::ifstream trace_file {trace_path, std::ios::binary};
+    if (!trace_file) throw std::runtime_error {"Couldn't open trace " + trace_path + '.'};
+    ch8::TraceReader reader {trace_file};
+    ch8::TraceRecord record;
+    std::cout << std::setfill('0') << std::uppercase;
+    while (count != 0 && reader.next(record)) {
+        if (record.cycle < first) continue;
+        std::cout << std::dec << record.cycle << std::hex << " 0x" << std::setw(3) << record.PC
+                  << ' ' << std::setw(4) << record.opcode << ' '
+                  << ch8::Interpreter::disassemble(record.opcode >> 8, record.opcode & 0xFF);
+        if (record.reg == ch8::TraceRecord::I_REGISTER) std::cout << " -> I = 0x" << std::setw(3) << record.value;
+        else if (record.reg != ch8::TraceRecord::NO_REGISTER)
+            std::cout << " -> V" << static_cast<unsigned>(record.reg) << " = 0x" << std::setw(2) << record.value;
+        if (record.address != ch8::TraceRecord::NO_ADDRESS)
+            std::cout << (record.reg == ch8::TraceRecord::NO_REGISTER ? " -> " : ", ")
+                      << "[0x" << std::setw(3) << record.address << "] = 0x" << std::setw(2) << static_cast<unsigned>(record.data);
+        std::cout << '\n';
+        --count;
+    }
+
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::size_t budget {10000000};
+    std::size_t cycles_per_frame {ch8::Batch::DEFAULT_CYCLES_PER_FRAME};
+    std::uint64_t first {0}, count {UINT64_MAX};
+    std::string output_path, movie_path, quirks_path, input_path;
+
+    for (int i {1}; i < argc; ++i) {
+        std::string argument {argv[i]};
+        bool has_value {i + 1 < argc};
+        if (argument == "-o" && has_value) output_path = argv[++i];
+        else if (argument == "-b" && has_value) budget = std::strtoul(argv[++i], nullptr, 10);
+        else if (argument == "-c" && has_value) cycles_per_frame = std::strtoul(argv[++i], nullptr, 10);
+        else if (argument == "-m" && has_value) movie_path = argv[++i];
+        else if (argument == "-q" && has_value) quirks_path = argv[++i];
+        else if (argument == "-f" && has_value) first = std::strtoull(argv[++i], nullptr, 10);
+        else if (argument == "-n" && has_value) count = std::strtoull(argv[++i], nullptr, 10);
+        else if (input_path.empty() && argument[0] != '-') input_path = argument;
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (input_path.empty() || cycles_per_frame == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        if (!output_path.empty()) return record(input_path, output_path, budget, cycles_per_frame, movie_path, quirks_path);
+        else return print(input_path, first, count);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,100 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "batch.hpp"
+#include "memory.hpp"
+#include "processor.hpp"
+#include "workload.hpp"
+#include "definitions.hpp"
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program << " -o <rom> [-i <intensity>] <workload>" << std::endl
+        << "       " << program << " [-b <budget>] [-i <intensity>] [-c <cycles per frame>] [<workload>...]" << std::endl;
+}
+
+// Runs a workload headless one step at a time, with the timers ticked like a batch job,
+// and writes a CSV line. The state hash shows two runs did exactly the same work.
+void measure(ch8::Workload::Kind kind, unsigned intensity, std::size_t budget, std::size_t cycles_per_frame) {
+    std::vector<ch8::byte> rom {ch8::Workload::generate(kind, intensity)};
+    ch8::Memory memory {rom.data(), rom.size()};
+    ch8::Processor processor {memory, 0};
+
+    std::size_t cycles {0}, draws {0};
+    processor.updated_display(); // Only count what the workload draws.
+    auto begin = std::chrono::steady_clock::now();
+    while (cycles < budget && processor.running()) {
+        for (std::size_t frame_cycle {0}; frame_cycle < cycles_per_frame && cycles < budget; ++frame_cycle, ++cycles) {
+            processor.step();
+            if (processor.display_updated()) {
+                ++draws;
+                processor.updated_display();
+            }
+        }
+
+        processor.tick_timers();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    double seconds {std::chrono::duration<double> {end - begin}.count()};
+    std::cout << ch8::Workload::name(kind) << ',' << intensity << ',' << cycles << ',' << draws << ','
+              << std::fixed << std::setprecision(6) << seconds << ',' << std::setprecision(3)
+              << cycles / seconds / 1e6 << ',' << draws / seconds << ','
+              << std::hex << std::setw(16) << std::setfill('0') << ch8::Batch::state_hash(memory, processor)
+              << std::dec << std::setfill(' ') << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+int main(int argc, char** argv) {
+    std::size_t budget {10000000};
+    std::size_t cycles_per_frame {ch8::Batch::DEFAULT_CYCLES_PER_FRAME};
+    unsigned intensity {0}; // Zero is the default for each kind.
+    std::string output_path;
+    std::vector<ch8::Workload::Kind> kinds;
+
+    try {
+        for (int i {1}; i < argc; ++i) {
+            std::string argument {argv[i]};
+            bool has_value {i + 1 < argc};
+            if (argument == "-b" && has_value) budget = std::strtoul(argv[++i], nullptr, 10);
+            else if (argument == "-c" && has_value) cycles_per_frame = std::strtoul(argv[++i], nullptr, 10);
+            else if (argument == "-i" && has_value) intensity = std::strtoul(argv[++i], nullptr, 10);
+            else if (argument == "-o" && has_value) output_path = argv[++i];
+            else if (argument[0] != '-') kinds.push_back(ch8::Workload::kind(argument));
+            else {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+
+        if (cycles_per_frame == 0 || (!output_path.empty() && kinds.size() != 1)) {
+            usage(argv[0]);
+            return 1;
+        }
+
+        if (kinds.empty()) kinds = ch8::Workload::kinds();
+        auto pick = [intensity](ch8::Workload::Kind kind) {
+            return intensity != 0 ? intensity : (ch8::Workload::max_intensity(kind) + 1) / 2;
+        };
+
+        if (!output_path.empty()) {
+            std::vector<ch8::byte> rom {ch8::Workload::generate(kinds.front(), pick(kinds.front()))};
+            std::ofstream output {output_path, std::ios::binary};
+            if (!output.write(reinterpret_cast<const char*>(rom.data()), rom.size()))
+                throw std::runtime_error {"Couldn't write " + output_path + '.'};
+            return 0;
+        }
+
+        std::cout << "workload,intensity,instructions,draws,seconds,mips,draws_per_second,state_hash" << std::endl;
+        for (ch8::Workload::Kind kind : kinds) measure(kind, pick(kind), budget, cycles_per_frame);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
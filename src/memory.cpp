@@ -1,34 +1,114 @@
 #include "memory.hpp"
 #include <cstring>
+#include <utility>
 
 namespace ch8 {
-    Memory::Memory(const byte* program, std::size_t program_size) {
-        // Copy given external program to local main memory, placing it in the correct location.
-        std::memcpy(contents + static_cast<addr>(Limit::INTERPRETER), program, program_size);
+    constexpr std::size_t Memory::SIZE;
+    constexpr std::size_t Memory::PROGRAM_SIZE;
+    constexpr std::size_t Memory::PAGE_SIZE;
+    constexpr std::size_t Memory::PAGES;
+    constexpr std::size_t Memory::OUTSIDE;
+    Memory::Image Memory::image(const byte* program, std::size_t program_size) {
+        if (program_size > PROGRAM_SIZE) throw std::length_error {"Couldn't load program, doesn't fit in memory."};
+        std::shared_ptr<std::array<byte, SIZE>> contents {std::make_shared<std::array<byte, SIZE>>()};
+        contents->fill(0);
 
-        // Copy the interpreters font to main memory, not modifying the original.
-        std::memcpy(contents + 0x000, Interpreter::retrieve_font(), Interpreter::FONT_SIZE);
+        // Copy given external program to the image, placing it in the correct location.
+        if (program_size != 0) std::memcpy(contents->data() + static_cast<addr>(Limit::INTERPRETER), program, program_size);
+
+        // Copy the interpreters font to the image, not modifying the original.
+        std::memcpy(contents->data() + 0x000, Interpreter::retrieve_font(), Interpreter::FONT_SIZE);
+        return contents;
+    }
+
+    Memory::Memory(const byte* program, std::size_t program_size) : Memory {image(program, program_size)} {}
+
+    Memory::Memory(Image contents) : shared {std::move(contents)} {
+        if (!shared) throw std::invalid_argument {"Couldn't create memory, no image given."};
+        for (std::size_t page {0}; page < PAGES; ++page) share(page);
+    }
+
+    Memory::Memory(const Memory& other) : shared {other.shared} {
+        for (std::size_t page {0}; page < PAGES; ++page) {
+            if (other.pages[page] == other.owned[page].get()) own(page, other.pages[page]);
+            else share(page);
+        }
+    }
+
+    Memory& Memory::operator=(const Memory& other) {
+        if (this != &other) {
+            shared = other.shared;
+            for (std::size_t page {0}; page < PAGES; ++page) {
+                if (other.pages[page] == other.owned[page].get()) own(page, other.pages[page]);
+                else share(page);
+            }
+        }
+
+        flush();
+        return *this;
+    }
+
+    void Memory::own(std::size_t page, const byte* source) {
+        if (!owned[page]) owned[page].reset(new byte[PAGE_SIZE]);
+        std::memcpy(owned[page].get(), source, PAGE_SIZE);
+        pages[page] = owned[page].get();
+    }
+
+    void Memory::share(std::size_t page) {
+        pages[page] = shared->data() + page * PAGE_SIZE;
+    }
+
+    std::size_t Memory::private_pages() const {
+        std::size_t count {0};
+        for (std::size_t page {0}; page < PAGES; ++page) count += pages[page] == owned[page].get();
+        return count;
+    }
+
+    void Memory::watch(CodeWatcher* code_watcher) {
+        std::memset(code, 0, sizeof(code));
+        watcher = code_watcher;
+    }
+
+    void Memory::mark_code(addr address, std::size_t size) {
+        for (std::size_t a {address}; a < address + size && a < SIZE; ++a) code[a / 64] |= std::uint64_t {1} << (a % 64);
+    }
+
+    void Memory::flush() {
+        std::memset(code, 0, sizeof(code));
+        if (watcher != nullptr) watcher->code_flushed();
     }
 
     bool Memory::valid(addr address) const{
         addr program_begin {static_cast<addr>(Limit::INTERPRETER)};
-        addr program_end {static_cast<addr>(Limit::PROGRAM) - 1};
+        addr program_end {static_cast<addr>(Limit::LAST)};
         if (within(address, program_begin, program_end)) return true;
         else return false;
     }
 
     byte Memory::read(addr address) const {
-        addr font_begin {0x000};
-        addr font_end {static_cast<addr>(Limit::FONT) - 1};
-        if (valid(address) || within(address, font_begin, font_end)) return contents[address];
+        if (readable(address)) return load(address);
         else throw std::out_of_range {"Couldn't read data, invalid memory address."};
     }
 
     void Memory::write(addr address, byte data) {
-        if (valid(address)) contents[address] = data;
+        if (writable(address)) store(address, data);
         else throw std::out_of_range {"Couldn't write data, invalid memory address."};
     }
 
+    void Memory::save(byte* destination) const {
+        for (std::size_t page {0}; page < PAGES; ++page) std::memcpy(destination + page * PAGE_SIZE, pages[page], PAGE_SIZE);
+    }
+
+    void Memory::restore(const byte* source) {
+        for (std::size_t page {0}; page < PAGES; ++page) {
+            const byte* data {source + page * PAGE_SIZE};
+            if (std::memcmp(data, shared->data() + page * PAGE_SIZE, PAGE_SIZE) == 0) share(page);
+            else own(page, data);
+        }
+
+        flush();
+    }
+
     bool Memory::within(addr target, addr begin, addr end) {
         if (target <= end && target >= begin) return true;
         else return false;
@@ -1,30 +1,95 @@
 #ifndef CH8_MEMORY_HPP
 #define CH8_MEMORY_HPP
 
+#include <array>
+#include <memory>
+#include <cstdint>
 #include <stdexcept>
 #include "definitions.hpp"
 #include "interpreter.hpp"
 
 namespace ch8 {
+    // Told about writes to addresses marked as code, e.g. by a cache of decoded
+    // instructions, so it can throw away just the entries that were overwritten.
+    class CodeWatcher {
+    public:
+        virtual void code_written(addr) = 0; // Something marked as code was overwritten here.
+        virtual void code_flushed() = 0; // All of memory was replaced, nothing decoded is left.
+
+    protected:
+        ~CodeWatcher() = default; // Not owned through this.
+    };
+
+    // Reads go through a page table pointing into an immutable image of the font and program, which
+    // is shared by every Memory started from it. Pages only get a private copy once they're written.
     class Memory {
     public:
+        // XO-CHIP addresses all of 64 KiB, but only builds for it (make XO_CHIP=YES) have that much,
+        // everything else keeps 4 KiB, so whatever is sized by it below stays small.
+#ifdef CH8_XO_CHIP
+        static constexpr std::size_t SIZE {0x10000};
+#else
+        static constexpr std::size_t SIZE {0x1000}; // 4096 bytes of memory.
+#endif
+        static constexpr std::size_t PROGRAM_SIZE {SIZE - 0x200}; // Largest program that fits, 3584 bytes.
+        static constexpr std::size_t PAGE_SIZE {0x100}; // Unit of copy-on-write.
+        static constexpr std::size_t PAGES {SIZE / PAGE_SIZE};
+
+        using Image = std::shared_ptr<const std::array<byte, SIZE>>;
+        static Image image(const byte*, std::size_t); // Font and program of size k. Throws if it doesn't fit.
+
         // Interpreter data needs to be written in the Memory constructor.
-        Memory(const byte*, std::size_t); // Copies program of size k to main memory.
+        Memory(const byte*, std::size_t); // Copies program of size k to main memory. Throws if it doesn't fit.
+        explicit Memory(Span program) : Memory {program.data, program.size} {} // Same, e.g. from a mapped ROM.
+        explicit Memory(Image); // Shares an existing image, nothing is copied until written.
+        Memory(const Memory&); // Copies contents, but neither the code marks nor the watcher.
+        Memory& operator=(const Memory&); // Same, but keeps its own watcher and tells it everything changed.
         bool valid(addr) const; // Checks if user program is operating on a valid address.
         byte read(addr) const; // Reads byte at certain address. Throws exception if invalid.
         void write(addr, byte); // Writes byte to a certain address. Throws exception if invalid.
 
+        // Same checks as above, but without throwing, for callers that handle bad accesses
+        // themselves. The unchecked accesses must only be given addresses that passed them.
+        bool readable(addr address) const { return address < static_cast<addr>(Limit::FONT) || writable(address); }
+        bool writable(addr address) const { return address >= static_cast<addr>(Limit::INTERPRETER) &&
+                                                   (address & OUTSIDE) == 0; }
+        byte load(addr address) const { return pages[address / PAGE_SIZE][address % PAGE_SIZE]; } // Unchecked read.
+        void store(addr address, byte data) { // Unchecked write.
+            std::size_t page {address / PAGE_SIZE};
+            if (pages[page] != owned[page].get()) own(page, pages[page]);
+            owned[page][address % PAGE_SIZE] = data;
+            if (is_code(address)) watcher->code_written(address); // A single bit test unless it's code.
+        }
+
+        // Addresses marked as code call the watcher when written, there's only one of them.
+        void watch(CodeWatcher*); // Replaces the watcher, clearing all marks. Null to stop watching.
+        CodeWatcher* watching() const { return watcher; }
+        void mark_code(addr, std::size_t); // Marks a range as code, needs a watcher.
+        bool is_code(addr address) const { return (code[address / 64] >> (address % 64)) & 1; }
+        void save(byte*) const; // Copies all SIZE bytes out, interpreter area included, for snapshots.
+        void restore(const byte*); // Copies all SIZE bytes back in, pages matching the image are shared again.
+        std::size_t private_pages() const; // Pages that currently differ from the shared image.
+
     private:
-        static constexpr std::size_t SIZE {0x1000}; // 4096 bytes of memory.
         enum class Limit : addr {
             FONT = Interpreter::FONT_SIZE, // Limit of font, in interpreter space but valid read location.
             INTERPRETER = 0x200, // Memory locations below 0x200 are reserved for the interpreter.
-            PROGRAM = SIZE // The rest of the memory is for the program, but only up to addresss 0x0FFF.
+            LAST = SIZE - 1 // The rest of the memory is for the program, up to and including this address.
         };
 
+        static_assert((SIZE & (SIZE - 1)) == 0 && SIZE <= 0x10000, "Memory is a power of two, all of it addressable.");
+        static constexpr std::size_t OUTSIDE {~(SIZE - 1)}; // Bits only set in addresses past the end.
+
         static bool within(addr, addr, addr); // Checks if an address is between a piece of memory.
-        byte contents[SIZE]; // Actual contents, need to do bounds checking since we are dealing with
-                             // a emulator here, would be bad to access memory that is out of bounds.
+        Image shared; // Contents before anything was written, need to do bounds checking since we are dealing
+                      // with a emulator here, would be bad to access memory that is out of bounds.
+        const byte* pages[PAGES]; // Either into the shared image or the private page below.
+        std::unique_ptr<byte[]> owned[PAGES]; // Kept once allocated, even while the page is shared again.
+        void own(std::size_t, const byte*); // Gives a page a private copy of this, allocating it the first time.
+        void share(std::size_t); // Points a page back at the image.
+        std::uint64_t code[SIZE / 64] = {0}; // Bit per address, set if marked as code.
+        CodeWatcher* watcher {nullptr};
+        void flush(); // Clears every mark and tells the watcher.
     };
 }
 
@@ -1,3 +1,4 @@
+#include <vector>
 #include "catch.hpp"
 #include "memory.hpp"
 #include "definitions.hpp"
@@ -8,7 +9,7 @@ TEST_CASE("Memory validity.", "[memory, validity]") {
     REQUIRE(m.valid(0x1FF) == false); // Also inside, right outside boundary.
     REQUIRE(m.valid(0x200) == true); // Just enough to be valid, program space.
     REQUIRE(m.valid(0xFFF) == true); // Still in program memory.
-    REQUIRE(m.valid(0x1000) == false); // Everything above 0xFFF is invalid.
+    if (ch8::Memory::SIZE == 0x1000) REQUIRE(m.valid(0x1000) == false); // Everything above 0xFFF is invalid.
 }
 
 TEST_CASE("Writing/reading memory.", "[memory, reading, writing]") {
@@ -17,13 +18,13 @@ TEST_CASE("Writing/reading memory.", "[memory, reading, writing]") {
     REQUIRE_THROWS(m.write(0x1FF, 0x42)); // Same, but at the boundary.
     REQUIRE_NOTHROW(m.write(0x200, 0x42)); // Should work, since we are inside program space.
     REQUIRE_NOTHROW(m.write(0xFFF, 0x42)); // Still inside program space, at the boundary.
-    REQUIRE_THROWS(m.write(0x1000, 0x42)); // Should fail, outside program space.
+    if (ch8::Memory::SIZE == 0x1000) REQUIRE_THROWS(m.write(0x1000, 0x42)); // Should fail, outside program space.
 
     // Same arguments as above.
     REQUIRE_THROWS(m.read(0x1FF));
     REQUIRE_NOTHROW(m.read(0x200));
     REQUIRE_NOTHROW(m.read(0xFFF));
-    REQUIRE_THROWS(m.read(0x1000));
+    if (ch8::Memory::SIZE == 0x1000) REQUIRE_THROWS(m.read(0x1000));
 
     REQUIRE_NOTHROW(m.read(0x000)); // Font space, should be able to read.
     REQUIRE_NOTHROW(m.read(0x4F)); // Still font space, should be able to read.
@@ -52,3 +53,96 @@ TEST_CASE("Making sure font is copied.", "[memory, font]") {
     REQUIRE(memory.read(0x000) == 0xF0); // First part of 0.
     REQUIRE(memory.read(0x04f) == 0x80); // Last part of F.
 }
+
+TEST_CASE("Programs which don't fit are rejected.", "[memory, size]") {
+    static const ch8::byte program[ch8::Memory::PROGRAM_SIZE + 1] = {0};
+    REQUIRE(ch8::Memory::PROGRAM_SIZE == ch8::Memory::SIZE - 0x200); // From 0x200 up to the end.
+    if (ch8::Memory::SIZE == 0x1000) REQUIRE(ch8::Memory::PROGRAM_SIZE == 0xE00); // Which is 0xFFF, unless built for XO-CHIP.
+    REQUIRE_NOTHROW(ch8::Memory(program, ch8::Memory::PROGRAM_SIZE)); // Exactly fits.
+    REQUIRE_THROWS_AS(ch8::Memory(program, sizeof(program)), const std::length_error&);
+    REQUIRE_NOTHROW(ch8::Memory(ch8::Span {program, 4}));
+}
+
+namespace {
+    struct Recorder : ch8::CodeWatcher {
+        std::vector<ch8::addr> written;
+        int flushed {0};
+        void code_written(ch8::addr address) override { written.push_back(address); }
+        void code_flushed() override { ++flushed; }
+    };
+}
+
+TEST_CASE("Writes to code are reported to the watcher.", "[memory, code]") {
+    ch8::Memory memory {nullptr, 0};
+    Recorder recorder;
+    memory.watch(&recorder);
+    memory.mark_code(0x240, 4);
+    REQUIRE(memory.is_code(0x240));
+    REQUIRE(memory.is_code(0x243));
+    REQUIRE(!memory.is_code(0x244));
+
+    memory.write(0x23F, 0x12); // Plain data, nothing to report.
+    memory.write(0x241, 0x34);
+    memory.store(0x243, 0x56);
+    REQUIRE(recorder.written == (std::vector<ch8::addr> {0x241, 0x243}));
+
+    // Copies don't bring the marks or the watcher along, assigning over memory flushes it.
+    ch8::Memory copy {memory};
+    REQUIRE(copy.read(0x241) == 0x34);
+    REQUIRE(copy.watching() == nullptr);
+    REQUIRE(!copy.is_code(0x241));
+    memory = copy;
+    REQUIRE(recorder.flushed == 1);
+    REQUIRE(memory.watching() == &recorder);
+    REQUIRE(!memory.is_code(0x241));
+
+    ch8::byte image[ch8::Memory::SIZE];
+    memory.mark_code(0x200, 2);
+    memory.save(image);
+    memory.restore(image);
+    REQUIRE(recorder.flushed == 2);
+    REQUIRE(!memory.is_code(0x200));
+
+    memory.watch(nullptr);
+    REQUIRE_NOTHROW(memory.write(0x241, 0x00));
+    REQUIRE(recorder.written.size() == 2);
+}
+
+TEST_CASE("Unwritten pages are shared with the image.", "[memory, pages]") {
+    const ch8::byte program[4] = {0xC0, 0xDE, 0xBE, 0xEF};
+    ch8::Memory::Image image {ch8::Memory::image(program, sizeof(program))};
+    ch8::Memory first {image}, second {image};
+    REQUIRE(first.private_pages() == 0);
+    REQUIRE(image.use_count() == 3);
+
+    first.write(0x301, 0x42); // Only the page written to is copied, and only in this memory.
+    REQUIRE(first.private_pages() == 1);
+    REQUIRE(first.read(0x301) == 0x42);
+    REQUIRE(first.read(0x300) == 0x00);
+    REQUIRE(second.read(0x301) == 0x00);
+    REQUIRE((*image)[0x301] == 0x00);
+    first.write(0x200, 0x00);
+    REQUIRE(first.read(0x201) == 0xDE);
+    REQUIRE(second.read(0x200) == 0xC0);
+
+    ch8::Memory copy {first}; // Private pages are copied, the rest is still shared.
+    REQUIRE(copy.private_pages() == 2);
+    copy.write(0x301, 0x24);
+    REQUIRE(first.read(0x301) == 0x42);
+    second = copy;
+    REQUIRE(second.read(0x301) == 0x24);
+    second = ch8::Memory {image};
+    REQUIRE(second.private_pages() == 0);
+    REQUIRE(second.read(0x301) == 0x00);
+
+    // Restoring goes back to sharing every page that matches the image.
+    ch8::byte snapshot[ch8::Memory::SIZE];
+    first.save(snapshot);
+    REQUIRE(snapshot[0x301] == 0x42);
+    REQUIRE(snapshot[0x000] == 0xF0); // Font.
+    snapshot[0x200] = 0xC0;
+    first.restore(snapshot);
+    REQUIRE(first.private_pages() == 1);
+    REQUIRE(first.read(0x200) == 0xC0);
+    REQUIRE(first.read(0x301) == 0x42);
+}
@@ -0,0 +1,39 @@
+#include "movie.hpp"
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+namespace ch8 {
+    Movie Movie::parse(std::istream& stream) {
+        Movie movie;
+        std::string line;
+        std::size_t line_number {0};
+        while (std::getline(stream, line)) {
+            ++line_number;
+            std::size_t comment {line.find('#')};
+            if (comment != std::string::npos) line.erase(comment);
+            if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+            Input input;
+            unsigned long mask;
+            std::istringstream fields {line};
+            if (!(fields >> input.frame >> std::hex >> mask) || mask > 0xFFFF)
+                throw std::runtime_error {"Couldn't parse movie, bad input on line " + std::to_string(line_number) + '.'};
+            input.mask = static_cast<word>(mask);
+            movie.inputs.push_back(input);
+        }
+
+        // Stable, so the last line for a frame is the one that wins.
+        std::stable_sort(movie.inputs.begin(), movie.inputs.end(),
+                         [](const Input& a, const Input& b) { return a.frame < b.frame; });
+        return movie;
+    }
+
+    word Movie::keys(std::size_t frame) const {
+        // Find the first input after this frame, the one before it is in effect.
+        auto next = std::upper_bound(inputs.begin(), inputs.end(), frame,
+                                     [](std::size_t f, const Input& input) { return f < input.frame; });
+        if (next == inputs.begin()) return 0x0000;
+        else return (next - 1)->mask;
+    }
+}
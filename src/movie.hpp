@@ -0,0 +1,29 @@
+#ifndef CH8_MOVIE_HPP
+#define CH8_MOVIE_HPP
+
+#include <vector>
+#include <istream>
+#include <stdexcept>
+#include "definitions.hpp"
+
+namespace ch8 {
+    // Recorded keyboard input for headless runs. Each line in a movie file looks
+    // like "<frame> <key mask>", where the mask is in hex and bit k is key k. The
+    // mask stays in effect until the next line takes over. '#' starts a comment.
+    class Movie {
+    public:
+        static Movie parse(std::istream&); // Throws std::runtime_error if it can't be parsed.
+        word keys(std::size_t) const; // Key mask which is in effect during the given frame.
+        bool empty() const { return inputs.empty(); } // An empty movie never presses keys.
+
+    private:
+        struct Input {
+            std::size_t frame;
+            word mask;
+        };
+
+        std::vector<Input> inputs; // Sorted by frame, so lookups can be done by bisection.
+    };
+}
+
+#endif
@@ -0,0 +1,29 @@
+#include "catch.hpp"
+#include "movie.hpp"
+#include <sstream>
+
+TEST_CASE("Empty movie never presses any keys.", "[movie, empty]") {
+    std::istringstream stream {"# Nothing here.\n\n"};
+    ch8::Movie movie {ch8::Movie::parse(stream)};
+    REQUIRE(movie.empty());
+    REQUIRE(movie.keys(0) == 0x0000);
+    REQUIRE(movie.keys(1000) == 0x0000);
+}
+
+TEST_CASE("Movie inputs stay in effect until the next one.", "[movie, keys]") {
+    std::istringstream stream {"10 0010\n20 8001 # Keys F and 0.\n5 2\n30 0\n"};
+    ch8::Movie movie {ch8::Movie::parse(stream)};
+    REQUIRE(movie.keys(0) == 0x0000); // Nothing before the first input.
+    REQUIRE(movie.keys(5) == 0x0002); // Out of order lines are sorted.
+    REQUIRE(movie.keys(9) == 0x0002);
+    REQUIRE(movie.keys(10) == 0x0010);
+    REQUIRE(movie.keys(25) == 0x8001);
+    REQUIRE(movie.keys(30) == 0x0000); // Released again.
+}
+
+TEST_CASE("Malformed movies are rejected.", "[movie, errors]") {
+    std::istringstream missing_mask {"10\n"};
+    REQUIRE_THROWS(ch8::Movie::parse(missing_mask));
+    std::istringstream huge_mask {"10 10000\n"};
+    REQUIRE_THROWS(ch8::Movie::parse(huge_mask));
+}
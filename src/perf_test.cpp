@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include "catch.hpp"
+#include "workload.hpp"
+#include "memory.hpp"
+#include "processor.hpp"
+
+// Hidden unless asked for, e.g. with "make run_perf", since timings depend on the machine and
+// build. The baseline is plain text, one "<workload>/<step|run> <MIPS>" line each, '#' starts
+// a comment. CH8_PERF_BASELINE picks another file, CH8_PERF_TOLERANCE another tolerance band,
+// and CH8_PERF_UPDATE=1 writes what was measured instead of comparing against it.
+namespace {
+    const char* DEFAULT_BASELINE {"share/perf_baseline.txt"};
+    constexpr double DEFAULT_TOLERANCE {0.25}; // Slower than this fraction below the baseline fails.
+    constexpr std::size_t BUDGET {500000}; // Instructions per run.
+    constexpr int RUNS {3}; // Best one counts, the others are noise from the rest of the machine.
+
+    double mips(ch8::Workload::Kind kind, bool stepping) {
+        std::vector<ch8::byte> rom {ch8::Workload::generate(kind, (ch8::Workload::max_intensity(kind) + 1) / 2)};
+        double best {0.0};
+        for (int run {0}; run < RUNS; ++run) {
+            ch8::Memory memory {rom.data(), rom.size()};
+            ch8::Processor processor {memory, 0};
+            std::size_t executed {0};
+            auto begin = std::chrono::steady_clock::now();
+            for (std::size_t cycles {0}; cycles < BUDGET; cycles += 10) {
+                if (stepping) for (int i {0}; i < 10 && processor.running(); ++i, ++executed) processor.step();
+                else executed += processor.run(10);
+                processor.tick_timers();
+            }
+
+            auto end = std::chrono::steady_clock::now();
+            INFO(ch8::Workload::name(kind) << " stopped after " << executed << " instructions.");
+            REQUIRE(executed == BUDGET); // One that halts early would do less work and look faster.
+            best = std::max(best, executed / std::chrono::duration<double> {end - begin}.count() / 1e6);
+        }
+
+        return best;
+    }
+
+    std::map<std::string, double> read_baseline(const std::string& path) {
+        std::map<std::string, double> baseline;
+        std::ifstream stream {path};
+        std::string line;
+        while (std::getline(stream, line)) {
+            line.erase(std::min(line.find('#'), line.size()));
+            std::istringstream fields {line};
+            std::string name;
+            double value;
+            if (fields >> name >> value) baseline[name] = value;
+        }
+
+        return baseline;
+    }
+}
+
+TEST_CASE("Throughput hasn't regressed.", "[.][perf]") {
+    const char* path {std::getenv("CH8_PERF_BASELINE")};
+    const char* tolerance_text {std::getenv("CH8_PERF_TOLERANCE")};
+    const char* update {std::getenv("CH8_PERF_UPDATE")};
+    std::string baseline_path {path != nullptr ? path : DEFAULT_BASELINE};
+    double tolerance {tolerance_text != nullptr ? std::strtod(tolerance_text, nullptr) : DEFAULT_TOLERANCE};
+    bool updating {update != nullptr && std::string {update} == "1"};
+
+    std::map<std::string, double> baseline {read_baseline(baseline_path)};
+    std::vector<std::pair<std::string, double>> measured;
+    for (ch8::Workload::Kind kind : ch8::Workload::kinds()) {
+        for (bool stepping : {true, false}) {
+            std::string name {std::string {ch8::Workload::name(kind)} + (stepping ? "/step" : "/run")};
+            measured.emplace_back(name, mips(kind, stepping));
+        }
+    }
+
+    if (updating) {
+        std::ofstream stream {baseline_path};
+        stream << "# Best of " << RUNS << " runs of " << BUDGET << " instructions, in MIPS. Machine and build specific.\n";
+        for (const std::pair<std::string, double>& entry : measured) stream << entry.first << ' ' << entry.second << '\n';
+        REQUIRE(stream.good());
+        WARN("Updated the baseline in " << baseline_path << '.');
+        return;
+    }
+
+    for (const std::pair<std::string, double>& entry : measured) {
+        auto expected = baseline.find(entry.first);
+        INFO(entry.first << ": " << entry.second << " MIPS, baseline "
+             << (expected != baseline.end() ? std::to_string(expected->second) : "missing") << " in " << baseline_path);
+        REQUIRE(expected != baseline.end()); // Run once with CH8_PERF_UPDATE=1 to record one.
+        CHECK(entry.second >= expected->second * (1.0 - tolerance));
+    }
+}
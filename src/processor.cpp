@@ -1,29 +1,509 @@
 #include "processor.hpp"
+#include "counters.hpp"
+#include "trace.hpp"
+#include "debugger.hpp"
 #include <stdexcept>
 #include <iostream>
 #include <iomanip>
 #include <cstring>
+#include <type_traits>
+#include <algorithm>
 
 namespace ch8 {
+    constexpr addr Processor::PROGRAM_INIT;
+    constexpr std::size_t Processor::STACK_SIZE;
+    constexpr std::size_t Processor::HIGH_WIDTH;
+    constexpr std::size_t Processor::HIGH_HEIGHT;
+    constexpr std::size_t Processor::PLANES;
+    constexpr std::size_t Processor::PATTERN_SIZE;
     Processor::Processor(Memory& mem) : memory {mem} {
         std::random_device rnd; // Hardware based RNG, expensive.
         random_generator.seed(rnd()); // Software based now, cheap!
     }
 
-    void Processor::step() {
+    Processor::Processor(Memory& mem, unsigned seed) : memory {mem} {
+        random_generator.seed(seed); // Skip the device, batch jobs need to be reproducible.
+    }
+
+    Processor::~Processor() {
+        if (memory.watching() == this) memory.watch(nullptr);
+    }
+
+    template<typename Quirks>
+    void Processor::step_with() {
         // Since every instruction is 2 bytes long, we need to fetch
         // the upper and lower part of the instrution. Also, this is assuming
         // PC is currently aligned to an even address, if not, shit happens.
         // if (PC % 2 != 0) throw std::out_of_range {"Unaligned address."};
+        addr instruction_address {PC};
+        if (!memory.readable(PC) || !memory.readable(PC + 1)) {
+            fault(Trap::Kind::READ_FAULT);
+            raise(instruction_address, 0x00, 0x00);
+            return;
+        }
 
         // Fetch 2 byte instruction at PC.
-        byte instruction_upper {memory.read(PC)};
-        byte instruction_lower {memory.read(++PC)};
+        byte instruction_upper {memory.load(PC)};
+        byte instruction_lower {memory.load(++PC)};
 
         // Parse instruction and execute it, getting constants from body.
-        Instruction instruction {Interpreter::parse(instruction_upper, instruction_lower)};
-        execute(instruction, instruction_upper, instruction_lower);
-        if (!jump_inst(instruction)) ++PC; // Prepare for next instruction.
+        Instruction instruction {Interpreter::decode(instruction_upper, instruction_lower)};
+        CH8_COUNT(Counters::local().executed(instruction, instruction_upper << 8 | instruction_lower));
+        execute_with<Quirks>(instruction, instruction_upper, instruction_lower);
+        if (pending_trap != Trap::Kind::NONE) raise(instruction_address, instruction_upper, instruction_lower);
+        else if (!jump_inst(instruction)) ++PC; // Prepare for next instruction.
+    }
+
+    template<typename Quirks>
+    void Processor::traced_step() {
+        byte registers[sizeof(V)];
+        std::memcpy(registers, V, sizeof(V));
+        addr instruction_address {PC}, address {I};
+        step_with<Quirks>();
+
+        TraceRecord record {0, instruction_address, 0x0000, 0, TraceRecord::NO_ADDRESS, TraceRecord::NO_REGISTER, 0};
+        if (memory.readable(instruction_address) && memory.readable(instruction_address + 1))
+            record.opcode = memory.load(instruction_address) << 8 | memory.load(instruction_address + 1);
+        for (byte r {0}; r < sizeof(V) && record.reg == TraceRecord::NO_REGISTER; ++r) {
+            if (V[r] != registers[r]) {
+                record.reg = r;
+                record.value = V[r];
+            }
+        }
+
+        if (record.reg == TraceRecord::NO_REGISTER && I != address) {
+            record.reg = TraceRecord::I_REGISTER;
+            record.value = I;
+        }
+
+        // Every store starts at I, and only happens if nothing faulted.
+        Instruction instruction {Interpreter::decode(record.opcode >> 8, record.opcode & 0xFF)};
+        if ((instruction == Instruction::LD_BR || instruction == Instruction::LD_IAR || instruction == Instruction::SAVE_RR) &&
+            !(trapped() && trap_state.PC == instruction_address)) {
+            record.address = address;
+            record.data = memory.load(address);
+        }
+
+        tracer->record(record);
+    }
+
+    template<typename Quirks>
+    std::size_t Processor::traced_run(std::size_t steps) {
+        std::size_t taken {0};
+        while (taken < steps && still_running) {
+            traced_step<Quirks>();
+            if (!trapped()) ++taken; // The faulting instruction never completed.
+        }
+
+        return taken;
+    }
+
+    template<typename Quirks>
+    void Processor::debugged_step() {
+        if (debugger->check(*this, memory)) return;
+        if (tracer != nullptr) traced_step<Quirks>();
+        else step_with<Quirks>();
+    }
+
+    template<typename Quirks>
+    std::size_t Processor::debugged_run(std::size_t steps) {
+        std::size_t taken {0};
+        while (taken < steps && still_running && !debugger->check(*this, memory)) {
+            std::size_t block {std::min(debugger->block(memory, PC), steps - taken)};
+            std::size_t ran {tracer != nullptr ? traced_run<Quirks>(block) : run_with<Quirks>(block)};
+            taken += ran;
+            if (ran < block) break; // Exited or faulted.
+        }
+
+        return taken;
+    }
+
+    template<typename Quirks>
+    void Processor::select() {
+        if (debugger != nullptr) {
+            stepper = &Processor::debugged_step<Quirks>;
+            runner = &Processor::debugged_run<Quirks>;
+        } else {
+            stepper = tracer != nullptr ? &Processor::traced_step<Quirks> : &Processor::step_with<Quirks>;
+            runner = tracer != nullptr ? &Processor::traced_run<Quirks> : &Processor::run_with<Quirks>;
+        }
+
+        executor = &Processor::execute_with<Quirks>;
+    }
+
+    void Processor::profile(Profile selected) {
+        // Its ROMs use all 64 KiB and both planes, without them they'd fault or draw wrong instead.
+        if (selected == Profile::XO_CHIP && (Memory::SIZE < 0x10000 || PLANES < 2))
+            throw std::invalid_argument {"XO-CHIP ROMs need a build with XO_CHIP=YES."};
+        quirk_profile = selected;
+        switch (selected) {
+        case Profile::LEGACY: select<quirks::Legacy>(); break;
+        case Profile::COSMAC: select<quirks::Cosmac>(); break;
+        case Profile::SUPER_CHIP: select<quirks::SuperChip>(); break;
+        case Profile::XO_CHIP: select<quirks::XoChip>(); break;
+        }
+    }
+
+    void Processor::trace(TraceWriter* writer) {
+        tracer = writer;
+        profile(quirk_profile);
+    }
+
+    void Processor::debug(Debugger* checked) {
+        debugger = checked;
+        profile(quirk_profile);
+    }
+
+    void Processor::raise(addr address, byte inst_upper, byte inst_lower) {
+        Trap::Kind kind {pending_trap};
+        pending_trap = Trap::Kind::NONE;
+        trap_state = Trap {kind, address, static_cast<word>(inst_upper << 8 | inst_lower)};
+        PC = address;
+
+        if (faults == FaultPolicy::THROW) {
+            switch (kind) {
+            case Trap::Kind::READ_FAULT: throw std::out_of_range {"Couldn't read data, invalid memory address."};
+            case Trap::Kind::WRITE_FAULT: throw std::out_of_range {"Couldn't write data, invalid memory address."};
+            case Trap::Kind::STACK_OVERFLOW: throw std::out_of_range {"Couldn't call, the stack is full."};
+            default: throw std::runtime_error {"Couldn't execute instruction."};
+            }
+        }
+    }
+
+    const char* Processor::trap_name(Trap::Kind kind) {
+        switch (kind) {
+        case Trap::Kind::NONE: return "none";
+        case Trap::Kind::INVALID_OPCODE: return "invalid opcode";
+        case Trap::Kind::READ_FAULT: return "read fault";
+        case Trap::Kind::WRITE_FAULT: return "write fault";
+        case Trap::Kind::STACK_OVERFLOW: return "stack overflow";
+        default: return "unknown";
+        }
+    }
+
+    void Processor::reset(unsigned seed) {
+        still_running = true;
+        trap_state = Trap {Trap::Kind::NONE, 0x0000, 0x0000};
+        std::memset(V, 0, sizeof(V));
+        ST = DT = SP = 0;
+        PC = PROGRAM_INIT;
+        I = 0x0000;
+        std::memset(stack, 0, sizeof(stack));
+        std::memset(key_states, 0, sizeof(key_states));
+        std::memset(screen, 0, SCREEN_WIDTH * SCREEN_HEIGHT);
+        high = false;
+        std::memset(plane, 0, sizeof(plane));
+        planes = 0x01;
+        std::memset(pattern, 0, sizeof(pattern));
+        pitch = 64;
+        screen_buffer_updated = true;
+        random_generator.seed(seed);
+    }
+
+    void Processor::bind_display(byte* buffer) {
+        std::memcpy(buffer, screen, SCREEN_WIDTH * SCREEN_HEIGHT); // Keep what has been drawn.
+        screen = buffer;
+        screen_buffer_updated = true;
+    }
+
+    constexpr std::uint32_t Processor::Snapshot::MAGIC;
+    static_assert(std::is_trivially_copyable<Processor::Snapshot>::value, "Snapshots are copied as raw bytes.");
+    void Processor::save(Snapshot& snapshot) const {
+        std::memset(static_cast<void*>(&snapshot), 0, sizeof(snapshot)); // Padding too, so equal states are equal bytes.
+        snapshot.magic = Snapshot::MAGIC;
+        memory.save(snapshot.memory);
+        std::memcpy(snapshot.V, V, sizeof(V));
+        snapshot.ST = ST;
+        snapshot.DT = DT;
+        snapshot.SP = SP;
+        snapshot.PC = PC;
+        snapshot.I = I;
+        std::memcpy(snapshot.stack, stack, sizeof(stack));
+        snapshot.keys = 0x0000;
+        for (byte k {0}; k < KEYS; ++k) snapshot.keys |= key_states[k] << k;
+        snapshot.running = still_running;
+        snapshot.trap = trap_state;
+        snapshot.random_generator = random_generator;
+        std::memcpy(snapshot.screen, screen, sizeof(snapshot.screen));
+        snapshot.high = high;
+        std::memcpy(snapshot.plane, plane, sizeof(plane));
+        snapshot.planes = planes;
+        std::memcpy(snapshot.pattern, pattern, sizeof(pattern));
+        snapshot.pitch = pitch;
+    }
+
+    namespace {
+        // Snapshots might come from anywhere (like the C API), so whatever is behind a bool or
+        // an enum is looked at as bytes, since reading anything but a valid value is undefined.
+        unsigned char raw(const bool& value) {
+            unsigned char bytes;
+            std::memcpy(&bytes, &value, sizeof(bytes));
+            return bytes;
+        }
+
+        std::underlying_type<Processor::Trap::Kind>::type raw(const Processor::Trap::Kind& kind) {
+            std::underlying_type<Processor::Trap::Kind>::type bytes;
+            std::memcpy(&bytes, &kind, sizeof(bytes));
+            return bytes;
+        }
+    }
+
+    void Processor::restore(const Snapshot& snapshot) {
+        if (snapshot.magic != Snapshot::MAGIC) throw std::invalid_argument {"Couldn't restore, not a snapshot."};
+        // Only what instructions index with unchecked, or could never have been saved. I isn't,
+        // FX1E can take it anywhere, and every access through it is checked anyway.
+        if (snapshot.SP >= STACK_SIZE) throw std::invalid_argument {"Couldn't restore, stack pointer out of range."};
+        if (snapshot.PC > Memory::SIZE + 2) throw std::invalid_argument {"Couldn't restore, program counter out of range."}; // At most skipped past the end.
+        if (raw(snapshot.running) > 1 || raw(snapshot.high) > 1) throw std::invalid_argument {"Couldn't restore, not a snapshot."};
+        if (raw(snapshot.trap.kind) > static_cast<int>(Trap::Kind::STACK_OVERFLOW) || raw(snapshot.trap.kind) < 0)
+            throw std::invalid_argument {"Couldn't restore, unknown trap."};
+        if (snapshot.planes >= 1 << PLANES) throw std::invalid_argument {"Couldn't restore, planes out of range."};
+        for (byte pixel : snapshot.screen) {
+            if (pixel >= 1 << PLANES) throw std::invalid_argument {"Couldn't restore, pixel out of range."};
+        }
+
+        memory.restore(snapshot.memory);
+        std::memcpy(V, snapshot.V, sizeof(V));
+        ST = snapshot.ST;
+        DT = snapshot.DT;
+        SP = snapshot.SP;
+        PC = snapshot.PC;
+        I = snapshot.I;
+        std::memcpy(stack, snapshot.stack, sizeof(stack));
+        key_mask(snapshot.keys);
+        still_running = snapshot.running;
+        trap_state = snapshot.trap;
+        random_generator = snapshot.random_generator;
+        std::memcpy(screen, snapshot.screen, sizeof(snapshot.screen));
+        high = snapshot.high;
+        std::memcpy(plane, snapshot.plane, sizeof(plane));
+        planes = snapshot.planes;
+        std::memcpy(pattern, snapshot.pattern, sizeof(pattern));
+        pitch = snapshot.pitch;
+        screen_buffer_updated = true;
+    }
+
+    template<typename Quirks>
+    std::size_t Processor::run_with(std::size_t steps) {
+        if (memory.watching() != this) watch_code();
+        std::size_t taken {0};
+        while (taken < steps && still_running) {
+            // Only program memory is predecoded, anything else takes the slow path (and faults there).
+            if (PC < PROGRAM_INIT || PC > Memory::SIZE - 2) {
+                step_with<Quirks>();
+                if (!trapped()) ++taken; // The faulting instruction never completed.
+                continue;
+            }
+
+            const Decoded& entry {predecoded(PC)};
+            if (entry.fusion != Fusion::NONE && entry.length <= steps - taken) {
+                taken += execute_fused<Quirks>(entry);
+                continue;
+            }
+
+            // Nobody can look at VF before it's overwritten, as long as that happens in this run.
+            if (entry.flags_dead != 0 && entry.flags_dead < steps - taken) {
+                CH8_COUNT(Counters::local().executed(entry.instruction, entry.opcode));
+                execute_flagless<Quirks>(entry);
+                PC += 2;
+                ++taken;
+                continue;
+            }
+
+            // Same as step, minus the fetch and decode.
+            addr instruction_address {PC++};
+            byte instruction_upper = entry.opcode >> 8;
+            byte instruction_lower = entry.opcode & 0xFF;
+            CH8_COUNT(Counters::local().executed(entry.instruction, entry.opcode));
+            execute_with<Quirks>(entry.instruction, instruction_upper, instruction_lower);
+            if (pending_trap != Trap::Kind::NONE) {
+                raise(instruction_address, instruction_upper, instruction_lower);
+                break;
+            }
+
+            if (!entry.jump) ++PC;
+            ++taken;
+        }
+
+        return taken;
+    }
+
+    namespace {
+        // How an instruction treats VF, for finding flags that are overwritten before they're read.
+        enum class FlagUse {
+            NONE, // Doesn't touch VF, and always falls through to the next instruction.
+            READ, // Reads VF, or might, depending on the quirks.
+            WRITE, // Overwrites VF without reading it first, and always falls through.
+            BARRIER // Might jump, skip, wait, fault or write memory, nothing past it is certain.
+        };
+
+        FlagUse flag_use(Instruction instruction, word opcode) {
+            byte x = (opcode >> 8) & 0x0F, y = (opcode >> 4) & 0x0F;
+            switch (instruction) {
+            case Instruction::SYS_A: case Instruction::CLS: case Instruction::LD_IA: return FlagUse::NONE;
+            case Instruction::LD_RC: case Instruction::RND_RC:
+            case Instruction::LD_RD: return x == 0x0F ? FlagUse::WRITE : FlagUse::NONE;
+            case Instruction::LD_RR:
+                if (y == 0x0F) return FlagUse::READ;
+                else return x == 0x0F ? FlagUse::WRITE : FlagUse::NONE;
+            case Instruction::ADD_RC: case Instruction::LD_DR: case Instruction::LD_SR:
+            case Instruction::ADD_IR: case Instruction::LD_FR: return x == 0x0F ? FlagUse::READ : FlagUse::NONE;
+            // Some profiles reset VF in logic ops, which isn't counted as a write here.
+            case Instruction::OR_RR: case Instruction::AND_RR:
+            case Instruction::XOR_RR: return x == 0x0F || y == 0x0F ? FlagUse::READ : FlagUse::NONE;
+            case Instruction::ADD_RR: case Instruction::SUB_RR: case Instruction::SUBN_RR:
+            case Instruction::SHR_RR: case Instruction::SHL_RR: return x == 0x0F || y == 0x0F ? FlagUse::READ : FlagUse::WRITE;
+            default: return FlagUse::BARRIER;
+            }
+        }
+    }
+
+    constexpr byte Processor::LOOKAHEAD;
+    const Processor::Decoded& Processor::predecoded(addr address) {
+        Decoded& entry {decoded[address]};
+        if (entry.checked != 0) return entry;
+        auto word_at = [this](addr a) { return static_cast<word>(memory.load(a) << 8 | memory.load(a + 1)); };
+
+        word opcode {word_at(address)};
+        Instruction instruction {Interpreter::decode(opcode >> 8, opcode & 0xFF)};
+        entry = Decoded {opcode, instruction, jump_inst(instruction), Fusion::NONE, 1, 0, 0, {0, 0, 0}};
+
+        // Only look at what's entirely in program memory, the address checks in run don't cover more.
+        byte ahead {0};
+        while (ahead < LOOKAHEAD && std::size_t {address} + (ahead + 1) * 2 + 1 < Memory::SIZE) {
+            entry.tail[ahead] = word_at(address + (ahead + 1) * 2);
+            ++ahead;
+        }
+
+        word second {entry.tail[0]}, third {entry.tail[1]};
+        byte x = (opcode >> 8) & 0x0F;
+        bool skips_on_x {ahead >= 2 && (second >> 12 == 0x3 || second >> 12 == 0x4) && ((second >> 8) & 0x0F) == x};
+        bool then_jumps {ahead >= 2 && third >> 12 == 0x1};
+        if (instruction == Instruction::LD_IA && ahead >= 1 && second >> 12 == 0xD) {
+            entry.fusion = Fusion::LOAD_DRAW;
+            entry.length = 2;
+        } else if (instruction == Instruction::ADD_RC && skips_on_x && then_jumps) {
+            entry.fusion = Fusion::ADD_SKIP_JUMP;
+            entry.length = 3;
+        } else if (instruction == Instruction::LD_RD && skips_on_x && then_jumps) {
+            entry.fusion = Fusion::DELAY_SKIP_JUMP;
+            entry.length = 3;
+        }
+
+        entry.checked = entry.length;
+        bool sets_flags {instruction == Instruction::ADD_RR || instruction == Instruction::SUB_RR ||
+                         instruction == Instruction::SUBN_RR || instruction == Instruction::SHR_RR ||
+                         instruction == Instruction::SHL_RR};
+        if (sets_flags && flag_use(instruction, opcode) == FlagUse::WRITE) {
+            // Straight line code only, so whatever is ahead is certain to run right after this.
+            for (byte i {0}; i < ahead; ++i) {
+                word next {entry.tail[i]};
+                FlagUse use {flag_use(Interpreter::decode(next >> 8, next & 0xFF), next)};
+                if (use == FlagUse::WRITE) {
+                    entry.flags_dead = i + 1;
+                    entry.checked = i + 2;
+                }
+
+                if (use != FlagUse::NONE) break;
+            }
+        }
+
+        memory.mark_code(address, entry.checked * 2);
+        return entry;
+    }
+
+    void Processor::code_written(addr address) {
+        // Entries starting up to this far back may cover the address, the ones that do are stale.
+        std::size_t reach {(LOOKAHEAD + 1) * 2 - 1};
+        std::size_t first {address > reach ? address - reach : 0};
+        for (std::size_t a {first}; a <= address; ++a) {
+            if (a + decoded[a].checked * 2 > address) decoded[a].checked = 0;
+        }
+    }
+
+    void Processor::code_flushed() {
+        for (Decoded& entry : decoded) entry.checked = 0;
+    }
+
+    void Processor::watch_code() {
+        if (decoded.empty()) decoded.resize(Memory::SIZE);
+        code_flushed(); // Whatever was written since the last run went unnoticed.
+        memory.watch(this);
+    }
+
+    void Processor::warm(const std::vector<addr>& addresses) {
+        if (memory.watching() != this) watch_code();
+        for (addr address : addresses) {
+            if (address >= PROGRAM_INIT && address <= Memory::SIZE - 2) predecoded(address); // Same range as run.
+        }
+    }
+
+    template<typename Quirks>
+    std::size_t Processor::execute_fused(const Decoded& entry) {
+        byte x = (entry.opcode >> 8) & 0x0F;
+        switch (entry.fusion) {
+        case Fusion::LOAD_DRAW: {
+            addr draw {static_cast<addr>(PC + 2)};
+            I = entry.opcode & 0x0FFF;
+            PC = draw + 1; // Same place step would have it, in case DRW faults.
+            byte draw_upper = entry.tail[0] >> 8, draw_lower = entry.tail[0] & 0xFF;
+            CH8_COUNT(Counters::local().executed(Instruction::LD_IA, entry.opcode));
+            CH8_COUNT(Counters::local().executed(Instruction::DRW_RRC, entry.tail[0]));
+            inst_drwrrc<Quirks>(draw_upper & 0x0F, draw_lower >> 4, draw_lower & 0x0F);
+            if (pending_trap != Trap::Kind::NONE) {
+                raise(draw, draw_upper, draw_lower);
+                return 1; // Only LD I made it.
+            }
+
+            PC = draw + 2;
+            return 2;
+        }
+
+        case Fusion::ADD_SKIP_JUMP:
+        case Fusion::DELAY_SKIP_JUMP: {
+            if (entry.fusion == Fusion::ADD_SKIP_JUMP) V[x] += entry.opcode & 0xFF;
+            else V[x] = DT;
+            bool equal {V[x] == (entry.tail[0] & 0xFF)};
+            bool skip {entry.tail[0] >> 12 == 0x3 ? equal : !equal};
+            CH8_COUNT(Counters::local().executed(entry.instruction, entry.opcode));
+            CH8_COUNT(Counters::local().executed(entry.tail[0] >> 12 == 0x3 ? Instruction::SE_RC : Instruction::SNE_RC, entry.tail[0]));
+            CH8_COUNT(Counters::local().skipped(skip));
+            if (skip) {
+                PC += 6; // Past the jump, which never ran.
+                return 2;
+            }
+
+            CH8_COUNT(Counters::local().executed(Instruction::JP_A, entry.tail[1]));
+            PC = entry.tail[1] & 0x0FFF;
+            return 3;
+        }
+
+        default: return 0; // Never predecoded as fused.
+        }
+    }
+
+    template<typename Quirks>
+    void Processor::execute_flagless(const Decoded& entry) {
+        byte x = (entry.opcode >> 8) & 0x0F, y = (entry.opcode >> 4) & 0x0F;
+        switch (entry.instruction) {
+        case Instruction::ADD_RR: V[x] += V[y]; break;
+        case Instruction::SUB_RR: V[x] -= V[y]; break;
+        case Instruction::SUBN_RR: V[x] = V[y] - V[x]; break;
+        case Instruction::SHR_RR: V[x] = (Quirks::SHIFT_VY ? V[y] : V[x]) >> 1; break;
+        case Instruction::SHL_RR: V[x] = (Quirks::SHIFT_VY ? V[y] : V[x]) << 1; break;
+        default: break; // Only the above are ever predecoded with dead flags.
+        }
+    }
+
+    void Processor::key_mask(word mask) {
+        for (byte k {0}; k < KEYS; ++k) {
+            key_states[k] = (mask >> k) & 0x0001;
+        }
+    }
+
+    void Processor::tick_timers() {
+        if (sound_issued()) tick_sound();
+        if (delay_issued()) tick_delay();
     }
 
     word Processor::register_state(Register reg) const {
@@ -43,7 +523,8 @@ namespace ch8 {
         }
     }
 
-    void Processor::execute(Instruction inst, byte inst_upper, byte inst_lower) {
+    template<typename Quirks>
+    void Processor::execute_with(Instruction inst, byte inst_upper, byte inst_lower) {
         byte x = Interpreter::parse_argument(Argument::X, inst_upper, inst_lower);
         byte y = Interpreter::parse_argument(Argument::Y, inst_upper, inst_lower);
         word addr = Interpreter::parse_argument(Argument::ADDRESS, inst_upper, inst_lower);
@@ -56,29 +537,29 @@ namespace ch8 {
         case Instruction::JP_A: inst_jpa(addr); break;
         case Instruction::CALL_A: inst_calla(addr); break;
 
-        case Instruction::SE_RC: inst_serc(x, constant); break;
-        case Instruction::SNE_RC: inst_snerc(x, constant); break;
-        case Instruction::SE_RR: inst_serr(x, y); break;
+        case Instruction::SE_RC: inst_serc<Quirks>(x, constant); break;
+        case Instruction::SNE_RC: inst_snerc<Quirks>(x, constant); break;
+        case Instruction::SE_RR: inst_serr<Quirks>(x, y); break;
         case Instruction::LD_RC: inst_ldrc(x, constant); break;
         case Instruction::ADD_RC: inst_addrc(x, constant); break;
 
         case Instruction::LD_RR: inst_ldrr(x, y); break;
-        case Instruction::OR_RR: inst_orrr(x, y); break;
-        case Instruction::AND_RR: inst_andrr(x, y); break;
-        case Instruction::XOR_RR: inst_xorrr(x, y); break;
+        case Instruction::OR_RR: inst_orrr<Quirks>(x, y); break;
+        case Instruction::AND_RR: inst_andrr<Quirks>(x, y); break;
+        case Instruction::XOR_RR: inst_xorrr<Quirks>(x, y); break;
         case Instruction::ADD_RR: inst_addrr(x, y); break;
         case Instruction::SUB_RR: inst_subrr(x, y); break;
-        case Instruction::SHR_RR: inst_shrrr(x, y); break;
-        case Instruction::SHL_RR: inst_shlrr(x, y); break;
+        case Instruction::SHR_RR: inst_shrrr<Quirks>(x, y); break;
+        case Instruction::SHL_RR: inst_shlrr<Quirks>(x, y); break;
         case Instruction::SUBN_RR: inst_subnrr(x, y); break;
 
-        case Instruction::SNE_RR: inst_snerr(x, y); break;
+        case Instruction::SNE_RR: inst_snerr<Quirks>(x, y); break;
         case Instruction::LD_IA: inst_ldia(addr); break;
-        case Instruction::JP_V0A: inst_jpv0a(addr); break;
+        case Instruction::JP_V0A: inst_jpv0a<Quirks>(addr); break;
         case Instruction::RND_RC: inst_rndrc(x, constant); break;
-        case Instruction::DRW_RRC: inst_drwrrc(x, y, constant & 0x0F); break;
-        case Instruction::SKP_R: inst_skpr(x); break;
-        case Instruction::SKNP_R: inst_sknpr(x); break;
+        case Instruction::DRW_RRC: inst_drwrrc<Quirks>(x, y, constant & 0x0F); break;
+        case Instruction::SKP_R: inst_skpr<Quirks>(x); break;
+        case Instruction::SKNP_R: inst_sknpr<Quirks>(x); break;
         case Instruction::LD_RD: inst_ldrd(x); break;
         case Instruction::LD_RK: inst_ldrk(x); break;
         case Instruction::LD_DR: inst_lddr(x); break;
@@ -87,10 +568,21 @@ namespace ch8 {
 
         case Instruction::LD_FR: inst_ldfr(x); break;
         case Instruction::LD_BR: inst_ldbr(x); break;
-        case Instruction::LD_IAR: inst_ldiar(x); break;
-        case Instruction::LD_RAI: inst_ldrai(x); break;
+        case Instruction::LD_IAR: inst_ldiar<Quirks>(x); break;
+        case Instruction::LD_RAI: inst_ldrai<Quirks>(x); break;
         case Instruction::EXIT: still_running = false; break;
-        default: throw std::runtime_error {"Couldn't execute instruction."};
+        case Instruction::SCD_C: inst_scd<Quirks>(constant & 0x0F); break;
+        case Instruction::SCR: inst_scr<Quirks>(); break;
+        case Instruction::SCL: inst_scl<Quirks>(); break;
+        case Instruction::LOW: inst_resolution<Quirks>(false); break;
+        case Instruction::HIGH: inst_resolution<Quirks>(true); break;
+        case Instruction::SAVE_RR: inst_saverr<Quirks>(x, y); break;
+        case Instruction::LOAD_RR: inst_loadrr<Quirks>(x, y); break;
+        case Instruction::LD_IL: inst_ldil<Quirks>(); break;
+        case Instruction::PLANE_C: inst_plane<Quirks>(x); break;
+        case Instruction::AUDIO: inst_audio<Quirks>(); break;
+        case Instruction::PITCH_R: inst_pitch<Quirks>(x); break;
+        default: fault(Trap::Kind::INVALID_OPCODE); break;
         }
     }
 
@@ -127,9 +619,25 @@ namespace ch8 {
                   << ", DT: " << std::setw(4) << std::hex << static_cast<short>(DT) << std::endl;
     }
 
+    template<typename Quirks>
+    void Processor::skip(bool taken) {
+        CH8_COUNT(Counters::local().skipped(taken));
+        if (!taken) return;
+
+        // PC is still on the skipping instruction's second byte, the next one starts right after it.
+        bool long_next {Quirks::XO_EXTENSIONS && memory.readable(PC + 1) && memory.readable(PC + 2) &&
+                        memory.load(PC + 1) == 0xF0 && memory.load(PC + 2) == 0x00};
+        PC += long_next ? 4 : 2;
+    }
+
     void Processor::inst_cls() {
-        for (std::size_t i {0}; i < SCREEN_WIDTH * SCREEN_HEIGHT; ++i) {
-            screen_buffer[i] = 0x00; // Clear the pixels to black color.
+        // Only the selected planes, which is all of them unless XO-CHIP has picked some.
+        for (std::size_t p {0}; high && p < PLANES; ++p) { // Only ever high with SUPER-CHIP's screen.
+            if (planes >> p & 1) std::memset(plane[p], 0, sizeof(plane[p]));
+        }
+
+        for (std::size_t i {0}; !high && i < SCREEN_WIDTH * SCREEN_HEIGHT; ++i) {
+            screen[i] &= ~planes; // Clear the pixels to black color.
         }
 
         screen_buffer_updated = true;
@@ -142,20 +650,45 @@ namespace ch8 {
 
     void Processor::inst_jpa(addr address) { PC = address; }
     void Processor::inst_calla(addr address) {
+        if (SP == STACK_SIZE - 1) {
+            fault(Trap::Kind::STACK_OVERFLOW);
+            return;
+        }
+
         stack[++SP] = PC;
         PC = address;
     }
 
-    void Processor::inst_serc(byte reg, byte constant) { if (V[reg] == constant) PC += 2; }
-    void Processor::inst_snerc(byte reg, byte constant) { if (V[reg] != constant) PC += 2; }
-    void Processor::inst_serr(byte regx, byte regy) { if (V[regx] == V[regy]) PC += 2; }
+    template<typename Quirks>
+    void Processor::inst_serc(byte reg, byte constant) { skip<Quirks>(V[reg] == constant); }
+
+    template<typename Quirks>
+    void Processor::inst_snerc(byte reg, byte constant) { skip<Quirks>(V[reg] != constant); }
+
+    template<typename Quirks>
+    void Processor::inst_serr(byte regx, byte regy) { skip<Quirks>(V[regx] == V[regy]); }
 
     void Processor::inst_ldrc(byte reg, byte constant) { V[reg] = constant; }
     void Processor::inst_addrc(byte reg, byte constant) { V[reg] += constant; }
     void Processor::inst_ldrr(byte regx, byte regy) { V[regx] = V[regy]; }
-    void Processor::inst_orrr(byte regx, byte regy) { V[regx] |= V[regy]; }
-    void Processor::inst_andrr(byte regx, byte regy) { V[regx] &= V[regy]; }
-    void Processor::inst_xorrr(byte regx, byte regy) { V[regx] ^= V[regy]; }
+
+    template<typename Quirks>
+    void Processor::inst_orrr(byte regx, byte regy) {
+        V[regx] |= V[regy];
+        if (Quirks::LOGIC_RESETS_VF) V[0x0F] = 0;
+    }
+
+    template<typename Quirks>
+    void Processor::inst_andrr(byte regx, byte regy) {
+        V[regx] &= V[regy];
+        if (Quirks::LOGIC_RESETS_VF) V[0x0F] = 0;
+    }
+
+    template<typename Quirks>
+    void Processor::inst_xorrr(byte regx, byte regy) {
+        V[regx] ^= V[regy];
+        if (Quirks::LOGIC_RESETS_VF) V[0x0F] = 0;
+    }
 
     void Processor::inst_addrr(byte regx, byte regy) {
         word wregx {V[regx]}, wregy {V[regy]}; // Need to convert there to word length since they might overflow.
@@ -170,10 +703,17 @@ namespace ch8 {
         V[regx] -= V[regy];
     }
 
-    void Processor::inst_shrrr(byte regx, byte) {
-        if (V[regx] == 0x01) V[0x0F] = 1;
-        else V[0x0F] = 0;
-        V[regx] >>= 1;
+    template<typename Quirks>
+    void Processor::inst_shrrr(byte regx, byte regy) {
+        if (Quirks::SHIFT_FLAG_IS_ONE) {
+            if (V[regx] == 0x01) V[0x0F] = 1;
+            else V[0x0F] = 0;
+            V[regx] >>= 1;
+        } else {
+            byte source {Quirks::SHIFT_VY ? V[regy] : V[regx]};
+            V[regx] = source >> 1;
+            V[0x0F] = source & 0x01; // Flag last, so it wins if VF was the target.
+        }
     }
 
     void Processor::inst_subnrr(byte regx, byte regy) {
@@ -182,15 +722,28 @@ namespace ch8 {
         V[regx] = V[regy] - V[regx];
     }
 
-    void Processor::inst_shlrr(byte regx, byte) {
-        if (V[regx] >> 7 == 1) V[0x0F] = 1;
-        else V[0x0F] = 0;
-        V[regx] <<= 1;
+    template<typename Quirks>
+    void Processor::inst_shlrr(byte regx, byte regy) {
+        if (Quirks::SHIFT_FLAG_IS_ONE) {
+            if (V[regx] >> 7 == 1) V[0x0F] = 1;
+            else V[0x0F] = 0;
+            V[regx] <<= 1;
+        } else {
+            byte source {Quirks::SHIFT_VY ? V[regy] : V[regx]};
+            V[regx] = source << 1;
+            V[0x0F] = source >> 7; // Flag last, so it wins if VF was the target.
+        }
     }
 
-    void Processor::inst_snerr(byte regx, byte regy) { if (V[regx] != V[regy]) PC += 2; }
+    template<typename Quirks>
+    void Processor::inst_snerr(byte regx, byte regy) { skip<Quirks>(V[regx] != V[regy]); }
+
     void Processor::inst_ldia(addr address) { I = address; }
-    void Processor::inst_jpv0a(addr address) { PC = address + V[0x00]; }
+    template<typename Quirks>
+    void Processor::inst_jpv0a(addr address) {
+        if (Quirks::JUMP_VX) PC = address + V[(address >> 8) & 0x0F];
+        else PC = address + V[0x00];
+    }
 
     void Processor::inst_rndrc(byte reg, byte constant) {
         byte random_number = random_udistribution(random_generator);
@@ -198,31 +751,59 @@ namespace ch8 {
         V[reg] = random_number; // Assign it to the specified register.
     }
 
+    template<typename Quirks>
     void Processor::inst_drwrrc(byte regx, byte regy, byte length) {
+        if (Quirks::EXTENDED_SCREEN && high) {
+            inst_drwhigh<Quirks>(regx, regy, length);
+            return;
+        }
+
         bool collided {false};
-        // For every pixel in the sprite (in memory).
-        for (std::size_t y {0}; y < length; ++y) {
-            for (std::size_t x {0}; x < 8; ++x) {
-                // Find out the address translation, both for the screen and the sprite.
-                std::size_t screen_pixel = ((V[regx] + x) % SCREEN_WIDTH)
-                                        + (((V[regy] + y) % SCREEN_HEIGHT) * SCREEN_WIDTH);
-                addr sprite_line = y;
-
-                // Perform a XOR operation when writing the pixel, if it already has had a
-                // value before, a collision has occured, hence, set VF to 1, else not.
-                byte prev_screen {screen_buffer[screen_pixel]};
-                screen_buffer[screen_pixel] ^= (memory.read(I + sprite_line) >> (7 - x)) & 0x01;
-                if (prev_screen == 1 && screen_buffer[screen_pixel] == 0) collided = true;
+        addr sprite_start {I}; // Each selected plane gets the rows after the previous one's.
+        for (std::size_t p {0}; p < PLANES && pending_trap == Trap::Kind::NONE; ++p) {
+            if ((planes >> p & 1) == 0) continue;
+
+            // For every pixel in the sprite (in memory).
+            for (std::size_t y {0}; y < length; ++y) {
+                addr sprite_line = sprite_start + y;
+                if (!memory.readable(sprite_line)) {
+                    fault(Trap::Kind::READ_FAULT);
+                    break; // Rows drawn so far stay, like they always have.
+                }
+
+                byte sprite {memory.load(sprite_line)};
+                for (std::size_t x {0}; x < 8; ++x) {
+                    // Sprites start wrapped around either way, clipping only cuts what goes past the edge.
+                    if (Quirks::CLIP_SPRITES && (V[regx] % SCREEN_WIDTH + x >= SCREEN_WIDTH
+                                                 || V[regy] % SCREEN_HEIGHT + y >= SCREEN_HEIGHT)) continue;
+
+                    // Find out the address translation for the screen.
+                    std::size_t screen_pixel = ((V[regx] + x) % SCREEN_WIDTH)
+                                            + (((V[regy] + y) % SCREEN_HEIGHT) * SCREEN_WIDTH);
+
+                    // Perform a XOR operation when writing the pixel, if it already has had a
+                    // value before, a collision has occured, hence, set VF to 1, else not.
+                    byte drawn = ((sprite >> (7 - x)) & 0x01) << p;
+                    if (screen[screen_pixel] & drawn) collided = true;
+                    screen[screen_pixel] ^= drawn;
+                }
             }
+
+            sprite_start += length;
         }
 
         screen_buffer_updated = true;
+        CH8_COUNT(Counters::local().drew(collided));
         if (collided) V[0x0F] = 1;
         else V[0x0F] = 0;
     }
 
-    void Processor::inst_skpr(byte reg) { if (key_states[V[reg]] == true) PC += 2; }
-    void Processor::inst_sknpr(byte reg) { if (key_states[V[reg]] != true) PC += 2; }
+    template<typename Quirks>
+    void Processor::inst_skpr(byte reg) { skip<Quirks>(key_states[V[reg]] == true); }
+
+    template<typename Quirks>
+    void Processor::inst_sknpr(byte reg) { skip<Quirks>(key_states[V[reg]] != true); }
+
     void Processor::inst_ldrd(byte reg) { V[reg] = DT; }
     void Processor::inst_ldrk(byte reg) {
         // Search if any keys are pressed, assigning
@@ -250,24 +831,237 @@ namespace ch8 {
     }
 
     void Processor::inst_ldbr(byte reg) {
-        memory.write(I, V[reg] / 100);
-        memory.write(I + 1, V[reg] % 100 / 10);
-        memory.write(I + 2, V[reg] % 10);
+        if (!memory.writable(I) || !memory.writable(I + 2)) {
+            fault(Trap::Kind::WRITE_FAULT);
+            return;
+        }
+
+        memory.store(I, V[reg] / 100);
+        memory.store(I + 1, V[reg] % 100 / 10);
+        memory.store(I + 2, V[reg] % 10);
     }
 
+    template<typename Quirks>
     void Processor::inst_ldiar(byte reg) {
+        // Program memory is contiguous, checking both ends checks it all.
+        if (!memory.writable(I) || !memory.writable(I + reg)) {
+            fault(Trap::Kind::WRITE_FAULT);
+            return;
+        }
+
         // Store value of register V0 - Vx
         // to locations I through I + x.
         for (byte i {0}; i <= reg; ++i) {
-            memory.write(I + i, V[i]);
+            memory.store(I + i, V[i]);
         }
+
+        if (Quirks::INCREMENT_I) I += reg + 1;
     }
 
+    template<typename Quirks>
     void Processor::inst_ldrai(byte reg) {
+        // The gap between font and program is wider than 16 registers,
+        // so if both ends are readable everything in between is too.
+        if (!memory.readable(I) || !memory.readable(I + reg)) {
+            fault(Trap::Kind::READ_FAULT);
+            return;
+        }
+
         // Load value of locations I to I + x
         // into register V0 through Vx.
         for (byte i {0}; i <= reg; ++i) {
-            V[i] = memory.read(I + i);
+            V[i] = memory.load(I + i);
+        }
+
+        if (Quirks::INCREMENT_I) I += reg + 1;
+    }
+
+    namespace {
+        // A sprite row of some width at a column of a 128-bit row, as the words to XOR into it.
+        // Whatever goes past the right edge is cut off, or wraps around to the left if asked to.
+        void place(std::uint64_t bits, std::size_t width, std::size_t column, bool wrap, std::uint64_t mask[2]) {
+            if (column + width <= 128) {
+                std::size_t shift {128 - width - column}; // Left, from the rightmost pixel.
+                mask[0] = shift >= 64 ? bits << (shift - 64) : shift == 0 ? 0 : bits >> (64 - shift);
+                mask[1] = shift >= 64 ? 0 : bits << shift;
+            } else {
+                std::size_t over {column + width - 128};
+                mask[0] = wrap ? (bits & ((std::uint64_t {1} << over) - 1)) << (64 - over) : 0;
+                mask[1] = bits >> over;
+            }
+        }
+    }
+
+    template<typename Quirks>
+    void Processor::inst_scd(byte rows) {
+        if (!Quirks::EXTENDED_SCREEN) return;
+        for (std::size_t p {0}; high && p < PLANES; ++p) {
+            if ((planes >> p & 1) == 0) continue;
+            std::memmove(plane[p][rows], plane[p][0], (HIGH_HEIGHT - rows) * sizeof(plane[p][0]));
+            std::memset(plane[p][0], 0, rows * sizeof(plane[p][0]));
+        }
+
+        for (std::size_t y {SCREEN_HEIGHT}; !high && y-- > 0;) {
+            for (std::size_t x {0}; x < SCREEN_WIDTH; ++x)
+                move_pixel(y * SCREEN_WIDTH + x, y >= rows ? screen[(y - rows) * SCREEN_WIDTH + x] : 0);
         }
+
+        screen_buffer_updated = true;
+    }
+
+    template<typename Quirks>
+    void Processor::inst_scr() {
+        if (!Quirks::EXTENDED_SCREEN) return;
+        for (std::size_t p {0}; high && p < PLANES; ++p) {
+            for (std::size_t y {0}; planes >> p & 1 && y < HIGH_HEIGHT; ++y) {
+                plane[p][y][1] = plane[p][y][1] >> 4 | plane[p][y][0] << 60;
+                plane[p][y][0] >>= 4;
+            }
+        }
+
+        for (std::size_t y {0}; !high && y < SCREEN_HEIGHT; ++y) {
+            byte* row {screen + y * SCREEN_WIDTH};
+            for (std::size_t x {SCREEN_WIDTH}; x-- > 0;) move_pixel(y * SCREEN_WIDTH + x, x >= 4 ? row[x - 4] : 0);
+        }
+
+        screen_buffer_updated = true;
+    }
+
+    template<typename Quirks>
+    void Processor::inst_scl() {
+        if (!Quirks::EXTENDED_SCREEN) return;
+        for (std::size_t p {0}; high && p < PLANES; ++p) {
+            for (std::size_t y {0}; planes >> p & 1 && y < HIGH_HEIGHT; ++y) {
+                plane[p][y][0] = plane[p][y][0] << 4 | plane[p][y][1] >> 60;
+                plane[p][y][1] <<= 4;
+            }
+        }
+
+        for (std::size_t y {0}; !high && y < SCREEN_HEIGHT; ++y) {
+            byte* row {screen + y * SCREEN_WIDTH};
+            for (std::size_t x {0}; x < SCREEN_WIDTH; ++x) move_pixel(y * SCREEN_WIDTH + x, x + 4 < SCREEN_WIDTH ? row[x + 4] : 0);
+        }
+
+        screen_buffer_updated = true;
+    }
+
+    template<typename Quirks>
+    void Processor::inst_resolution(bool switched) {
+        if (!Quirks::EXTENDED_SCREEN) return;
+        high = switched;
+        if (high) std::memset(plane, 0, sizeof(plane));
+        else std::memset(screen, 0, SCREEN_WIDTH * SCREEN_HEIGHT);
+        screen_buffer_updated = true;
+    }
+
+    template<typename Quirks>
+    void Processor::inst_drwhigh(byte regx, byte regy, byte length) {
+        std::size_t width {length == 0 ? 16u : 8u}, rows {length == 0 ? 16u : length};
+        std::size_t column {V[regx] % HIGH_WIDTH}, top {V[regy] % HIGH_HEIGHT};
+        bool collided {false};
+        addr sprite_start {I}; // Same as low resolution, planes take their rows one after the other.
+        for (std::size_t p {0}; p < PLANES && pending_trap == Trap::Kind::NONE; ++p) {
+            if ((planes >> p & 1) == 0) continue;
+            for (std::size_t y {0}; y < rows; ++y) {
+                addr sprite_line = sprite_start + y * (width / 8);
+                if (!memory.readable(sprite_line) || !memory.readable(sprite_line + width / 8 - 1)) {
+                    fault(Trap::Kind::READ_FAULT);
+                    break; // Rows drawn so far stay, same as low resolution.
+                }
+
+                if (Quirks::CLIP_SPRITES && top + y >= HIGH_HEIGHT) break;
+                std::uint64_t bits {memory.load(sprite_line)};
+                if (width == 16) bits = bits << 8 | memory.load(sprite_line + 1);
+
+                std::uint64_t mask[2];
+                place(bits, width, column, !Quirks::CLIP_SPRITES, mask);
+                std::uint64_t* row {plane[p][(top + y) % HIGH_HEIGHT]};
+                collided = collided || (row[0] & mask[0]) != 0 || (row[1] & mask[1]) != 0;
+                row[0] ^= mask[0];
+                row[1] ^= mask[1];
+            }
+
+            sprite_start += rows * (width / 8);
+        }
+
+        screen_buffer_updated = true;
+        CH8_COUNT(Counters::local().drew(collided));
+        V[0x0F] = collided;
+    }
+
+    template<typename Quirks>
+    void Processor::inst_saverr(byte regx, byte regy) {
+        if (!Quirks::XO_EXTENSIONS) {
+            fault(Trap::Kind::INVALID_OPCODE);
+            return;
+        }
+
+        std::size_t count {(regx > regy ? regx - regy : regy - regx) + 1u};
+        if (!memory.writable(I) || !memory.writable(I + count - 1)) {
+            fault(Trap::Kind::WRITE_FAULT);
+            return;
+        }
+
+        for (std::size_t i {0}; i < count; ++i) memory.store(I + i, V[regx > regy ? regx - i : regx + i]);
+    }
+
+    template<typename Quirks>
+    void Processor::inst_loadrr(byte regx, byte regy) {
+        if (!Quirks::XO_EXTENSIONS) {
+            fault(Trap::Kind::INVALID_OPCODE);
+            return;
+        }
+
+        std::size_t count {(regx > regy ? regx - regy : regy - regx) + 1u};
+        if (!memory.readable(I) || !memory.readable(I + count - 1)) {
+            fault(Trap::Kind::READ_FAULT);
+            return;
+        }
+
+        for (std::size_t i {0}; i < count; ++i) V[regx > regy ? regx - i : regx + i] = memory.load(I + i);
+    }
+
+    template<typename Quirks>
+    void Processor::inst_ldil() {
+        if (!Quirks::XO_EXTENSIONS) {
+            fault(Trap::Kind::INVALID_OPCODE);
+            return;
+        }
+
+        // PC is on the second byte of F000, the address is in the two after it.
+        if (!memory.readable(PC + 1) || !memory.readable(PC + 2)) {
+            fault(Trap::Kind::READ_FAULT);
+            return;
+        }
+
+        I = memory.load(PC + 1) << 8 | memory.load(PC + 2);
+        PC += 2;
+    }
+
+    template<typename Quirks>
+    void Processor::inst_plane(byte mask) {
+        if (!Quirks::XO_EXTENSIONS) fault(Trap::Kind::INVALID_OPCODE);
+        else planes = mask & ((1u << PLANES) - 1); // Planes this build doesn't have are never drawn.
+    }
+
+    template<typename Quirks>
+    void Processor::inst_audio() {
+        if (!Quirks::XO_EXTENSIONS) {
+            fault(Trap::Kind::INVALID_OPCODE);
+            return;
+        }
+
+        if (!memory.readable(I) || !memory.readable(I + PATTERN_SIZE - 1)) {
+            fault(Trap::Kind::READ_FAULT);
+            return;
+        }
+
+        for (std::size_t i {0}; i < PATTERN_SIZE; ++i) pattern[i] = memory.load(I + i);
+    }
+
+    template<typename Quirks>
+    void Processor::inst_pitch(byte reg) {
+        if (!Quirks::XO_EXTENSIONS) fault(Trap::Kind::INVALID_OPCODE);
+        else pitch = V[reg];
     }
 }
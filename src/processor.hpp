@@ -2,13 +2,19 @@
 #define CH8_PROCESSOR_HPP
 
 #include <random>
+#include <vector>
+#include <cstdint>
 #include <stdexcept>
 #include "definitions.hpp"
 #include "memory.hpp"
 #include "interpreter.hpp"
+#include "quirks.hpp"
 
 namespace ch8 {
-    class Processor {
+    class TraceWriter;
+    class Debugger;
+
+    class Processor : private CodeWatcher {
     public:
         enum class Register {
             V0 = 0, V1, V2, V3, V4,
@@ -17,43 +23,161 @@ namespace ch8 {
             ST, DT, PC, I, SP
         };
 
+        // What stopped the processor, if anything did. Faulting instructions don't throw by
+        // default, the processor records the fault here and stops, just like on EXIT.
+        struct Trap {
+            enum class Kind {
+                NONE, // Still running, or stopped by EXIT or halt.
+                INVALID_OPCODE, // Not in the instruction set.
+                READ_FAULT, // Read outside of font and program memory, fetches included.
+                WRITE_FAULT, // Write outside of program memory.
+                STACK_OVERFLOW // CALL with every stack place already taken.
+            };
+
+            Kind kind;
+            addr PC; // Address of the faulting instruction, PC is left pointing there too.
+            word opcode; // The faulting instruction, zero if it couldn't even be fetched.
+        };
+
+        enum class FaultPolicy {
+            TRAP, // Record the fault and stop, the default.
+            THROW // Same, but then throw std::out_of_range or std::runtime_error too.
+        };
+
         // Probably won't change,  but it's nice anyway.
         static constexpr std::size_t SCREEN_WIDTH  {64};
         static constexpr std::size_t SCREEN_HEIGHT {32};
+        static constexpr std::size_t HIGH_WIDTH {128}; // SUPER-CHIP's high resolution mode.
+        static constexpr std::size_t HIGH_HEIGHT {64};
+#ifdef CH8_XO_CHIP
+        static constexpr std::size_t PLANES {2}; // XO-CHIP's bit planes, FN01 picks which ones are drawn on.
+#else
+        static constexpr std::size_t PLANES {1}; // Builds without XO-CHIP memory don't need the second one either.
+#endif
+        static constexpr addr PROGRAM_INIT {0x200};
+        static constexpr std::size_t STACK_SIZE {16 + 1}; // + 1 since first is never used.
 
         Processor(Memory&); // Always needs main memory.
+        Processor(Memory&, unsigned); // Same as above, but with a fixed seed for reproducible runs.
+        ~Processor(); // Stops watching memory for code writes.
+        Processor(const Processor&) = delete; // Display buffer may point to itself, don't alias it.
+        Processor& operator=(const Processor&) = delete;
+        void reset(unsigned); // Back to the constructed state, but keeps memory and display binding.
         bool running() const { return still_running; } // Is the program still running?
-        void execute(Instruction, byte, byte); // Executes the instruction with arguments given.
+        void halt() { still_running = false; } // Stops the program, e.g. after it has faulted.
+        void execute(Instruction inst, byte upper, byte lower) { // Executes the instruction with arguments given.
+            (this->*executor)(inst, upper, lower);
+            if (pending_trap != Trap::Kind::NONE) raise(PC, upper, lower);
+        }
+
         bool display_updated() const { return screen_buffer_updated; }
         void updated_display() { screen_buffer_updated = false; }
-        void step(); // Steps the processor state forward.
+        void step() { (this->*stepper)(); } // Steps the processor state forward.
+        std::size_t run(std::size_t steps) { return (this->*runner)(steps); } // Steps up to n times, or until exit. Returns steps taken.
+        void seed(unsigned s) { random_generator.seed(s); } // Reseeds RND, for reproducible runs.
+        void profile(Profile); // Switches to the handlers for a quirk profile, kept across reset and restore. XO-CHIP needs XO_CHIP=YES.
+        Profile profile() const { return quirk_profile; }
+        void fault_policy(FaultPolicy policy) { faults = policy; } // Kept across reset and restore.
+        void trace(TraceWriter*); // Records every instruction from now on, null to stop. Runs without predecoding.
+        void debug(Debugger*); // Stops before breakpoints from now on, still running, null to stop checking.
+        void warm(const std::vector<addr>&); // Predecodes these for run(), e.g. every instruction Analyser found.
+        const Trap& trap() const { return trap_state; } // Cleared again by reset.
+        bool trapped() const { return trap_state.kind != Trap::Kind::NONE; }
+        static const char* trap_name(Trap::Kind); // E.g. "invalid opcode", for reporting.
 
         // Outputs to emulated IO.
-        const byte* display_buffer() const { return screen_buffer; } // Needs to be drawn for real later.
+        const byte* display_buffer() const { return screen; } // Needs to be drawn for real later. Bit p is plane p.
+        void bind_display(byte*); // Draws straight into an external buffer of the same size from now on.
+        bool high_resolution() const { return high; } // Showing the one below instead, only after 00FF.
+        byte selected_planes() const { return planes; } // Mask of the planes sprites are drawn on, set by FN01.
+        const std::uint64_t* high_display() const { return plane[0][0]; } // Rows of two words, leftmost pixel in the top bit,
+                                                                          // each of the PLANES after the one before.
         bool sound_issued() const { return ST != 0; } // Upper abstraction needs to sound beep.
         bool delay_issued() const { return DT != 0; } // Both timers need to be counted down.
+        const byte* audio_pattern() const { return pattern; } // XO-CHIP's 128 1-bit samples, loaded by F002.
+        byte audio_pitch() const { return pitch; } // Set by FX3A, plays at 4000 * 2^((pitch - 64) / 48) Hz.
 
         // Inputs from emulated IO.
         void key_pressed(byte k) { key_states[k] = true; } // Key has been pressed.
         void key_released(byte k) { key_states[k] = false; } // Key has been released.
+        void key_mask(word); // Sets all keys at once, bit k of the mask is the state of key k.
         void tick_sound() { --ST; } // Issued every 60 Hz whenever sound state is non-zero.
         void tick_delay() { --DT; } // Issued every 60 Hz whenever delay state is non-zero.
+        void tick_timers(); // Ticks both of the above, but only the ones that are non-zero.
 
         word register_state(Register) const; // Returns the state of a register (dump), for debugging.
+        const word* call_stack() const { return stack; } // Entries 1 up to SP are live, each one past its CALL.
         void dump() const; // Dumps entire state to stdout.
 
+        struct Snapshot; // Entire machine state, including main memory. Trivially copyable.
+        void save(Snapshot&) const; // Saves state of both the processor and its memory.
+        void restore(const Snapshot&); // Restores the above, the display binding is kept.
+
     private:
+        // Everything quirk dependent is instantiated once per profile, the ones
+        // below point to the instantiations for the profile currently in use.
+        template<typename Quirks> void step_with();
+        template<typename Quirks> std::size_t run_with(std::size_t);
+        template<typename Quirks> void execute_with(Instruction, byte, byte);
+        template<typename Quirks> void traced_step();
+        template<typename Quirks> std::size_t traced_run(std::size_t);
+        template<typename Quirks> void debugged_step();
+        template<typename Quirks> std::size_t debugged_run(std::size_t); // Runs whole blocks between checks.
+        template<typename Quirks> void select(); // Points the ones below at the instantiations for these quirks.
+        Profile quirk_profile {Profile::LEGACY};
+        TraceWriter* tracer {nullptr};
+        Debugger* debugger {nullptr};
+        void (Processor::*stepper)() {&Processor::step_with<quirks::Legacy>};
+        std::size_t (Processor::*runner)(std::size_t) {&Processor::run_with<quirks::Legacy>};
+        void (Processor::*executor)(Instruction, byte, byte) {&Processor::execute_with<quirks::Legacy>};
+
+        // Instructions only flag faults, which are recorded (and maybe thrown) once they
+        // return, so handlers stay small and the common path never has to unwind anything.
+        FaultPolicy faults {FaultPolicy::TRAP};
+        Trap trap_state {Trap::Kind::NONE, 0x0000, 0x0000};
+        Trap::Kind pending_trap {Trap::Kind::NONE};
+        void fault(Trap::Kind kind) { pending_trap = kind; still_running = false; }
+        void raise(addr, byte, byte); // Records the pending trap at the address given, throws if asked to.
+
+        // Instructions decoded once per address for run(). The addresses they were decoded from
+        // are marked as code in memory, so writes there throw away just the entries affected.
+        // Common idioms are fused into a single dispatch, and only used when they are what's
+        // in memory, so jumping into the middle of one simply dispatches from there instead.
+        enum class Fusion : byte {
+            NONE, // On its own.
+            LOAD_DRAW, // LD I, nnn and then DRW.
+            ADD_SKIP_JUMP, // ADD Vx, kk then SE/SNE Vx, kk then JP, the usual counted loop.
+            DELAY_SKIP_JUMP // LD Vx, DT then SE/SNE Vx, kk then JP, waiting for the delay timer.
+        };
+
+        struct Decoded {
+            word opcode; // What this was decoded from.
+            Instruction instruction;
+            bool jump; // Leaves the PC alone after executing.
+            Fusion fusion;
+            byte length; // Instructions covered, one unless fused.
+            byte flags_dead; // VF is overwritten this many instructions later, zero if it may be read.
+            byte checked; // Instructions marked as code, the ones above depend on all of them. Zero if stale.
+            word tail[3]; // Instructions after this one, as they were when decoded.
+        };
+
+        static constexpr byte LOOKAHEAD {3}; // Most instructions after one that are ever looked at.
+        std::vector<Decoded> decoded; // By address, allocated on the first run.
+        const Decoded& predecoded(addr); // Decodes again if the entry has been thrown away.
+        void watch_code(); // Starts watching memory, if not already, with nothing decoded yet.
+        void code_written(addr) override;
+        void code_flushed() override;
+        template<typename Quirks> std::size_t execute_fused(const Decoded&);
+        template<typename Quirks> void execute_flagless(const Decoded&); // ALU ops, without setting VF.
+
         bool still_running {true};
         Memory& memory; // Reference to main memory.
         static bool jump_inst(Instruction); // Checks if this is a jump instruction.
         byte V[16] = {0}; // General purpose registers (8-bits), V0 - VF.
         byte ST {0}, DT {0}; // Special purpose registers, sound and delay timers.
 
-        static constexpr addr PROGRAM_INIT {0x200};
         addr PC {PROGRAM_INIT}, I {0x0000}; // Program Counter and address storage register I.
         byte SP {0x00}; // Stack pointer, only need 16 places (officially) so 8-bits suffice.
-
-        static constexpr std::size_t STACK_SIZE {16 + 1}; // + 1 since first is never used.
         word stack[STACK_SIZE] = {0}; // The 16-bit sized stack places, usually contains return addresses.
 
         std::mt19937 random_generator; // Will be given a random seed from device.
@@ -66,37 +190,49 @@ namespace ch8 {
         // The 64x32 sized screen needs to store its state. Instructions // affecting the screen modify
         // this, higher implementation will use // this. A zero represents no color, a one is color :).
         byte screen_buffer[SCREEN_WIDTH * SCREEN_HEIGHT] = { 0 }; // Buffer for the emulator for later.
+        byte* screen {screen_buffer}; // Where instructions draw, the buffer above unless bound elsewhere.
+
+        // SUPER-CHIP's 128x64 screen, packed so scrolls are shifts and sprite rows a couple of XORs.
+        bool high {false};
+        std::uint64_t plane[PLANES][HIGH_HEIGHT][2] = {{{0}}};
+        byte planes {0x01}; // Mask of the planes drawn on, only XO-CHIP can select any but the first.
+        void move_pixel(std::size_t pixel, byte from) { screen[pixel] = (screen[pixel] & ~planes) | (from & planes); } // Scrolls.
+
+        static constexpr std::size_t PATTERN_SIZE {16};
+        byte pattern[PATTERN_SIZE] = {0}; // XO-CHIP audio, played while the sound timer runs.
+        byte pitch {64}; // 4000 Hz.
 
         // Shitload of instructions below.
+        template<typename Quirks> void skip(bool); // Skips the next instruction if asked to, all 4 bytes of F000 NNNN.
         void inst_cls(); // Clear screen.
         void inst_ret(); // Returns to the address pointed by SP.
         void inst_jpa(addr); // Jumps to the target address.
         void inst_calla(addr); // Jumps to the target address and sets the return address.
 
-        void inst_serc(byte, byte); // Skips next instruction if register is equal to constant.
-        void inst_snerc(byte, byte); // Skips next instruction if register is NOT equal to constant.
-        void inst_serr(byte, byte); // Skips next instruction if both registers are equal.
+        template<typename Quirks> void inst_serc(byte, byte); // Skips next instruction if register is equal to constant.
+        template<typename Quirks> void inst_snerc(byte, byte); // Skips next instruction if register is NOT equal to constant.
+        template<typename Quirks> void inst_serr(byte, byte); // Skips next instruction if both registers are equal.
         void inst_ldrc(byte, byte); // Loads constant to register.
         void inst_addrc(byte, byte); // Adds constant to register.
 
         void inst_ldrr(byte, byte); // Loads value of a certain register to another.
-        void inst_orrr(byte, byte); // Performs a bitwise OR operation on both registers.
-        void inst_andrr(byte, byte); // Performs a bitwise AND operation on both registers.
-        void inst_xorrr(byte, byte); // Performs a bitwise XOR operation on both registers.
+        template<typename Quirks> void inst_orrr(byte, byte); // Performs a bitwise OR operation on both registers.
+        template<typename Quirks> void inst_andrr(byte, byte); // Performs a bitwise AND operation on both registers.
+        template<typename Quirks> void inst_xorrr(byte, byte); // Performs a bitwise XOR operation on both registers.
         void inst_addrr(byte, byte); // Adds register content to another register.
         void inst_subrr(byte, byte); // Subtracts register from another register.
-        void inst_shrrr(byte, byte); // Shifts first register right by one digit.
+        template<typename Quirks> void inst_shrrr(byte, byte); // Shifts first register right by one digit.
         void inst_subnrr(byte, byte); // Subtracts register from another register, inverse.
-        void inst_shlrr(byte, byte); // Shifts first register left by one digit.
+        template<typename Quirks> void inst_shlrr(byte, byte); // Shifts first register left by one digit.
 
-        void inst_snerr(byte, byte); // Skips next instruction if NOT equal.
+        template<typename Quirks> void inst_snerr(byte, byte); // Skips next instruction if NOT equal.
         void inst_ldia(addr); // Loads a certain constant address to I register.
-        void inst_jpv0a(addr); // Jumps to a certain address offset by register V0.
+        template<typename Quirks> void inst_jpv0a(addr); // Jumps to a certain address offset by register V0.
         void inst_rndrc(byte, byte); // Assign random value to register, limited to constant.
-        void inst_drwrrc(byte, byte, byte); // Draw sprite from memory, at register location.
+        template<typename Quirks> void inst_drwrrc(byte, byte, byte); // Draw sprite from memory, at register location.
 
-        void inst_skpr(byte); // Skips next instruction if key is pressed.
-        void inst_sknpr(byte); // Do NOT skip next instruction if key is pressed.
+        template<typename Quirks> void inst_skpr(byte); // Skips next instruction if key is pressed.
+        template<typename Quirks> void inst_sknpr(byte); // Do NOT skip next instruction if key is pressed.
         void inst_ldrd(byte); // Loads value of register to delay timer.
         void inst_ldrk(byte); // Load the identifier of the pressed key.
         void inst_lddr(byte); // Loads the value of register into delay timer.
@@ -105,8 +241,43 @@ namespace ch8 {
 
         void inst_ldfr(byte); // Loads address of font stored in register to I.
         void inst_ldbr(byte); // Store BCD representation of number in memory starting at I.
-        void inst_ldiar(byte); // Store registers V0 - VX to memory starting at address I.
-        void inst_ldrai(byte); // Load registers V0 - Vx with values stored in I.
+        template<typename Quirks> void inst_ldiar(byte); // Store registers V0 - VX to memory starting at address I.
+        template<typename Quirks> void inst_ldrai(byte); // Load registers V0 - Vx with values stored in I.
+
+        // SUPER-CHIP, ignored like SYS unless the quirks have its screen.
+        template<typename Quirks> void inst_scd(byte); // Scrolls the screen down by a number of rows.
+        template<typename Quirks> void inst_scr(); // Scrolls the screen right by 4 pixels.
+        template<typename Quirks> void inst_scl(); // Scrolls the screen left by 4 pixels.
+        template<typename Quirks> void inst_resolution(bool); // Switches to the high resolution screen or back, clearing it.
+        template<typename Quirks> void inst_drwhigh(byte, byte, byte); // DRW on the high resolution screen, 16x16 if zero rows.
+
+        // XO-CHIP, invalid opcodes in other profiles.
+        template<typename Quirks> void inst_saverr(byte, byte); // Stores VX through VY at I, backwards if X > Y. Leaves I.
+        template<typename Quirks> void inst_loadrr(byte, byte); // Loads VX through VY from I, the same way.
+        template<typename Quirks> void inst_ldil(); // Loads the address in the next word to I, and skips past it.
+        template<typename Quirks> void inst_plane(byte); // Selects the planes drawn on, by mask.
+        template<typename Quirks> void inst_audio(); // Loads the audio pattern from I.
+        template<typename Quirks> void inst_pitch(byte); // Sets the audio pitch from a register.
+    };
+
+    struct Processor::Snapshot {
+        static constexpr std::uint32_t MAGIC {0x43483853}; // "CH8S", to detect garbage on restore.
+        std::uint32_t magic;
+        byte memory[Memory::SIZE];
+        byte V[16];
+        byte ST, DT, SP;
+        addr PC, I;
+        word stack[STACK_SIZE];
+        word keys; // As a mask, bit k is key k.
+        bool running;
+        Trap trap;
+        std::mt19937 random_generator;
+        byte screen[SCREEN_WIDTH * SCREEN_HEIGHT];
+        bool high;
+        std::uint64_t plane[PLANES][HIGH_HEIGHT][2];
+        byte planes;
+        byte pattern[PATTERN_SIZE];
+        byte pitch;
     };
 }
 
@@ -0,0 +1,329 @@
+#include "processor_batch.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+
+namespace ch8 {
+    constexpr std::size_t ProcessorBatch::SCREEN_SIZE;
+    constexpr std::size_t ProcessorBatch::STACK_SIZE;
+    constexpr addr ProcessorBatch::PROGRAM_INIT;
+    ProcessorBatch::ProcessorBatch(const byte* program, std::size_t program_size, std::size_t count, unsigned seed)
+        : lane_count {count}, ST(count), DT(count), SP(count), PC(count, PROGRAM_INIT), I(count),
+          keys(count), lane_running(count, 1), lane_faulted(count), screen_buffers(count * SCREEN_SIZE),
+          memories(count, Memory {program, program_size}), memory_written(count) {
+        for (std::vector<byte>& registers : V) registers.resize(count);
+        for (std::vector<word>& entries : stack) entries.resize(count);
+        for (std::size_t lane {0}; lane < count; ++lane) {
+            random_generators.emplace_back(seed + lane); // Same as a Processor seeded like this.
+        }
+
+        active.reserve(count);
+        codes.resize(count);
+    }
+
+    std::size_t ProcessorBatch::running() const {
+        std::size_t count {0};
+        for (std::size_t lane {0}; lane < lane_count; ++lane) count += lane_running[lane];
+        return count;
+    }
+
+    std::size_t ProcessorBatch::run(std::size_t steps) {
+        std::size_t taken {0};
+        while (taken < steps && running() != 0) {
+            step();
+            ++taken;
+        }
+
+        return taken;
+    }
+
+    void ProcessorBatch::step() {
+        last_groups = 1;
+        if (converged()) {
+            execute(AllLanes {lane_count});
+            return;
+        }
+
+        // Stopped lanes are left out, the running ones are grouped by PC and the instruction there.
+        active.clear();
+        for (std::size_t lane {0}; lane < lane_count; ++lane) {
+            if (!lane_running[lane]) continue;
+            active.push_back(lane);
+            codes[lane] = static_cast<std::uint32_t>(PC[lane]) << 16 | opcode_at(lane);
+        }
+
+        last_groups = 0;
+        if (active.empty()) return;
+        std::uint32_t code {codes[active[0]]};
+        if (std::all_of(active.begin(), active.end(), [this, code](std::size_t lane) { return codes[lane] == code; })) {
+            last_groups = 1; // Still together, only some have stopped.
+            execute(SomeLanes {active.data(), active.size()});
+            return;
+        }
+
+        std::stable_sort(active.begin(), active.end(),
+                         [this](std::size_t a, std::size_t b) { return codes[a] < codes[b]; });
+        for (std::size_t begin {0}, end; begin < active.size(); begin = end) {
+            for (end = begin; end < active.size() && codes[active[end]] == codes[active[begin]]; ++end) {}
+            execute(SomeLanes {&active[begin], end - begin});
+            ++last_groups;
+        }
+    }
+
+    bool ProcessorBatch::converged() const {
+        byte all_running {1};
+        addr pc {PC[0]};
+        for (std::size_t lane {0}; lane < lane_count; ++lane) {
+            all_running &= lane_running[lane] & (PC[lane] == pc);
+        }
+
+        // Only lanes that wrote to their memory can have something else there.
+        if (!all_running || written_lanes == 0) return all_running;
+        word opcode {opcode_at(0)};
+        for (std::size_t lane {0}; lane < lane_count; ++lane) {
+            if (memory_written[lane] && opcode_at(lane) != opcode) return false;
+        }
+
+        return true;
+    }
+
+    word ProcessorBatch::opcode_at(std::size_t lane) const {
+        const Memory& memory {memories[lane]};
+        if (!memory.readable(PC[lane]) || !memory.readable(PC[lane] + 1)) return 0x0000; // Same for every lane at this PC.
+        return memory.load(PC[lane]) << 8 | memory.load(PC[lane] + 1);
+    }
+
+    template<typename Lanes>
+    void ProcessorBatch::execute(const Lanes& lanes) {
+        // Every lane in the selection has the same PC and code, so fetch and parse once.
+        std::size_t first {lanes[0]};
+        if (!memories[first].readable(PC[first]) || !memories[first].readable(PC[first] + 1)) {
+            fault(lanes);
+            return;
+        }
+
+        byte instruction_upper {memories[first].load(PC[first])};
+        byte instruction_lower {memories[first].load(PC[first] + 1)};
+        Instruction instruction {Interpreter::decode(instruction_upper, instruction_lower)};
+
+        for (std::size_t i {0}; i < lanes.size(); ++i) ++PC[lanes[i]];
+        execute(instruction, instruction_upper, instruction_lower, lanes);
+        // Lanes that faulted are left on the faulting instruction, like Processor does. None had before.
+        if (instruction != Instruction::JP_A && instruction != Instruction::JP_V0A &&
+            instruction != Instruction::CALL_A) {
+            for (std::size_t i {0}; i < lanes.size(); ++i) PC[lanes[i]] += 1 - 2 * lane_faulted[lanes[i]];
+        } else {
+            for (std::size_t i {0}; i < lanes.size(); ++i) PC[lanes[i]] -= lane_faulted[lanes[i]];
+        }
+    }
+
+    template<typename Lanes>
+    void ProcessorBatch::fault(const Lanes& lanes) {
+        for (std::size_t i {0}; i < lanes.size(); ++i) {
+            lane_running[lanes[i]] = 0;
+            lane_faulted[lanes[i]] = 1;
+        }
+    }
+
+    void ProcessorBatch::write(std::size_t lane, addr address, byte data) {
+        memories[lane].store(address, data); // Already checked by the instruction.
+        if (!memory_written[lane]) {
+            memory_written[lane] = 1;
+            ++written_lanes;
+        }
+    }
+
+    template<typename Lanes>
+    void ProcessorBatch::execute(Instruction inst, byte inst_upper, byte inst_lower, const Lanes& lanes) {
+        byte x = Interpreter::parse_argument(Argument::X, inst_upper, inst_lower);
+        byte y = Interpreter::parse_argument(Argument::Y, inst_upper, inst_lower);
+        word address = Interpreter::parse_argument(Argument::ADDRESS, inst_upper, inst_lower);
+        byte constant = Interpreter::parse_argument(Argument::CONSTANT, inst_upper, inst_lower);
+        const std::size_t n {lanes.size()};
+        byte* vx {V[x].data()};
+        byte* vy {V[y].data()};
+        byte* vf {V[0x0F].data()};
+        addr* pc {PC.data()};
+
+        // Semantics are the same as the handlers in Processor, one loop per instruction.
+        // Lanes with bad memory accesses are stopped, instead of the whole batch.
+        switch (inst) {
+        case Instruction::SYS_A: case Instruction::SCD_C: case Instruction::SCR:
+        case Instruction::SCL: case Instruction::LOW: case Instruction::HIGH: break; // Legacy semantics only.
+        case Instruction::CLS:
+            for (std::size_t i {0}; i < n; ++i) std::memset(&screen_buffers[lanes[i] * SCREEN_SIZE], 0, SCREEN_SIZE);
+            break;
+        case Instruction::RET:
+            for (std::size_t i {0}; i < n; ++i) {
+                std::size_t l {lanes[i]};
+                if (SP[l] == 0) pc[l] = stack[0][l];
+                else pc[l] = stack[SP[l]--][l];
+            } break;
+        case Instruction::JP_A: for (std::size_t i {0}; i < n; ++i) pc[lanes[i]] = address; break;
+        case Instruction::CALL_A:
+            for (std::size_t i {0}; i < n; ++i) {
+                std::size_t l {lanes[i]};
+                if (SP[l] + 1u >= STACK_SIZE) fault(SomeLanes {&l, 1}); // Would overflow the stack.
+                else {
+                    stack[++SP[l]][l] = pc[l];
+                    pc[l] = address;
+                }
+            } break;
+
+        case Instruction::SE_RC: for (std::size_t i {0}; i < n; ++i) pc[lanes[i]] += (vx[lanes[i]] == constant) * 2; break;
+        case Instruction::SNE_RC: for (std::size_t i {0}; i < n; ++i) pc[lanes[i]] += (vx[lanes[i]] != constant) * 2; break;
+        case Instruction::SE_RR: for (std::size_t i {0}; i < n; ++i) pc[lanes[i]] += (vx[lanes[i]] == vy[lanes[i]]) * 2; break;
+        case Instruction::LD_RC: for (std::size_t i {0}; i < n; ++i) vx[lanes[i]] = constant; break;
+        case Instruction::ADD_RC: for (std::size_t i {0}; i < n; ++i) vx[lanes[i]] += constant; break;
+
+        case Instruction::LD_RR: for (std::size_t i {0}; i < n; ++i) vx[lanes[i]] = vy[lanes[i]]; break;
+        case Instruction::OR_RR: for (std::size_t i {0}; i < n; ++i) vx[lanes[i]] |= vy[lanes[i]]; break;
+        case Instruction::AND_RR: for (std::size_t i {0}; i < n; ++i) vx[lanes[i]] &= vy[lanes[i]]; break;
+        case Instruction::XOR_RR: for (std::size_t i {0}; i < n; ++i) vx[lanes[i]] ^= vy[lanes[i]]; break;
+        case Instruction::ADD_RR:
+            for (std::size_t i {0}; i < n; ++i) {
+                std::size_t l {lanes[i]};
+                word sum = vx[l] + vy[l];
+                vx[l] = static_cast<byte>(sum);
+                vf[l] = static_cast<byte>(sum >> 8);
+            } break;
+        case Instruction::SUB_RR:
+            for (std::size_t i {0}; i < n; ++i) {
+                std::size_t l {lanes[i]};
+                vf[l] = vx[l] >= vy[l]; // Flag is set first, just like Processor does.
+                vx[l] -= vy[l];
+            } break;
+        case Instruction::SHR_RR:
+            for (std::size_t i {0}; i < n; ++i) {
+                std::size_t l {lanes[i]};
+                vf[l] = vx[l] == 0x01;
+                vx[l] >>= 1;
+            } break;
+        case Instruction::SUBN_RR:
+            for (std::size_t i {0}; i < n; ++i) {
+                std::size_t l {lanes[i]};
+                vf[l] = vy[l] >= vx[l];
+                vx[l] = vy[l] - vx[l];
+            } break;
+        case Instruction::SHL_RR:
+            for (std::size_t i {0}; i < n; ++i) {
+                std::size_t l {lanes[i]};
+                vf[l] = vx[l] >> 7;
+                vx[l] <<= 1;
+            } break;
+
+        case Instruction::SNE_RR: for (std::size_t i {0}; i < n; ++i) pc[lanes[i]] += (vx[lanes[i]] != vy[lanes[i]]) * 2; break;
+        case Instruction::LD_IA: for (std::size_t i {0}; i < n; ++i) I[lanes[i]] = address; break;
+        case Instruction::JP_V0A: for (std::size_t i {0}; i < n; ++i) pc[lanes[i]] = address + V[0][lanes[i]]; break;
+        case Instruction::RND_RC:
+            for (std::size_t i {0}; i < n; ++i) {
+                std::size_t l {lanes[i]};
+                vx[l] = random_udistribution(random_generators[l]) & constant;
+            } break;
+        case Instruction::DRW_RRC:
+            for (std::size_t i {0}; i < n; ++i) {
+                std::size_t l {lanes[i]};
+                byte* screen_buffer {&screen_buffers[l * SCREEN_SIZE]};
+                bool collided {false}, faulted {false};
+                for (std::size_t row {0}; row < (constant & 0x0Fu); ++row) {
+                    addr sprite_line = I[l] + row;
+                    if (!memories[l].readable(sprite_line)) {
+                        faulted = true;
+                        break;
+                    }
+
+                    byte sprite {memories[l].load(sprite_line)};
+                    std::size_t screen_row {((vy[l] + row) % Processor::SCREEN_HEIGHT) * Processor::SCREEN_WIDTH};
+                    for (std::size_t column {0}; column < 8; ++column) {
+                        std::size_t screen_pixel {screen_row + (vx[l] + column) % Processor::SCREEN_WIDTH};
+                        byte pixel = (sprite >> (7 - column)) & 0x01;
+                        collided |= screen_buffer[screen_pixel] & pixel;
+                        screen_buffer[screen_pixel] ^= pixel;
+                    }
+                }
+
+                if (faulted) fault(SomeLanes {&l, 1});
+                else vf[l] = collided;
+            } break;
+        case Instruction::SKP_R:
+            for (std::size_t i {0}; i < n; ++i) {
+                std::size_t l {lanes[i]};
+                pc[l] += (vx[l] < 16 && ((keys[l] >> vx[l]) & 0x0001)) * 2;
+            } break;
+        case Instruction::SKNP_R:
+            for (std::size_t i {0}; i < n; ++i) {
+                std::size_t l {lanes[i]};
+                pc[l] += !(vx[l] < 16 && ((keys[l] >> vx[l]) & 0x0001)) * 2;
+            } break;
+        case Instruction::LD_RD: for (std::size_t i {0}; i < n; ++i) vx[lanes[i]] = DT[lanes[i]]; break;
+        case Instruction::LD_RK:
+            for (std::size_t i {0}; i < n; ++i) {
+                std::size_t l {lanes[i]};
+                if (keys[l] == 0x0000) pc[l] -= 2; // Repeat until a key is pressed.
+                else for (byte k {0}; k < 16; ++k) {
+                    if ((keys[l] >> k) & 0x0001) {
+                        vx[l] = k;
+                        break;
+                    }
+                }
+            } break;
+        case Instruction::LD_DR: for (std::size_t i {0}; i < n; ++i) DT[lanes[i]] = vx[lanes[i]]; break;
+        case Instruction::LD_SR: for (std::size_t i {0}; i < n; ++i) ST[lanes[i]] = vx[lanes[i]]; break;
+        case Instruction::ADD_IR: for (std::size_t i {0}; i < n; ++i) I[lanes[i]] += vx[lanes[i]]; break;
+
+        case Instruction::LD_FR:
+            for (std::size_t i {0}; i < n; ++i) {
+                std::size_t l {lanes[i]};
+                if (vx[l] <= 0x0F) I[l] = vx[l] * Interpreter::FONT_HEIGHT;
+            } break;
+        case Instruction::LD_BR:
+            for (std::size_t i {0}; i < n; ++i) {
+                std::size_t l {lanes[i]};
+                if (!memories[l].writable(I[l]) || !memories[l].writable(I[l] + 2)) fault(SomeLanes {&l, 1});
+                else {
+                    write(l, I[l], vx[l] / 100);
+                    write(l, I[l] + 1, vx[l] % 100 / 10);
+                    write(l, I[l] + 2, vx[l] % 10);
+                }
+            } break;
+        case Instruction::LD_IAR:
+            for (std::size_t i {0}; i < n; ++i) {
+                std::size_t l {lanes[i]};
+                if (!memories[l].writable(I[l]) || !memories[l].writable(I[l] + x)) fault(SomeLanes {&l, 1});
+                else for (byte r {0}; r <= x; ++r) write(l, I[l] + r, V[r][l]);
+            } break;
+        case Instruction::LD_RAI:
+            for (std::size_t i {0}; i < n; ++i) {
+                std::size_t l {lanes[i]};
+                if (!memories[l].readable(I[l]) || !memories[l].readable(I[l] + x)) fault(SomeLanes {&l, 1});
+                else for (byte r {0}; r <= x; ++r) V[r][l] = memories[l].load(I[l] + r);
+            } break;
+        case Instruction::EXIT: for (std::size_t i {0}; i < n; ++i) lane_running[lanes[i]] = 0; break;
+        default: fault(lanes); break;
+        }
+    }
+
+    void ProcessorBatch::tick_timers() {
+        for (std::size_t lane {0}; lane < lane_count; ++lane) {
+            ST[lane] -= ST[lane] != 0;
+            DT[lane] -= DT[lane] != 0;
+        }
+    }
+
+    word ProcessorBatch::register_state(std::size_t lane, Register reg) const {
+        switch (reg) {
+        case Register::V0: case Register::V1: case Register::V2:
+        case Register::V3: case Register::V4: case Register::V5:
+        case Register::V6: case Register::V7: case Register::V8:
+        case Register::V9: case Register::VA: case Register::VB:
+        case Register::VC: case Register::VD: case Register::VE:
+        case Register::VF: return V[static_cast<byte>(reg)][lane];
+        case Register::ST: return ST[lane];
+        case Register::DT: return DT[lane];
+        case Register::PC: return PC[lane];
+        case Register::I: return I[lane];
+        case Register::SP: return SP[lane];
+        default: return 0x0000;
+        }
+    }
+}
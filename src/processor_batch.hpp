@@ -0,0 +1,86 @@
+#ifndef CH8_PROCESSOR_BATCH_HPP
+#define CH8_PROCESSOR_BATCH_HPP
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "definitions.hpp"
+#include "interpreter.hpp"
+#include "processor.hpp"
+#include "memory.hpp"
+
+namespace ch8 {
+    // Runs many copies of the same ROM in lockstep. All registers are stored as
+    // structure-of-arrays, V0 of every lane is contiguous, then V1 etc... When every
+    // lane is at the same PC (which is the common case, since they all run the same
+    // code) the instruction is fetched and decoded once, and executed as a plain loop
+    // over the lanes which the compiler vectorizes (build with NATIVE=YES for AVX2).
+    // Lanes that diverge are grouped by PC and the instruction there (which lanes that
+    // wrote to their memory might have changed), and each group is executed the same way.
+    class ProcessorBatch {
+    public:
+        using Register = Processor::Register;
+        ProcessorBatch(const byte*, std::size_t, std::size_t, unsigned); // Program, lanes and seed of lane 0.
+
+        std::size_t lanes() const { return lane_count; }
+        std::size_t running() const; // Amount of lanes still running.
+        bool running(std::size_t lane) const { return lane_running[lane]; }
+        bool faulted(std::size_t lane) const { return lane_faulted[lane]; } // Stopped on an exception.
+        void step(); // Steps every running lane forward by one instruction.
+        std::size_t run(std::size_t); // Steps n times, or until every lane has stopped.
+        std::size_t groups() const { return last_groups; } // Executed by the last step, one while lanes are together.
+
+        const byte* display_buffer(std::size_t lane) const { return &screen_buffers[lane * SCREEN_SIZE]; }
+        void key_mask(std::size_t lane, word mask) { keys[lane] = mask; } // Bit k is key k.
+        void tick_timers(); // Ticks the non-zero timers of every lane, once per 60 Hz.
+        word register_state(std::size_t, Register) const; // Same as Processor, but for a lane.
+
+    private:
+        // Lane selections the instruction handlers are instantiated for. AllLanes is
+        // contiguous, which allows the loops to be vectorized, while SomeLanes picks
+        // lanes through an index list, once lanes have diverged to different PCs.
+        struct AllLanes {
+            std::size_t count;
+            std::size_t size() const { return count; }
+            std::size_t operator[](std::size_t i) const { return i; }
+        };
+
+        struct SomeLanes {
+            const std::size_t* index;
+            std::size_t count;
+            std::size_t size() const { return count; }
+            std::size_t operator[](std::size_t i) const { return index[i]; }
+        };
+
+        template<typename Lanes> void execute(const Lanes&); // Fetches once and executes on all lanes.
+        template<typename Lanes> void execute(Instruction, byte, byte, const Lanes&);
+        template<typename Lanes> void fault(const Lanes&); // Stops lanes on exceptions.
+        bool converged() const; // Are all the lanes running, at the same PC and instruction?
+        word opcode_at(std::size_t) const; // Instruction at a lane's PC, zero if it can't be fetched.
+        void write(std::size_t, addr, byte); // Writes to lane memory, marking it as diverged. Unchecked.
+
+        static constexpr std::size_t SCREEN_SIZE {Processor::SCREEN_WIDTH * Processor::SCREEN_HEIGHT};
+        static constexpr std::size_t STACK_SIZE {16 + 1}; // Same as Processor, first is never used.
+        static constexpr addr PROGRAM_INIT {0x200};
+
+        std::size_t lane_count;
+        std::vector<byte> V[16]; // General purpose registers, each with one entry per lane.
+        std::vector<byte> ST, DT, SP;
+        std::vector<addr> PC, I;
+        std::vector<word> stack[STACK_SIZE];
+        std::vector<word> keys; // Key masks, one per lane.
+        std::vector<byte> lane_running, lane_faulted;
+        std::vector<byte> screen_buffers; // Display buffer of every lane, one after the other.
+
+        std::vector<Memory> memories; // Every lane may write to its own memory.
+        std::vector<byte> memory_written; // Lanes with written memory may run different code.
+        std::size_t written_lanes {0}; // While zero, every lane has the same code.
+        std::vector<std::mt19937> random_generators;
+        std::uniform_int_distribution<byte> random_udistribution {0, 255};
+        std::vector<std::size_t> active; // Scratch space for the divergent path.
+        std::vector<std::uint32_t> codes; // Same, PC and instruction of every running lane.
+        std::size_t last_groups {0};
+    };
+}
+
+#endif
@@ -0,0 +1,111 @@
+#include "catch.hpp"
+#include "processor_batch.hpp"
+#include <memory>
+#include <vector>
+
+namespace {
+    // Steps a batch and the same amount of scalar processors, checking that every lane
+    // ends up in exactly the same state as the processor it corresponds to.
+    void require_lockstep(const ch8::byte* program, std::size_t size, std::size_t lanes, std::size_t steps) {
+        ch8::ProcessorBatch batch {program, size, lanes, 1337};
+        std::vector<std::unique_ptr<ch8::Memory>> memories;
+        std::vector<std::unique_ptr<ch8::Processor>> processors;
+        for (std::size_t lane {0}; lane < lanes; ++lane) {
+            memories.emplace_back(new ch8::Memory {program, size});
+            processors.emplace_back(new ch8::Processor {*memories[lane], 1337 + static_cast<unsigned>(lane)});
+            processors[lane]->key_mask(static_cast<ch8::word>(1 << (lane % 16)));
+            batch.key_mask(lane, static_cast<ch8::word>(1 << (lane % 16)));
+        }
+
+        for (std::size_t step {0}; step < steps; ++step) {
+            batch.step();
+            for (std::size_t lane {0}; lane < lanes; ++lane) {
+                if (processors[lane]->running()) processors[lane]->step();
+            }
+
+            if (step % 10 == 0) {
+                batch.tick_timers();
+                for (auto& processor : processors) processor->tick_timers();
+            }
+        }
+
+        for (std::size_t lane {0}; lane < lanes; ++lane) {
+            for (int r {0}; r <= static_cast<int>(ch8::Processor::Register::SP); ++r) {
+                ch8::Processor::Register reg {static_cast<ch8::Processor::Register>(r)};
+                REQUIRE(batch.register_state(lane, reg) == processors[lane]->register_state(reg));
+            }
+
+            REQUIRE(batch.running(lane) == processors[lane]->running());
+            for (std::size_t pixel {0}; pixel < 64 * 32; ++pixel) {
+                REQUIRE(batch.display_buffer(lane)[pixel] == processors[lane]->display_buffer()[pixel]);
+            }
+        }
+    }
+}
+
+TEST_CASE("Batch lanes start out like a processor.", "[processor_batch, initial_state]") {
+    const ch8::byte program[] = {0x00, 0xFD}; // EXIT.
+    ch8::ProcessorBatch batch {program, sizeof(program), 8, 0};
+    REQUIRE(batch.lanes() == 8);
+    REQUIRE(batch.running() == 8);
+    REQUIRE(batch.register_state(7, ch8::Processor::Register::PC) == 0x200);
+    REQUIRE(batch.register_state(7, ch8::Processor::Register::SP) == 0x00);
+    REQUIRE(batch.run(10) == 1); // All lanes exit on the first step.
+    REQUIRE(batch.running() == 0);
+}
+
+TEST_CASE("Converged lanes run the ALU like a processor.", "[processor_batch, converged]") {
+    // LD V0, 0xF0; LD V1, 0x25; ADD V0, V1; SUB V1, V0; SHL V0; SHR V1; RND V2, 0xFF;
+    // XOR V1, V2; SUBN V3, V1; LD DT, V1; LD V4, DT; JP 0x202.
+    const ch8::byte program[] = {0x60, 0xF0, 0x61, 0x25, 0x80, 0x14, 0x81, 0x05, 0x80, 0x0E, 0x81, 0x16,
+                                 0xC2, 0xFF, 0x81, 0x23, 0x83, 0x17, 0xF1, 0x15, 0xF4, 0x07, 0x12, 0x02};
+    require_lockstep(program, sizeof(program), 16, 500);
+}
+
+TEST_CASE("Diverged lanes run like a processor.", "[processor_batch, diverged]") {
+    // 0x200: LD V0, 0; LD V1, 0; LD I, 0x300
+    // 0x206: SKP V0; JP 0x20E; CALL 0x21A
+    // 0x20C: JP 0x212; ADD V0, 1; SE V0, 16
+    // 0x212: JP 0x206 (else falls through to 0x214)
+    // 0x214: LD B, V1; DRW V0, V1, 3; EXIT.
+    // 0x21A: ADD V1, 7; LD F, V1; DRW V1, V0, 5; LD I, 0x300; LD [I], V1; RET.
+    const ch8::byte program[] = {0x60, 0x00, 0x61, 0x00, 0xA3, 0x00,
+                                 0xE0, 0x9E, 0x12, 0x0E, 0x22, 0x1A,
+                                 0x12, 0x12, 0x70, 0x01, 0x30, 0x10,
+                                 0x12, 0x06,
+                                 0xF1, 0x33, 0xD0, 0x13, 0x00, 0xFD,
+                                 0x71, 0x07, 0xF1, 0x29, 0xD1, 0x05, 0xA3, 0x00, 0xF1, 0x55, 0x00, 0xEE};
+    require_lockstep(program, sizeof(program), 24, 400);
+}
+
+TEST_CASE("Faulting lanes stop without stopping the batch.", "[processor_batch, faults]") {
+    // LD V0, 0; SKP V0; JP 0x20C; LD I, 0x000; LD [I], V0; JP 0x20A; JP 0x20C.
+    const ch8::byte program[] = {0x60, 0x00, 0xE0, 0x9E, 0x12, 0x0C, 0xA0, 0x00,
+                                 0xF0, 0x55, 0x12, 0x0A, 0x12, 0x0C};
+    ch8::ProcessorBatch batch {program, sizeof(program), 4, 0};
+    batch.key_mask(2, 0x0001); // Only lane 2 skips into the faulting store.
+    batch.run(20);
+    REQUIRE(batch.faulted(2));
+    REQUIRE(!batch.running(2));
+    REQUIRE(batch.register_state(2, ch8::Processor::Register::PC) == 0x208); // Left on the store, like Processor.
+    REQUIRE(batch.running() == 3);
+    REQUIRE(!batch.faulted(0));
+}
+
+TEST_CASE("Lanes stay together after stores and exits.", "[processor_batch, converged]") {
+    // 0x200: RND V0, 1; SE V0, 0; EXIT
+    // 0x206: LD I, 0x300; LD [I], V0; ADD V0, 1; JP 0x206.
+    const ch8::byte program[] = {0xC0, 0x01, 0x30, 0x00, 0x00, 0xFD,
+                                 0xA3, 0x00, 0xF0, 0x55, 0x70, 0x01, 0x12, 0x06};
+    ch8::ProcessorBatch batch {program, sizeof(program), 16, 3};
+    batch.run(4);
+    REQUIRE(batch.running() > 0);
+    REQUIRE(batch.running() < batch.lanes()); // Some lanes got a 1 and exited.
+
+    for (int step {0}; step < 40; ++step) {
+        batch.step();
+        REQUIRE(batch.groups() == 1); // Stored to memory, but nothing changed the code.
+    }
+
+    require_lockstep(program, sizeof(program), 16, 100);
+}
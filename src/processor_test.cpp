@@ -1,8 +1,11 @@
 #include "catch.hpp"
 #include "processor.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
 
-ch8::byte prog[4096] = {0}; // Some memory for the test.
-ch8::Memory m {prog, 4096}; // Memory abstraction for test, a total 4 KiB of memory.
+ch8::byte prog[ch8::Memory::PROGRAM_SIZE] = {0}; // Some memory for the test, as much as fits.
+ch8::Memory m {prog, sizeof(prog)}; // Memory abstraction for test, a total 4 KiB of memory.
 TEST_CASE("Processor constructed state.", "[processor, initial_state]") {
     ch8::Processor p {m};
     REQUIRE(p.register_state(ch8::Processor::Register::V0) == 0x00);
@@ -419,3 +422,455 @@ TEST_CASE("LD loads consecutive locations from memory to registers.", "[processo
     REQUIRE(p.register_state(ch8::Processor::Register::V1) == 0x0E);
     REQUIRE(p.register_state(ch8::Processor::Register::V2) == 0x0F);
 }
+
+TEST_CASE("Faults trap and stop the processor.", "[processor, traps]") {
+    ch8::byte program[] = {0x60, 0x01, 0xFF, 0xFF}; // LD V0, 0x01; invalid.
+    ch8::Memory memory {program, sizeof(program)};
+    ch8::Processor p {memory, 0};
+    REQUIRE(!p.trapped());
+    REQUIRE(p.run(10) == 1); // The faulting instruction doesn't count.
+    REQUIRE(!p.running());
+    REQUIRE(p.trap().kind == ch8::Processor::Trap::Kind::INVALID_OPCODE);
+    REQUIRE(p.trap().PC == 0x202);
+    REQUIRE(p.trap().opcode == 0xFFFF);
+    REQUIRE(p.register_state(ch8::Processor::Register::PC) == 0x202); // Left at the faulting instruction.
+
+    ch8::Processor::Snapshot* snapshot {new ch8::Processor::Snapshot};
+    p.save(*snapshot);
+    p.reset(0);
+    REQUIRE(!p.trapped());
+    REQUIRE(p.running());
+    p.restore(*snapshot);
+    REQUIRE(p.trap().kind == ch8::Processor::Trap::Kind::INVALID_OPCODE);
+    delete snapshot;
+
+    p.reset(0);
+    p.execute(ch8::Instruction::LD_IA, 0xA0, 0x00); // LD I, 0x000.
+    p.execute(ch8::Instruction::LD_IAR, 0xF0, 0x55); // LD [I], V0.
+    REQUIRE(p.trap().kind == ch8::Processor::Trap::Kind::WRITE_FAULT);
+    REQUIRE(p.trap().opcode == 0xF055);
+
+    p.reset(0);
+    p.execute(ch8::Instruction::LD_IA, 0xA0, 0x4E); // LD I, 0x04E, the last two bytes of the font.
+    p.execute(ch8::Instruction::DRW_RRC, 0xD0, 0x03); // DRW V0, V0, 3.
+    REQUIRE(p.trap().kind == ch8::Processor::Trap::Kind::READ_FAULT);
+
+    p.reset(0);
+    for (int i {0}; i < 16; ++i) p.execute(ch8::Instruction::CALL_A, 0x22, 0x00); // CALL 0x200.
+    REQUIRE(!p.trapped());
+    p.execute(ch8::Instruction::CALL_A, 0x22, 0x00); // CALL 0x200.
+    REQUIRE(p.trap().kind == ch8::Processor::Trap::Kind::STACK_OVERFLOW);
+    REQUIRE(p.register_state(ch8::Processor::Register::SP) == 16);
+
+    if (ch8::Memory::SIZE == 0x1000) { // Builds for XO-CHIP have memory past it.
+        p.reset(0);
+        p.execute(ch8::Instruction::JP_A, 0x1F, 0xFF); // JP 0xFFF, only half an instruction left.
+        p.step();
+        REQUIRE(p.trap().kind == ch8::Processor::Trap::Kind::READ_FAULT);
+        REQUIRE(p.trap().PC == 0xFFF);
+        REQUIRE(p.trap().opcode == 0x0000);
+    }
+}
+
+TEST_CASE("Faults can still throw if asked to.", "[processor, traps]") {
+    ch8::byte program[] = {0xFF, 0xFF}; // Invalid.
+    ch8::Memory memory {program, sizeof(program)};
+    ch8::Processor p {memory, 0};
+    p.fault_policy(ch8::Processor::FaultPolicy::THROW);
+    REQUIRE_THROWS_AS(p.step(), const std::runtime_error&);
+    REQUIRE(p.trap().kind == ch8::Processor::Trap::Kind::INVALID_OPCODE); // Recorded either way.
+    REQUIRE(!p.running());
+
+    p.reset(0);
+    p.execute(ch8::Instruction::LD_IA, 0xA0, 0x00); // LD I, 0x000.
+    REQUIRE_THROWS_AS(p.execute(ch8::Instruction::LD_BR, 0xF0, 0x33), const std::out_of_range&);
+}
+
+TEST_CASE("Restoring rejects snapshots that couldn't have been saved.", "[processor, snapshot]") {
+    ch8::byte program[] = {0x22, 0x04, 0x00, 0xFD, 0x00, 0xEE}; // CALL 0x204; EXIT; RET.
+    ch8::Memory memory {program, sizeof(program)};
+    ch8::Processor p {memory, 0};
+    p.step();
+
+    ch8::Processor::Snapshot* good {new ch8::Processor::Snapshot};
+    ch8::Processor::Snapshot* bad {new ch8::Processor::Snapshot};
+    p.save(*good);
+
+    *bad = *good;
+    bad->SP = ch8::Processor::STACK_SIZE; // CALL would write past the stack.
+    REQUIRE_THROWS_AS(p.restore(*bad), const std::invalid_argument&);
+
+    *bad = *good;
+    bad->PC = 0xF000;
+    if (ch8::Memory::SIZE == 0x1000) REQUIRE_THROWS_AS(p.restore(*bad), const std::invalid_argument&);
+
+    *bad = *good;
+    std::memset(&bad->running, 2, 1); // Neither true nor false.
+    REQUIRE_THROWS_AS(p.restore(*bad), const std::invalid_argument&);
+
+    *bad = *good;
+    std::memset(&bad->trap.kind, 0x7F, 1);
+    REQUIRE_THROWS_AS(p.restore(*bad), const std::invalid_argument&);
+
+    *bad = *good;
+    bad->planes = 0xFF;
+    REQUIRE_THROWS_AS(p.restore(*bad), const std::invalid_argument&);
+
+    *bad = *good;
+    bad->screen[0] = 0xFF;
+    REQUIRE_THROWS_AS(p.restore(*bad), const std::invalid_argument&);
+
+    p.restore(*good);
+    p.step(); // RET, back from the stack restored above.
+    REQUIRE(p.register_state(ch8::Processor::Register::PC) == 0x202);
+    delete good;
+    delete bad;
+}
+
+namespace {
+    // Runs the same program with run, in slices of the given size, and step by step,
+    // so fused dispatches can be checked against executing one instruction at a time.
+    bool same_as_stepping(const ch8::byte* program, std::size_t size, std::size_t slice, std::size_t steps,
+                          ch8::Profile profile = ch8::Profile::LEGACY) {
+        ch8::Memory fused_memory {program, size}, stepped_memory {program, size};
+        ch8::Processor fused {fused_memory, 7}, stepped {stepped_memory, 7};
+        fused.profile(profile);
+        stepped.profile(profile);
+        std::size_t fused_steps {0}, stepped_steps {0};
+        while (fused_steps < steps && fused.running()) {
+            std::size_t taken {fused.run(std::min(slice, steps - fused_steps))};
+            if (taken == 0) break;
+            fused_steps += taken;
+            fused.tick_timers();
+            for (std::size_t i {0}; i < taken && stepped.running(); ++i, ++stepped_steps) stepped.step();
+            stepped.tick_timers();
+        }
+
+        ch8::Processor::Snapshot* a {new ch8::Processor::Snapshot};
+        ch8::Processor::Snapshot* b {new ch8::Processor::Snapshot};
+        fused.save(*a);
+        stepped.save(*b);
+        bool same {fused_steps == stepped_steps && std::memcmp(a, b, sizeof(*a)) == 0};
+        delete a;
+        delete b;
+        return same;
+    }
+}
+
+TEST_CASE("Fused dispatches behave like single steps.", "[processor, fusion]") {
+    // A counted loop drawing a sprite, then a delay wait and a SNE loop, then EXIT:
+    // 200: LD V0, 0xF0; LD V2, 0x05
+    // 204: LD I, 0x300; DRW V2, V2, 4     (load and draw)
+    // 208: ADD V0, 1; SE V0, 0x00; JP 0x204 (counted loop)
+    // 20E: LD V3, 0x09; LD DT, V3
+    // 212: LD V4, DT; SE V4, 0x00; JP 0x212 (delay wait)
+    // 218: ADD V5, 3; SNE V5, 0x0C; JP 0x220; JP 0x218 (SNE variant, leaves once V5 is 0x0C)
+    // 220: EXIT
+    const ch8::byte program[] = {0x60, 0xF0, 0x62, 0x05, 0xA3, 0x00, 0xD2, 0x24,
+                                 0x70, 0x01, 0x30, 0x00, 0x12, 0x04, 0x63, 0x09,
+                                 0xF3, 0x15, 0xF4, 0x07, 0x34, 0x00, 0x12, 0x12,
+                                 0x75, 0x03, 0x45, 0x0C, 0x12, 0x20, 0x12, 0x18,
+                                 0x00, 0xFD};
+    for (std::size_t slice : {1, 2, 3, 4, 7, 10, 1000}) REQUIRE(same_as_stepping(program, sizeof(program), slice, 500));
+
+    ch8::Memory memory {program, sizeof(program)};
+    ch8::Processor p {memory, 0};
+    for (int frame {0}; frame < 100 && p.running(); ++frame) {
+        p.run(10);
+        p.tick_timers(); // The delay wait needs the timer to come down.
+    }
+
+    REQUIRE(!p.running());
+    REQUIRE(!p.trapped());
+    REQUIRE(p.register_state(ch8::Processor::Register::V0) == 0x00); // Counted all the way around.
+    REQUIRE(p.register_state(ch8::Processor::Register::V5) == 0x0C);
+}
+
+TEST_CASE("Fused dispatches notice changes to memory.", "[processor, fusion]") {
+    // 200: LD I, 0x300; DRW V0, V0, 1 (fused), then the program overwrites its own DRW:
+    // 204: LD I, 0x202; LD V0, 0x00; LD V1, 0xFD; LD [I], V1; JP 0x200, which makes 202 EXIT.
+    const ch8::byte program[] = {0xA3, 0x00, 0xD0, 0x01, 0xA2, 0x02, 0x60, 0x00,
+                                 0x61, 0xFD, 0xF1, 0x55, 0x12, 0x00};
+    for (std::size_t slice : {1, 2, 5, 100}) REQUIRE(same_as_stepping(program, sizeof(program), slice, 100));
+
+    ch8::Memory memory {program, sizeof(program)};
+    ch8::Processor p {memory, 0};
+    REQUIRE(p.run(100) == 9); // Seven the first time around, then LD I and the new EXIT.
+    REQUIRE(!p.running());
+    REQUIRE(!p.trapped());
+
+    // Jumping into the middle of a fused sequence only runs the part after it.
+    // 200: JP 0x204; 202: ADD V0, 1; SE V0, 0x00; JP 0x202; 208: EXIT.
+    const ch8::byte middle[] = {0x12, 0x04, 0x70, 0x01, 0x30, 0x00, 0x12, 0x02, 0x00, 0xFD};
+    ch8::Memory middle_memory {middle, sizeof(middle)};
+    ch8::Processor q {middle_memory, 0};
+    REQUIRE(q.run(100) == 3); // JP, SE skips, EXIT.
+    REQUIRE(q.register_state(ch8::Processor::Register::V0) == 0x00); // ADD never ran.
+
+    // A fault inside of a fused sequence is reported at the faulting instruction.
+    const ch8::byte faulting[] = {0xA0, 0x4F, 0xD0, 0x05}; // LD I, 0x04F; DRW V0, V0, 5.
+    ch8::Memory faulting_memory {faulting, sizeof(faulting)};
+    ch8::Processor r {faulting_memory, 0};
+    REQUIRE(r.run(100) == 1);
+    REQUIRE(r.trap().kind == ch8::Processor::Trap::Kind::READ_FAULT);
+    REQUIRE(r.trap().PC == 0x202);
+    REQUIRE(r.register_state(ch8::Processor::Register::I) == 0x04F);
+}
+
+TEST_CASE("Skipped flags are never seen.", "[processor, flags]") {
+    // 200: LD V0, 0xF0; LD V1, 0x20
+    // 204: ADD V0, V1 (VF overwritten by SUB next); SUB V0, V1 (VF read by LD next); LD V2, VF
+    // 20A: SHR V0 (VF overwritten by LD next); LD VF, 0x05
+    // 20E: SHL V0 (VF overwritten by SUBN two later); ADD V3, 1; SUBN V0, V1 (jumps next, VF kept)
+    // 214: JP 0x204
+    const ch8::byte program[] = {0x60, 0xF0, 0x61, 0x20, 0x80, 0x14, 0x80, 0x15,
+                                 0x82, 0xF0, 0x80, 0x16, 0x6F, 0x05, 0x80, 0x1E,
+                                 0x73, 0x01, 0x80, 0x17, 0x12, 0x04};
+    for (std::size_t slice {1}; slice <= 12; ++slice) {
+        REQUIRE(same_as_stepping(program, sizeof(program), slice, 400));
+        REQUIRE(same_as_stepping(program, sizeof(program), slice, 400, ch8::Profile::COSMAC));
+    }
+
+    // Stopping right after an instruction with a skippable flag still shows the flag.
+    ch8::Memory memory {program, sizeof(program)};
+    ch8::Processor p {memory, 0};
+    p.run(2);
+    p.run(1); // ADD V0, V1, 0xF0 + 0x20 carries.
+    REQUIRE(p.register_state(ch8::Processor::Register::VF) == 0x01);
+    p.run(1); // SUB V0, V1, 0x10 - 0x20 borrows.
+    REQUIRE(p.register_state(ch8::Processor::Register::VF) == 0x00);
+}
+
+TEST_CASE("Predecoded instructions follow writes from outside.", "[processor, code]") {
+    // 200: ADD V0, 1; JP 0x200, until the ADD is patched into EXIT from outside.
+    const ch8::byte program[] = {0x70, 0x01, 0x12, 0x00};
+    ch8::Memory memory {program, sizeof(program)};
+    ch8::Processor p {memory, 0};
+    REQUIRE(p.run(10) == 10);
+    REQUIRE(memory.is_code(0x200));
+    REQUIRE(p.register_state(ch8::Processor::Register::V0) == 5);
+
+    memory.write(0x200, 0x00);
+    memory.write(0x201, 0xFD);
+    REQUIRE(p.run(10) == 1);
+    REQUIRE(!p.running());
+
+    // Restoring a snapshot replaces everything that was decoded.
+    ch8::Memory other_memory {program, sizeof(program)};
+    ch8::Processor q {other_memory, 0};
+    q.run(4);
+    ch8::Processor::Snapshot snapshot;
+    q.save(snapshot);
+    q.run(4);
+    p.restore(snapshot); // Brings the ADD back over the EXIT decoded above.
+    REQUIRE(p.run(4) == 4);
+    REQUIRE(p.register_state(ch8::Processor::Register::V0) == 4);
+}
+
+TEST_CASE("SUPER-CHIP instructions are ignored without its screen.", "[processor, schip]") {
+    ch8::Processor p {m};
+    p.execute(ch8::Instruction::HIGH, 0x00, 0xFF);
+    REQUIRE_FALSE(p.high_resolution());
+    p.execute(ch8::Instruction::SCD_C, 0x00, 0xC4);
+    REQUIRE(p.trap().kind == ch8::Processor::Trap::Kind::NONE);
+}
+
+TEST_CASE("SUPER-CHIP draws packed rows in high resolution.", "[processor, schip]") {
+    ch8::byte sprites[32];
+    for (ch8::byte& row : sprites) row = 0xFF;
+    sprites[0] = 0xF0;
+    ch8::Memory memory {sprites, sizeof(sprites)};
+    ch8::Processor p {memory, 0};
+    p.profile(ch8::Profile::SUPER_CHIP);
+    p.execute(ch8::Instruction::HIGH, 0x00, 0xFF);
+    REQUIRE(p.high_resolution());
+    const std::uint64_t* rows {p.high_display()};
+
+    p.execute(ch8::Instruction::LD_IA, 0xA2, 0x00);
+    p.execute(ch8::Instruction::LD_RC, 0x60, 60);
+    p.execute(ch8::Instruction::DRW_RRC, 0xD0, 0x11); // 0xF0 at column 60.
+    REQUIRE(rows[0] == 0x0F);
+    REQUIRE(rows[1] == 0x00);
+    REQUIRE(p.register_state(ch8::Processor::Register::VF) == 0);
+
+    p.execute(ch8::Instruction::LD_IA, 0xA2, 0x01);
+    p.execute(ch8::Instruction::LD_RC, 0x60, 62);
+    p.execute(ch8::Instruction::DRW_RRC, 0xD0, 0x11); // 0xFF at column 62, over the word boundary.
+    REQUIRE(rows[0] == 0x0C);
+    REQUIRE(rows[1] == 0xFCull << 56);
+    REQUIRE(p.register_state(ch8::Processor::Register::VF) == 1);
+
+    // 16x16 at the right edge, cut off there since SUPER-CHIP clips.
+    p.execute(ch8::Instruction::CLS, 0x00, 0xE0);
+    p.execute(ch8::Instruction::LD_RC, 0x60, 120);
+    p.execute(ch8::Instruction::LD_RC, 0x61, 60);
+    p.execute(ch8::Instruction::DRW_RRC, 0xD0, 0x10);
+    REQUIRE(rows[60 * 2] == 0x00);
+    REQUIRE(rows[60 * 2 + 1] == 0xFF);
+    REQUIRE(rows[63 * 2 + 1] == 0xFF);
+    REQUIRE(rows[0 * 2 + 1] == 0x00); // Not wrapped around to the top either.
+
+    if (ch8::Memory::SIZE < 0x10000) return; // XO-CHIP needs XO_CHIP=YES.
+    p.profile(ch8::Profile::XO_CHIP); // Wraps instead.
+    p.execute(ch8::Instruction::CLS, 0x00, 0xE0);
+    p.execute(ch8::Instruction::DRW_RRC, 0xD0, 0x10);
+    REQUIRE(rows[60 * 2] == 0xFFull << 56);
+    REQUIRE(rows[60 * 2 + 1] == 0xFF);
+    REQUIRE(rows[0 * 2 + 1] == 0xFF);
+}
+
+TEST_CASE("SUPER-CHIP scrolls both screens.", "[processor, schip]") {
+    ch8::Processor p {m};
+    p.profile(ch8::Profile::SUPER_CHIP);
+    p.execute(ch8::Instruction::LD_IA, 0xA0, 0x00); // Font zero, 0xF0 on the first row.
+    p.execute(ch8::Instruction::DRW_RRC, 0xD0, 0x01);
+    p.execute(ch8::Instruction::SCR, 0x00, 0xFB);
+    REQUIRE(p.display_buffer()[3] == 0);
+    REQUIRE(p.display_buffer()[4] == 1);
+    REQUIRE(p.display_buffer()[7] == 1);
+    p.execute(ch8::Instruction::SCD_C, 0x00, 0xC2);
+    REQUIRE(p.display_buffer()[4] == 0);
+    REQUIRE(p.display_buffer()[2 * 64 + 4] == 1);
+
+    p.execute(ch8::Instruction::HIGH, 0x00, 0xFF);
+    const std::uint64_t* rows {p.high_display()};
+    p.execute(ch8::Instruction::LD_RC, 0x60, 60);
+    p.execute(ch8::Instruction::DRW_RRC, 0xD0, 0x11);
+    REQUIRE(rows[0] == 0x0F);
+    p.execute(ch8::Instruction::SCR, 0x00, 0xFB);
+    REQUIRE(rows[0] == 0x00);
+    REQUIRE(rows[1] == 0xFull << 60);
+    p.execute(ch8::Instruction::SCL, 0x00, 0xFC);
+    p.execute(ch8::Instruction::SCL, 0x00, 0xFC);
+    REQUIRE(rows[0] == 0xF0);
+    p.execute(ch8::Instruction::SCD_C, 0x00, 0xCF);
+    REQUIRE(rows[0] == 0x00);
+    REQUIRE(rows[15 * 2] == 0xF0);
+
+    ch8::Processor::Snapshot* snapshot {new ch8::Processor::Snapshot};
+    p.save(*snapshot);
+    p.execute(ch8::Instruction::LOW, 0x00, 0xFE);
+    REQUIRE_FALSE(p.high_resolution());
+    p.restore(*snapshot);
+    REQUIRE(p.high_resolution());
+    REQUIRE(p.high_display()[15 * 2] == 0xF0);
+    delete snapshot;
+
+    p.reset(0);
+    REQUIRE_FALSE(p.high_resolution());
+    REQUIRE(p.high_display()[15 * 2] == 0x00);
+}
+
+TEST_CASE("XO-CHIP instructions are invalid in other profiles.", "[processor, xochip]") {
+    ch8::Processor p {m};
+    p.execute(ch8::Instruction::SAVE_RR, 0x50, 0x12);
+    REQUIRE(p.trap().kind == ch8::Processor::Trap::Kind::INVALID_OPCODE);
+    p.reset(0);
+    p.profile(ch8::Profile::SUPER_CHIP);
+    p.execute(ch8::Instruction::PLANE_C, 0xF2, 0x01);
+    REQUIRE(p.trap().kind == ch8::Processor::Trap::Kind::INVALID_OPCODE);
+}
+
+TEST_CASE("XO-CHIP loads long addresses and register ranges.", "[processor, xochip]") {
+    // 200: LD I, LONG 0x300; LD V0, 0x11; LD V1, 0x22; LD V2, 0x33
+    // 20A: SAVE V0-V2; LOAD V2-V0 (backwards); SE V0, 0x33 (skips all of the next)
+    // 210: LD I, LONG 0x0ABC; EXIT
+    const ch8::byte program[] = {0xF0, 0x00, 0x03, 0x00, 0x60, 0x11, 0x61, 0x22, 0x62, 0x33,
+                                 0x50, 0x22, 0x52, 0x03, 0x30, 0x33, 0xF0, 0x00, 0x0A, 0xBC, 0x00, 0xFD};
+    if (ch8::Memory::SIZE < 0x10000) { // Only builds with XO_CHIP=YES can run it.
+        ch8::Memory memory {program, sizeof(program)};
+        ch8::Processor p {memory, 0};
+        REQUIRE_THROWS_AS(p.profile(ch8::Profile::XO_CHIP), const std::invalid_argument&);
+        REQUIRE(p.profile() == ch8::Profile::LEGACY);
+        return;
+    }
+
+    for (int stepped {0}; stepped < 2; ++stepped) {
+        ch8::Memory memory {program, sizeof(program)};
+        ch8::Processor p {memory, 0};
+        p.profile(ch8::Profile::XO_CHIP);
+        if (stepped) {
+            while (p.running()) p.step();
+        } else REQUIRE(p.run(100) == 8);
+        REQUIRE(!p.trapped());
+        REQUIRE(p.register_state(ch8::Processor::Register::PC) == 0x216); // Just past EXIT.
+        REQUIRE(p.register_state(ch8::Processor::Register::I) == 0x300); // Left alone by both.
+        REQUIRE(memory.read(0x300) == 0x11);
+        REQUIRE(memory.read(0x302) == 0x33);
+        REQUIRE(p.register_state(ch8::Processor::Register::V0) == 0x33);
+        REQUIRE(p.register_state(ch8::Processor::Register::V1) == 0x22);
+        REQUIRE(p.register_state(ch8::Processor::Register::V2) == 0x11);
+    }
+
+    const ch8::byte high[] = {0xF0, 0x00, 0x80, 0x00, 0x60, 0x42, 0xF0, 0x55, 0x00, 0xFD}; // LD I, LONG 0x8000; LD V0, 0x42; LD [I], V0.
+    ch8::Memory memory {high, sizeof(high)};
+    ch8::Processor p {memory, 0};
+    p.profile(ch8::Profile::XO_CHIP);
+    p.run(100);
+    REQUIRE(!p.trapped());
+    REQUIRE(memory.read(0x8000) == 0x42);
+}
+
+TEST_CASE("XO-CHIP draws on the selected planes.", "[processor, xochip]") {
+    ch8::Processor p {m};
+    if (ch8::Memory::SIZE < 0x10000) { // Only builds with XO_CHIP=YES can run it.
+        REQUIRE_THROWS_AS(p.profile(ch8::Profile::XO_CHIP), const std::invalid_argument&);
+        return;
+    }
+
+    p.profile(ch8::Profile::XO_CHIP);
+    p.execute(ch8::Instruction::LD_IA, 0xA0, 0x00); // Font zero, 0xF0 then 0x90.
+    p.execute(ch8::Instruction::PLANE_C, 0xF3, 0x01);
+    p.execute(ch8::Instruction::DRW_RRC, 0xD0, 0x01); // A row on each plane, the second one's after the first's.
+    REQUIRE(p.display_buffer()[0] == 3);
+    REQUIRE(p.display_buffer()[1] == 1);
+    REQUIRE(p.display_buffer()[3] == 3);
+    REQUIRE(p.display_buffer()[4] == 0);
+
+    p.execute(ch8::Instruction::PLANE_C, 0xF1, 0x01);
+    p.execute(ch8::Instruction::CLS, 0x00, 0xE0); // Only the first plane.
+    REQUIRE(p.display_buffer()[0] == 2);
+    REQUIRE(p.display_buffer()[1] == 0);
+
+    p.execute(ch8::Instruction::HIGH, 0x00, 0xFF);
+    p.execute(ch8::Instruction::PLANE_C, 0xF3, 0x01);
+    p.execute(ch8::Instruction::DRW_RRC, 0xD0, 0x01);
+    const std::uint64_t* rows {p.high_display()};
+    REQUIRE(rows[0] == 0xF0ull << 56);
+    REQUIRE(rows[ch8::Processor::HIGH_HEIGHT * 2] == 0x90ull << 56);
+    p.execute(ch8::Instruction::DRW_RRC, 0xD0, 0x01);
+    REQUIRE(p.register_state(ch8::Processor::Register::VF) == 1);
+    REQUIRE(rows[0] == 0x00);
+}
+
+TEST_CASE("XO-CHIP keeps an audio pattern and pitch.", "[processor, xochip]") {
+    ch8::Processor p {m};
+    if (ch8::Memory::SIZE < 0x10000) { // Only builds with XO_CHIP=YES can run it.
+        REQUIRE_THROWS_AS(p.profile(ch8::Profile::XO_CHIP), const std::invalid_argument&);
+        return;
+    }
+
+    p.profile(ch8::Profile::XO_CHIP);
+    REQUIRE(p.audio_pitch() == 64);
+    p.execute(ch8::Instruction::LD_IA, 0xA0, 0x00);
+    p.execute(ch8::Instruction::AUDIO, 0xF0, 0x02);
+    REQUIRE(p.audio_pattern()[0] == 0xF0); // The font, as good a pattern as any.
+    REQUIRE(p.audio_pattern()[15] == 0xF0);
+    p.execute(ch8::Instruction::LD_RC, 0x65, 0x70);
+    p.execute(ch8::Instruction::PITCH_R, 0xF5, 0x3A);
+    REQUIRE(p.audio_pitch() == 0x70);
+
+    ch8::Processor::Snapshot* snapshot {new ch8::Processor::Snapshot};
+    p.save(*snapshot);
+    p.reset(0);
+    REQUIRE(p.audio_pitch() == 64);
+    REQUIRE(p.audio_pattern()[0] == 0x00);
+    p.restore(*snapshot);
+    REQUIRE(p.audio_pitch() == 0x70);
+    REQUIRE(p.audio_pattern()[0] == 0xF0);
+    delete snapshot;
+
+    p.execute(ch8::Instruction::LD_IA, 0xA0, 0x45); // Runs off the font.
+    p.execute(ch8::Instruction::AUDIO, 0xF0, 0x02);
+    REQUIRE(p.trap().kind == ch8::Processor::Trap::Kind::READ_FAULT);
+}
@@ -0,0 +1,74 @@
+#include "quirks.hpp"
+#include "hash.hpp"
+#include <algorithm>
+#include <sstream>
+
+namespace ch8 {
+    namespace {
+        const struct {
+            Profile profile;
+            const char* name;
+        } PROFILE_NAMES[] = {
+            {Profile::LEGACY, "legacy"},
+            {Profile::COSMAC, "cosmac"},
+            {Profile::SUPER_CHIP, "schip"},
+            {Profile::XO_CHIP, "xochip"}
+        };
+    }
+
+    QuirkDatabase QuirkDatabase::parse(std::istream& stream) {
+        QuirkDatabase database;
+        std::string line;
+        std::size_t line_number {0};
+        while (std::getline(stream, line)) {
+            ++line_number;
+            std::size_t comment {line.find('#')};
+            if (comment != std::string::npos) line.erase(comment);
+            if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+            std::uint64_t hash;
+            std::string name;
+            std::istringstream fields {line};
+            if (!(fields >> std::hex >> hash >> name))
+                throw std::runtime_error {"Couldn't parse quirk database, bad ROM on line " + std::to_string(line_number) + '.'};
+            try { database.add(hash, profile(name)); }
+            catch (const std::invalid_argument&) {
+                throw std::runtime_error {"Couldn't parse quirk database, unknown profile on line " + std::to_string(line_number) + '.'};
+            }
+        }
+
+        return database;
+    }
+
+    void QuirkDatabase::add(std::uint64_t hash, Profile profile) {
+        auto position = std::lower_bound(profiles.begin(), profiles.end(), hash,
+                                         [](const std::pair<std::uint64_t, Profile>& entry, std::uint64_t h) { return entry.first < h; });
+        if (position != profiles.end() && position->first == hash) position->second = profile;
+        else profiles.insert(position, std::make_pair(hash, profile));
+    }
+
+    Profile QuirkDatabase::lookup(const byte* program, std::size_t size, Profile fallback) const {
+        if (profiles.empty()) return fallback; // Don't bother hashing.
+        std::uint64_t hash {Hash::xxh64(program, size)};
+        auto position = std::lower_bound(profiles.begin(), profiles.end(), hash,
+                                         [](const std::pair<std::uint64_t, Profile>& entry, std::uint64_t h) { return entry.first < h; });
+        if (position != profiles.end() && position->first == hash) return position->second;
+        else return fallback;
+    }
+
+    Profile QuirkDatabase::profile(const std::string& name) {
+        for (const auto& profile : PROFILE_NAMES) {
+            if (name == profile.name) return profile.profile;
+        }
+
+        throw std::invalid_argument {"Couldn't find quirk profile " + name + '.'};
+    }
+
+    const char* QuirkDatabase::profile_name(Profile profile) {
+        for (const auto& name : PROFILE_NAMES) {
+            if (profile == name.profile) return name.name;
+        }
+
+        return "unknown";
+    }
+}
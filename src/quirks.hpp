@@ -0,0 +1,91 @@
+#ifndef CH8_QUIRKS_HPP
+#define CH8_QUIRKS_HPP
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <istream>
+#include <stdexcept>
+#include "definitions.hpp"
+
+namespace ch8 {
+    // CHIP-8 variants disagree on a handful of instructions. Each profile is a type, and
+    // the processor compiles its own set of handlers for every one of them, so none of
+    // these are checked inside of an instruction, only once when the profile is picked.
+    namespace quirks {
+        // What this interpreter has always done, and still the default.
+        struct Legacy {
+            static constexpr bool SHIFT_VY {false}; // 8XY6/8XYE shift VY into VX, instead of VX in place.
+            static constexpr bool SHIFT_FLAG_IS_ONE {true}; // 8XY6 sets VF only if VX was 1, not its lowest bit.
+            static constexpr bool INCREMENT_I {false}; // FX55/FX65 leave I just past the last register.
+            static constexpr bool JUMP_VX {false}; // BXNN jumps to XNN + VX, instead of NNN + V0.
+            static constexpr bool CLIP_SPRITES {false}; // DXYN clips sprites at the edges, instead of wrapping.
+            static constexpr bool LOGIC_RESETS_VF {false}; // 8XY1/8XY2/8XY3 set VF to zero.
+            static constexpr bool EXTENDED_SCREEN {false}; // 00CN/00FB/00FC scroll, 00FE/00FF switch to 128x64, DXY0 draws 16x16 there.
+            static constexpr bool XO_EXTENSIONS {false}; // 5XY2/5XY3 register ranges, F000 NNNN, FN01 planes, F002/FX3A audio.
+        };
+
+        // The original interpreter on the COSMAC VIP.
+        struct Cosmac {
+            static constexpr bool SHIFT_VY {true};
+            static constexpr bool SHIFT_FLAG_IS_ONE {false};
+            static constexpr bool INCREMENT_I {true};
+            static constexpr bool JUMP_VX {false};
+            static constexpr bool CLIP_SPRITES {true};
+            static constexpr bool LOGIC_RESETS_VF {true};
+            static constexpr bool EXTENDED_SCREEN {false};
+            static constexpr bool XO_EXTENSIONS {false};
+        };
+
+        // SUPER-CHIP 1.1 on the HP 48, which most of the later games were written for.
+        struct SuperChip {
+            static constexpr bool SHIFT_VY {false};
+            static constexpr bool SHIFT_FLAG_IS_ONE {false};
+            static constexpr bool INCREMENT_I {false};
+            static constexpr bool JUMP_VX {true};
+            static constexpr bool CLIP_SPRITES {true};
+            static constexpr bool LOGIC_RESETS_VF {false};
+            static constexpr bool EXTENDED_SCREEN {true};
+            static constexpr bool XO_EXTENSIONS {false};
+        };
+
+        // XO-CHIP, back to COSMAC semantics for the most part, but with wrapping sprites.
+        struct XoChip {
+            static constexpr bool SHIFT_VY {true};
+            static constexpr bool SHIFT_FLAG_IS_ONE {false};
+            static constexpr bool INCREMENT_I {true};
+            static constexpr bool JUMP_VX {false};
+            static constexpr bool CLIP_SPRITES {false};
+            static constexpr bool LOGIC_RESETS_VF {false};
+            static constexpr bool EXTENDED_SCREEN {true};
+            static constexpr bool XO_EXTENSIONS {true};
+        };
+    }
+
+    // Runtime name for each of the profiles above, used to pick one of them.
+    enum class Profile {
+        LEGACY, COSMAC,
+        SUPER_CHIP, XO_CHIP
+    };
+
+    // Picks the profile for a ROM by its content hash (XXH64), since nothing in the ROM
+    // itself says what it was written for. The database is plain text, one line for each
+    // "<xxh64 in hex> <profile name>", where '#' starts a comment. ROMs not in it get the
+    // fallback, which is the legacy profile unless something else is asked for.
+    class QuirkDatabase {
+    public:
+        static QuirkDatabase parse(std::istream&); // Throws std::runtime_error if it can't be parsed.
+        void add(std::uint64_t, Profile); // Replaces an existing profile for the same hash.
+        Profile lookup(const byte*, std::size_t, Profile = Profile::LEGACY) const; // O(log n) in ROMs.
+        std::size_t size() const { return profiles.size(); }
+
+        static Profile profile(const std::string&); // Throws std::invalid_argument for unknown names.
+        static const char* profile_name(Profile); // Name as accepted by the above, e.g. "schip".
+
+    private:
+        std::vector<std::pair<std::uint64_t, Profile>> profiles; // Sorted by hash.
+    };
+}
+
+#endif
@@ -0,0 +1,119 @@
+#include "catch.hpp"
+#include "quirks.hpp"
+#include "processor.hpp"
+#include "memory.hpp"
+#include "hash.hpp"
+#include <sstream>
+
+namespace {
+    ch8::byte quirk_program[ch8::Memory::PROGRAM_SIZE] = {0};
+}
+
+TEST_CASE("Parsing and looking up quirk databases.", "[quirks, database]") {
+    const ch8::byte pong[] = {0x6A, 0x02, 0x6B, 0x0C};
+    const ch8::byte brix[] = {0x6E, 0x05};
+    std::ostringstream text;
+    text << "# Comment line.\n" << std::hex << ch8::Hash::xxh64(pong, sizeof(pong)) << " schip # PONG\n\n"
+         << ch8::Hash::xxh64(brix, sizeof(brix)) << " cosmac\n";
+
+    std::istringstream stream {text.str()};
+    ch8::QuirkDatabase database {ch8::QuirkDatabase::parse(stream)};
+    REQUIRE(database.size() == 2);
+    REQUIRE(database.lookup(pong, sizeof(pong)) == ch8::Profile::SUPER_CHIP);
+    REQUIRE(database.lookup(brix, sizeof(brix)) == ch8::Profile::COSMAC);
+    REQUIRE(database.lookup(brix, 1) == ch8::Profile::LEGACY); // Not the same ROM.
+    REQUIRE(database.lookup(brix, 1, ch8::Profile::XO_CHIP) == ch8::Profile::XO_CHIP);
+
+    database.add(ch8::Hash::xxh64(pong, sizeof(pong)), ch8::Profile::XO_CHIP);
+    REQUIRE(database.size() == 2); // Replaced, not added.
+    REQUIRE(database.lookup(pong, sizeof(pong)) == ch8::Profile::XO_CHIP);
+
+    REQUIRE(ch8::QuirkDatabase::profile("xochip") == ch8::Profile::XO_CHIP);
+    REQUIRE(std::string {ch8::QuirkDatabase::profile_name(ch8::Profile::SUPER_CHIP)} == "schip");
+    REQUIRE_THROWS_AS(ch8::QuirkDatabase::profile("chip-48"), const std::invalid_argument&);
+
+    std::istringstream unknown {"0123 chip-48\n"};
+    REQUIRE_THROWS_AS(ch8::QuirkDatabase::parse(unknown), const std::runtime_error&);
+    std::istringstream malformed {"pong schip\n"};
+    REQUIRE_THROWS_AS(ch8::QuirkDatabase::parse(malformed), const std::runtime_error&);
+}
+
+TEST_CASE("Shifts and logic ops follow the quirk profile.", "[quirks, alu]") {
+    ch8::Memory memory {quirk_program, sizeof(quirk_program)};
+    ch8::Processor p {memory, 0};
+    REQUIRE(p.profile() == ch8::Profile::LEGACY);
+
+    p.profile(ch8::Profile::COSMAC);
+    p.execute(ch8::Instruction::LD_RC, 0x60, 0x10); // LD V0, 0x10.
+    p.execute(ch8::Instruction::LD_RC, 0x61, 0x03); // LD V1, 0x03.
+    p.execute(ch8::Instruction::SHR_RR, 0x80, 0x16); // SHR V0, V1.
+    REQUIRE(p.register_state(ch8::Processor::Register::V0) == 0x01); // Shifted V1 into V0.
+    REQUIRE(p.register_state(ch8::Processor::Register::VF) == 0x01); // Lowest bit of V1.
+    p.execute(ch8::Instruction::OR_RR, 0x80, 0x11); // OR V0, V1.
+    REQUIRE(p.register_state(ch8::Processor::Register::VF) == 0x00); // Reset by logic ops.
+
+    p.profile(ch8::Profile::SUPER_CHIP);
+    p.execute(ch8::Instruction::LD_RC, 0x60, 0x81); // LD V0, 0x81.
+    p.execute(ch8::Instruction::SHL_RR, 0x80, 0x1E); // SHL V0, V1.
+    REQUIRE(p.register_state(ch8::Processor::Register::V0) == 0x02); // V0 in place, V1 ignored.
+    REQUIRE(p.register_state(ch8::Processor::Register::VF) == 0x01);
+    p.execute(ch8::Instruction::LD_RC, 0x60, 0x03); // LD V0, 0x03.
+    p.execute(ch8::Instruction::SHR_RR, 0x80, 0x16); // SHR V0, V1.
+    REQUIRE(p.register_state(ch8::Processor::Register::VF) == 0x01); // Lowest bit, not "was exactly one".
+    p.execute(ch8::Instruction::AND_RR, 0x80, 0x12); // AND V0, V1.
+    REQUIRE(p.register_state(ch8::Processor::Register::VF) == 0x01); // Left alone.
+
+    p.profile(ch8::Profile::LEGACY);
+    p.execute(ch8::Instruction::LD_RC, 0x60, 0x03); // LD V0, 0x03.
+    p.execute(ch8::Instruction::SHR_RR, 0x80, 0x16); // SHR V0, V1.
+    REQUIRE(p.register_state(ch8::Processor::Register::VF) == 0x00); // Only set when V0 was one.
+}
+
+TEST_CASE("Jumps and register stores follow the quirk profile.", "[quirks, memory]") {
+    ch8::Memory memory {quirk_program, sizeof(quirk_program)};
+    ch8::Processor p {memory, 0};
+    p.execute(ch8::Instruction::LD_RC, 0x60, 0x02); // LD V0, 0x02.
+    p.execute(ch8::Instruction::LD_RC, 0x63, 0x10); // LD V3, 0x10.
+
+    p.execute(ch8::Instruction::JP_V0A, 0xB3, 0x00); // JP V0, 0x300.
+    REQUIRE(p.register_state(ch8::Processor::Register::PC) == 0x302);
+    p.profile(ch8::Profile::SUPER_CHIP);
+    p.execute(ch8::Instruction::JP_V0A, 0xB3, 0x00); // JP V3, 0x300.
+    REQUIRE(p.register_state(ch8::Processor::Register::PC) == 0x310);
+
+    p.execute(ch8::Instruction::LD_IA, 0xA4, 0x00); // LD I, 0x400.
+    p.execute(ch8::Instruction::LD_IAR, 0xF3, 0x55); // LD [I], V3.
+    REQUIRE(p.register_state(ch8::Processor::Register::I) == 0x400); // Left alone.
+    p.profile(ch8::Profile::COSMAC);
+    p.execute(ch8::Instruction::LD_IAR, 0xF3, 0x55); // LD [I], V3.
+    REQUIRE(p.register_state(ch8::Processor::Register::I) == 0x404); // Just past V3.
+    p.execute(ch8::Instruction::LD_RAI, 0xF1, 0x65); // LD V1, [I].
+    REQUIRE(p.register_state(ch8::Processor::Register::I) == 0x406);
+
+    p.reset(0);
+    REQUIRE(p.profile() == ch8::Profile::COSMAC); // Kept across resets.
+}
+
+TEST_CASE("Sprites either wrap or clip at the edges.", "[quirks, drw]") {
+    ch8::Memory memory {quirk_program, sizeof(quirk_program)};
+    memory.write(0x300, 0xFF); // A single 8 pixel wide line.
+    ch8::Processor p {memory, 0};
+    p.execute(ch8::Instruction::LD_RC, 0x60, 60); // LD V0, 60.
+    p.execute(ch8::Instruction::LD_RC, 0x61, 0); // LD V1, 0.
+    p.execute(ch8::Instruction::LD_IA, 0xA3, 0x00); // LD I, 0x300.
+
+    p.execute(ch8::Instruction::DRW_RRC, 0xD0, 0x11); // DRW V0, V1, 1.
+    REQUIRE(p.display_buffer()[63] == 1);
+    REQUIRE(p.display_buffer()[0] == 1); // Wrapped around.
+    REQUIRE(p.display_buffer()[3] == 1);
+
+    p.execute(ch8::Instruction::CLS, 0x00, 0xE0); // CLS.
+    p.profile(ch8::Profile::SUPER_CHIP);
+    p.execute(ch8::Instruction::DRW_RRC, 0xD0, 0x11); // DRW V0, V1, 1.
+    REQUIRE(p.display_buffer()[63] == 1);
+    REQUIRE(p.display_buffer()[0] == 0); // Clipped.
+    p.execute(ch8::Instruction::LD_RC, 0x60, 64 + 60); // LD V0, 124.
+    p.execute(ch8::Instruction::DRW_RRC, 0xD0, 0x11); // DRW V0, V1, 1.
+    REQUIRE(p.display_buffer()[63] == 0); // Starting position still wraps.
+    REQUIRE(p.register_state(ch8::Processor::Register::VF) == 0x01);
+}
@@ -0,0 +1,62 @@
+#include "sampler.hpp"
+#include <iomanip>
+
+namespace ch8 {
+    Sampler::Sampler(std::size_t instructions) : period {instructions}, until_sample {instructions} {
+        if (period == 0) throw std::invalid_argument {"Need at least one instruction between samples."};
+    }
+
+    std::size_t Sampler::run(Processor& processor, const Memory& memory, std::size_t steps) {
+        std::size_t taken {0};
+        while (taken < steps && processor.running()) {
+            std::size_t slice {std::min(until_sample, steps - taken)};
+            std::size_t ran {processor.run(slice)};
+            taken += ran;
+            until_sample -= ran;
+            if (until_sample == 0) {
+                sample(processor, memory);
+                until_sample = period;
+            }
+
+            if (ran < slice) break; // Stopped, there's nothing more to see.
+        }
+
+        return taken;
+    }
+
+    void Sampler::sample(const Processor& processor, const Memory& memory) {
+        auto opcode_at = [&memory](addr address) -> word {
+            if (!memory.readable(address) || !memory.readable(address + 1)) return 0x0000;
+            return memory.load(address) << 8 | memory.load(address + 1);
+        };
+
+        std::vector<word> path {Processor::PROGRAM_INIT};
+        const word* stack {processor.call_stack()};
+        word depth {processor.register_state(Processor::Register::SP)};
+        for (word level {1}; level <= depth && level < Processor::STACK_SIZE; ++level) {
+            word call {opcode_at(stack[level] - 1)}; // Return addresses point at the second half of the CALL.
+            if (call >> 12 == 0x2) path.push_back(call & 0x0FFF);
+            else path.push_back(stack[level] - 1); // Whatever was there is gone, name it after the call site.
+        }
+
+        addr PC {processor.register_state(Processor::Register::PC)};
+        path.push_back(PC);
+        path.push_back(opcode_at(PC));
+        ++paths[path];
+        ++sampled;
+    }
+
+    void Sampler::write_folded(std::ostream& stream) const {
+        stream << std::hex << std::uppercase << std::setfill('0');
+        for (const std::pair<const std::vector<word>, std::uint64_t>& path : paths) {
+            const std::vector<word>& frames {path.first};
+            for (std::size_t i {0}; i + 2 < frames.size(); ++i) stream << "0x" << std::setw(3) << frames[i] << ';';
+            word opcode {frames.back()};
+            stream << "0x" << std::setw(3) << frames[frames.size() - 2] << ' '
+                   << Interpreter::disassemble(opcode >> 8, opcode & 0xFF)
+                   << ' ' << std::dec << path.second << std::hex << '\n';
+        }
+
+        stream << std::dec << std::nouppercase << std::setfill(' ');
+    }
+}
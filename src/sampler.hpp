@@ -0,0 +1,37 @@
+#ifndef CH8_SAMPLER_HPP
+#define CH8_SAMPLER_HPP
+
+#include <map>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include "definitions.hpp"
+#include "processor.hpp"
+#include "memory.hpp"
+
+namespace ch8 {
+    // Samples the PC every so many instructions, together with the subroutines it's in,
+    // as found by following the CALLs on the stack. Samples are counted by call path,
+    // and written as folded stacks, one "<frame>;<frame>;... <count>" line per path,
+    // which is what flame graph tools take. Frames are named after where subroutines
+    // start, followed by the sampled instruction, e.g. "0x200;0x2A4;0x2B0 DRW V0, V1, 5 12".
+    class Sampler {
+    public:
+        explicit Sampler(std::size_t); // Instructions between samples. Throws if zero.
+        std::size_t run(Processor&, const Memory&, std::size_t); // Same as Processor::run, sampling on the way.
+        void sample(const Processor&, const Memory&); // Records where the processor is right now.
+        void write_folded(std::ostream&) const; // Paths in address order.
+        std::uint64_t samples() const { return sampled; }
+
+    private:
+        std::size_t period;
+        std::size_t until_sample; // Instructions left before the next sample, carried across runs.
+        std::uint64_t sampled {0};
+
+        // Subroutine entries from the outermost in, then the PC and the opcode there.
+        std::map<std::vector<word>, std::uint64_t> paths;
+    };
+}
+
+#endif
@@ -0,0 +1,41 @@
+#include <sstream>
+#include <string>
+#include "catch.hpp"
+#include "sampler.hpp"
+#include "processor.hpp"
+#include "memory.hpp"
+
+TEST_CASE("Samples are counted by call path.", "[sampler]") {
+    // 200: CALL 0x206; JP 0x200; (unused)
+    // 206: CALL 0x20C; RET; (unused)
+    // 20C: ADD V0, 1; RET
+    const ch8::byte program[] = {0x22, 0x06, 0x12, 0x00, 0x00, 0x00,
+                                 0x22, 0x0C, 0x00, 0xEE, 0x00, 0x00,
+                                 0x70, 0x01, 0x00, 0xEE};
+    ch8::Memory memory {program, sizeof(program)};
+    ch8::Processor processor {memory, 0};
+    ch8::Sampler sampler {1}; // Every instruction, so each one of the six shows up.
+    REQUIRE(sampler.run(processor, memory, 60) == 60);
+    REQUIRE(sampler.samples() == 60);
+
+    // Samples are taken after instructions, so these are where the next one is at.
+    std::ostringstream folded;
+    sampler.write_folded(folded);
+    REQUIRE(folded.str() == "0x200;0x200 CALL 0x206 10\n"
+                            "0x200;0x202 JP 0x200 10\n"
+                            "0x200;0x206;0x206 CALL 0x20C 10\n"
+                            "0x200;0x206;0x208 RET 10\n"
+                            "0x200;0x206;0x20C;0x20C ADD V0, 0x01 10\n"
+                            "0x200;0x206;0x20C;0x20E RET 10\n");
+
+    // Samples keep their spacing across runs, and stop with the program.
+    const ch8::byte exiting[] = {0x70, 0x01, 0x70, 0x01, 0x70, 0x01, 0x00, 0xFD};
+    ch8::Memory exiting_memory {exiting, sizeof(exiting)};
+    ch8::Processor exiting_processor {exiting_memory, 0};
+    ch8::Sampler every_other {2};
+    REQUIRE(every_other.run(exiting_processor, exiting_memory, 1) == 1);
+    REQUIRE(every_other.samples() == 0);
+    REQUIRE(every_other.run(exiting_processor, exiting_memory, 100) == 3);
+    REQUIRE(every_other.samples() == 2);
+    REQUIRE_THROWS_AS(ch8::Sampler {0}, const std::invalid_argument&);
+}
@@ -0,0 +1,59 @@
+#include "scheduler.hpp"
+#include <thread>
+#include <exception>
+
+namespace ch8 {
+    Scheduler::Scheduler(std::size_t workers) : worker_count {workers} {
+        if (worker_count == 0) worker_count = std::thread::hardware_concurrency();
+        if (worker_count == 0) worker_count = 1; // Couldn't be detected, be conservative.
+        for (std::size_t w {0}; w < worker_count; ++w) queues.emplace_back(new Queue);
+    }
+
+    void Scheduler::run(std::size_t tasks, const Task& task) {
+        for (std::size_t t {0}; t < tasks; ++t) {
+            queues[t % worker_count]->tasks.push_back(t);
+        }
+
+        std::mutex error_lock;
+        std::exception_ptr error; // First failure is rethrown once every worker is done.
+        auto work = [&](std::size_t worker) {
+            std::size_t current;
+            while (pop(worker, current) || steal(worker, current)) {
+                try { task(current, worker); }
+                catch (...) {
+                    std::lock_guard<std::mutex> guard {error_lock};
+                    if (!error) error = std::current_exception();
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (std::size_t w {1}; w < worker_count; ++w) threads.emplace_back(work, w);
+        work(0); // The calling thread does its share too.
+        for (std::thread& thread : threads) thread.join();
+        if (error) std::rethrow_exception(error);
+    }
+
+    bool Scheduler::pop(std::size_t worker, std::size_t& task) {
+        Queue& queue {*queues[worker]};
+        std::lock_guard<std::mutex> guard {queue.lock};
+        if (queue.tasks.empty()) return false;
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        return true;
+    }
+
+    bool Scheduler::steal(std::size_t worker, std::size_t& task) {
+        // Start with the neighbour, so thieves don't all gang up on queue zero.
+        for (std::size_t i {1}; i < worker_count; ++i) {
+            Queue& victim {*queues[(worker + i) % worker_count]};
+            std::lock_guard<std::mutex> guard {victim.lock};
+            if (victim.tasks.empty()) continue;
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+
+        return false;
+    }
+}
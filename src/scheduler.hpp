@@ -0,0 +1,36 @@
+#ifndef CH8_SCHEDULER_HPP
+#define CH8_SCHEDULER_HPP
+
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <functional>
+#include "definitions.hpp"
+
+namespace ch8 {
+    // Small work-stealing pool. Tasks are dealt out round-robin to each of the worker's
+    // own queue, workers pop from the front of their own and steal from the back of the
+    // others' when empty. Since jobs are of very different lengths (some ROMs exit right
+    // away, others run for their whole budget), stealing is what keeps every core busy.
+    class Scheduler {
+    public:
+        using Task = std::function<void(std::size_t, std::size_t)>; // Called with (task, worker).
+        explicit Scheduler(std::size_t); // Amount of workers, zero picks one per hardware thread.
+        std::size_t workers() const { return worker_count; }
+        void run(std::size_t, const Task&); // Runs tasks [0, n) and blocks until they are all done.
+
+    private:
+        struct Queue {
+            std::mutex lock;
+            std::deque<std::size_t> tasks;
+        };
+
+        bool pop(std::size_t, std::size_t&); // Takes the next task from the worker's own queue.
+        bool steal(std::size_t, std::size_t&); // Takes the last task from any of the other queues.
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::size_t worker_count;
+    };
+}
+
+#endif
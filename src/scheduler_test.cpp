@@ -0,0 +1,39 @@
+#include "catch.hpp"
+#include "scheduler.hpp"
+#include <atomic>
+#include <vector>
+
+TEST_CASE("Scheduler picks a worker count.", "[scheduler, workers]") {
+    ch8::Scheduler fixed {3};
+    REQUIRE(fixed.workers() == 3); // Exactly as many as asked for.
+    ch8::Scheduler automatic {0};
+    REQUIRE(automatic.workers() >= 1); // At least one, even if not detected.
+}
+
+TEST_CASE("Scheduler runs every task exactly once.", "[scheduler, run]") {
+    ch8::Scheduler scheduler {4};
+    std::vector<std::atomic<int>> runs(1000);
+    for (std::atomic<int>& count : runs) count = 0;
+    std::atomic<std::size_t> highest_worker {0};
+    scheduler.run(runs.size(), [&](std::size_t task, std::size_t worker) {
+        // Catch assertions aren't thread safe, so workers only record what they saw.
+        std::size_t highest {highest_worker.load()};
+        while (worker > highest && !highest_worker.compare_exchange_weak(highest, worker)) {}
+        ++runs[task];
+    });
+
+    REQUIRE(highest_worker < 4); // Never more workers than asked for.
+    for (std::atomic<int>& count : runs) REQUIRE(count == 1);
+    REQUIRE_NOTHROW(scheduler.run(0, [](std::size_t, std::size_t) {})); // Nothing to do is fine.
+}
+
+TEST_CASE("Scheduler forwards failing tasks.", "[scheduler, errors]") {
+    ch8::Scheduler scheduler {2};
+    std::atomic<int> completed {0};
+    REQUIRE_THROWS(scheduler.run(16, [&](std::size_t task, std::size_t) {
+        if (task == 5) throw std::runtime_error {"Task failed."};
+        ++completed;
+    }));
+
+    REQUIRE(completed == 15); // Other tasks still ran to completion.
+}
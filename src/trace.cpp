@@ -0,0 +1,187 @@
+#include "trace.hpp"
+#include <chrono>
+#include <cstring>
+
+namespace ch8 {
+    namespace {
+        const char MAGIC[8] = {'C', 'H', '8', 'T', 'R', 'A', 'C', 'E'};
+
+        // Flags leading every record, saying which fields follow.
+        constexpr byte CYCLE_JUMP {0x01}; // Cycle isn't the one after the last.
+        constexpr byte PC_JUMP {0x02}; // PC isn't two past the last.
+        constexpr byte REGISTER {0x04};
+        constexpr byte STORE {0x08};
+
+        constexpr std::size_t LARGEST_RECORD {1 + 10 + 2 + 2 + 1 + 3 + 2 + 1}; // Everything there, in the longest varints.
+
+        char* put_varint(char* out, std::uint64_t value) {
+            while (value >= 0x80) {
+                *out++ = static_cast<char>(value | 0x80);
+                value >>= 7;
+            }
+
+            *out++ = static_cast<char>(value);
+            return out;
+        }
+
+        char* put_word(char* out, word value) {
+            *out++ = static_cast<char>(value >> 8);
+            *out++ = static_cast<char>(value);
+            return out;
+        }
+
+        byte get_byte(std::istream& stream) {
+            int c {stream.get()};
+            if (c == std::char_traits<char>::eof()) throw std::runtime_error {"Couldn't read trace, it's truncated."};
+            return static_cast<byte>(c);
+        }
+
+        std::uint64_t get_varint(std::istream& stream) {
+            std::uint64_t value {0};
+            for (unsigned shift {0}; shift < 64; shift += 7) {
+                byte b {get_byte(stream)};
+                value |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+                if ((b & 0x80) == 0) return value;
+            }
+
+            throw std::runtime_error {"Couldn't read trace, bad varint."};
+        }
+
+        word get_word(std::istream& stream) {
+            byte upper {get_byte(stream)};
+            return upper << 8 | get_byte(stream);
+        }
+    }
+
+    constexpr byte TraceRecord::NO_REGISTER;
+    constexpr byte TraceRecord::I_REGISTER;
+    constexpr addr TraceRecord::NO_ADDRESS;
+    TraceRing::TraceRing(std::size_t capacity) {
+        std::size_t size {1};
+        while (size < capacity) size <<= 1;
+        records.resize(size);
+        mask = size - 1;
+    }
+
+    bool TraceRing::push(const TraceRecord& record) {
+        std::size_t at {tail.load(std::memory_order_relaxed)};
+        if (at - head.load(std::memory_order_acquire) == records.size()) return false;
+        records[at & mask] = record;
+        tail.store(at + 1, std::memory_order_release); // Publishes the record written above.
+        return true;
+    }
+
+    std::size_t TraceRing::pop(TraceRecord* destination, std::size_t count) {
+        std::size_t at {head.load(std::memory_order_relaxed)};
+        std::size_t available {tail.load(std::memory_order_acquire) - at};
+        if (count > available) count = available;
+        for (std::size_t i {0}; i < count; ++i) destination[i] = records[(at + i) & mask];
+        head.store(at + count, std::memory_order_release); // Hands the slots back to the producer.
+        return count;
+    }
+
+    constexpr std::uint32_t TraceWriter::VERSION;
+    TraceWriter::TraceWriter(std::ostream& output, std::size_t capacity) : ring {capacity}, stream {output} {
+        stream.write(MAGIC, sizeof(MAGIC));
+        for (unsigned shift {0}; shift < 32; shift += 8) stream.put(static_cast<char>(VERSION >> shift));
+        thread = std::thread {&TraceWriter::drain, this};
+    }
+
+    TraceWriter::~TraceWriter() {
+        try { close(); }
+        catch (const std::exception&) {} // Whoever cared would have closed it themselves.
+    }
+
+    void TraceWriter::record(TraceRecord record) {
+        record.cycle = cycle++;
+        while (!ring.push(record)) std::this_thread::yield(); // Never drop anything, wait for the drain.
+    }
+
+    void TraceWriter::close() {
+        if (!thread.joinable()) return;
+        closing.store(true, std::memory_order_release);
+        thread.join();
+        stream.flush();
+        if (failed || !stream) throw std::runtime_error {"Couldn't write trace."};
+    }
+
+    void TraceWriter::drain() {
+        std::vector<TraceRecord> records(1024);
+        std::vector<char> buffer(records.size() * LARGEST_RECORD);
+        TraceRecord last {0, 0, 0, 0, 0, 0, 0};
+        bool first {true};
+        while (true) {
+            bool finishing {closing.load(std::memory_order_acquire)}; // Before popping, so nothing is left behind.
+            std::size_t count {ring.pop(records.data(), records.size())};
+            if (count == 0) {
+                if (finishing) break;
+                std::this_thread::sleep_for(std::chrono::microseconds {100});
+                continue;
+            }
+
+            char* out {buffer.data()};
+            for (std::size_t i {0}; i < count; ++i) {
+                const TraceRecord& record {records[i]};
+                byte flags {0};
+                if (first || record.cycle != last.cycle + 1) flags |= CYCLE_JUMP;
+                if (first || record.PC != last.PC + 2) flags |= PC_JUMP;
+                if (record.reg != TraceRecord::NO_REGISTER) flags |= REGISTER;
+                if (record.address != TraceRecord::NO_ADDRESS) flags |= STORE;
+
+                *out++ = static_cast<char>(flags);
+                if (flags & CYCLE_JUMP) out = put_varint(out, first ? record.cycle : record.cycle - last.cycle);
+                if (flags & PC_JUMP) out = put_word(out, record.PC);
+                out = put_word(out, record.opcode);
+                if (flags & REGISTER) {
+                    *out++ = static_cast<char>(record.reg);
+                    out = put_varint(out, record.value);
+                }
+
+                if (flags & STORE) {
+                    out = put_word(out, record.address);
+                    *out++ = static_cast<char>(record.data);
+                }
+
+                last = record;
+                first = false;
+            }
+
+            if (!stream.write(buffer.data(), out - buffer.data())) failed = true;
+        }
+    }
+
+    TraceReader::TraceReader(std::istream& input) : stream {input} {
+        char magic[sizeof(MAGIC)];
+        if (!stream.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+            throw std::runtime_error {"Couldn't read trace, not a trace."};
+        std::uint32_t version {0};
+        for (unsigned shift {0}; shift < 32; shift += 8) version |= static_cast<std::uint32_t>(get_byte(stream)) << shift;
+        if (version != TraceWriter::VERSION) throw std::runtime_error {"Couldn't read trace, unsupported version."};
+    }
+
+    bool TraceReader::next(TraceRecord& record) {
+        int flags {stream.get()};
+        if (flags == std::char_traits<char>::eof()) return false;
+
+        record.cycle = flags & CYCLE_JUMP ? (first ? 0 : last.cycle) + get_varint(stream) : last.cycle + 1;
+        record.PC = flags & PC_JUMP ? get_word(stream) : static_cast<addr>(last.PC + 2);
+        record.opcode = get_word(stream);
+        record.reg = TraceRecord::NO_REGISTER;
+        record.value = 0;
+        if (flags & REGISTER) {
+            record.reg = get_byte(stream);
+            record.value = static_cast<word>(get_varint(stream));
+        }
+
+        record.address = TraceRecord::NO_ADDRESS;
+        record.data = 0;
+        if (flags & STORE) {
+            record.address = get_word(stream);
+            record.data = get_byte(stream);
+        }
+
+        last = record;
+        first = false;
+        return true;
+    }
+}
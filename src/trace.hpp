@@ -0,0 +1,87 @@
+#ifndef CH8_TRACE_HPP
+#define CH8_TRACE_HPP
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include "definitions.hpp"
+
+namespace ch8 {
+    // What a single instruction did. Only the first register it changed is kept, and
+    // only the first byte it stored, which is enough to find where two runs diverge.
+    struct TraceRecord {
+        static constexpr byte NO_REGISTER {0xFF};
+        static constexpr byte I_REGISTER {0x10}; // After V0 through VF.
+        static constexpr addr NO_ADDRESS {0xFFFF};
+
+        std::uint64_t cycle; // Instructions traced before this one.
+        addr PC;
+        word opcode;
+        word value; // New value of the register below.
+        addr address; // Where the byte below was stored, NO_ADDRESS if nothing was.
+        byte reg; // Register changed, NO_REGISTER if none was.
+        byte data;
+    };
+
+    // Lock-free ring with a single producer and a single consumer, each of which
+    // only ever writes its own index, kept on separate cache lines from the other.
+    class TraceRing {
+    public:
+        explicit TraceRing(std::size_t); // Capacity in records, rounded up to a power of two.
+        bool push(const TraceRecord&); // Producer only, false if the ring is full.
+        std::size_t pop(TraceRecord*, std::size_t); // Consumer only, takes up to n records.
+        std::size_t capacity() const { return records.size(); }
+
+    private:
+        std::vector<TraceRecord> records;
+        std::size_t mask;
+        alignas(64) std::atomic<std::size_t> head {0}; // Next to pop, only moved by the consumer.
+        alignas(64) std::atomic<std::size_t> tail {0}; // Next to push, only moved by the producer.
+    };
+
+    // Records are pushed into a ring by the processor, and drained by a thread of
+    // its own, which compresses them into the stream. Nothing is ever dropped, the
+    // processor waits for room instead. Traces start with "CH8TRACE" and a version,
+    // followed by records holding only what isn't implied by the one before them:
+    // a byte of flags, then the cycle delta and PC if they aren't the next ones,
+    // the opcode, and the changed register and stored byte if there are any.
+    class TraceWriter {
+    public:
+        explicit TraceWriter(std::ostream&, std::size_t = 1 << 16); // Starts draining right away.
+        ~TraceWriter(); // Same as close().
+        TraceWriter(const TraceWriter&) = delete;
+        TraceWriter& operator=(const TraceWriter&) = delete;
+        void record(TraceRecord); // Fills in the cycle, from a single thread only.
+        void close(); // Drains everything left, then stops the thread. Throws if the stream failed.
+        std::uint64_t recorded() const { return cycle; }
+
+        static constexpr std::uint32_t VERSION {1};
+
+    private:
+        void drain(); // Runs on the thread.
+        TraceRing ring;
+        std::ostream& stream;
+        std::uint64_t cycle {0};
+        std::atomic<bool> closing {false};
+        bool failed {false}; // Only touched by the thread until it's joined.
+        std::thread thread;
+    };
+
+    // Reads back what TraceWriter wrote.
+    class TraceReader {
+    public:
+        explicit TraceReader(std::istream&); // Throws std::runtime_error if it isn't a trace.
+        bool next(TraceRecord&); // False at the end, throws std::runtime_error if truncated.
+
+    private:
+        std::istream& stream;
+        TraceRecord last {0, 0, 0, 0, 0, 0, 0};
+        bool first {true};
+    };
+}
+
+#endif
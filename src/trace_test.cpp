@@ -0,0 +1,124 @@
+#include <sstream>
+#include <vector>
+#include "catch.hpp"
+#include "trace.hpp"
+#include "processor.hpp"
+#include "memory.hpp"
+
+TEST_CASE("Trace rings keep records in order.", "[trace, ring]") {
+    ch8::TraceRing ring {5};
+    REQUIRE(ring.capacity() == 8);
+
+    ch8::TraceRecord record {0, 0x200, 0x00E0, 0, ch8::TraceRecord::NO_ADDRESS, ch8::TraceRecord::NO_REGISTER, 0};
+    for (std::uint64_t i {0}; i < 8; ++i) {
+        record.cycle = i;
+        REQUIRE(ring.push(record));
+    }
+
+    REQUIRE(!ring.push(record)); // Full.
+    ch8::TraceRecord popped[16];
+    REQUIRE(ring.pop(popped, 3) == 3);
+    REQUIRE(popped[2].cycle == 2);
+    record.cycle = 8;
+    REQUIRE(ring.push(record)); // Wraps around.
+    REQUIRE(ring.pop(popped, 16) == 6);
+    REQUIRE(popped[0].cycle == 3);
+    REQUIRE(popped[5].cycle == 8);
+    REQUIRE(ring.pop(popped, 16) == 0);
+}
+
+TEST_CASE("Traces are read back as written.", "[trace, stream]") {
+    std::vector<ch8::TraceRecord> records {
+        {0, 0x200, 0x6005, 0x05, ch8::TraceRecord::NO_ADDRESS, 0x0, 0},
+        {0, 0x202, 0xA300, 0x300, ch8::TraceRecord::NO_ADDRESS, ch8::TraceRecord::I_REGISTER, 0},
+        {0, 0x204, 0xF033, 0, 0x300, ch8::TraceRecord::NO_REGISTER, 0},
+        {0, 0x206, 0x1200, 0, ch8::TraceRecord::NO_ADDRESS, ch8::TraceRecord::NO_REGISTER, 0},
+        {0, 0x200, 0x6005, 0x05, ch8::TraceRecord::NO_ADDRESS, 0x0, 0}
+    };
+
+    std::stringstream stream;
+    {
+        ch8::TraceWriter writer {stream, 2}; // Smaller than the trace, so the ring has to wrap.
+        for (int pass {0}; pass < 1000; ++pass) for (const ch8::TraceRecord& record : records) writer.record(record);
+        writer.close();
+        REQUIRE(writer.recorded() == 5000);
+    }
+
+    REQUIRE(stream.str().size() < 5000 * sizeof(ch8::TraceRecord) / 4); // Mostly opcodes.
+    ch8::TraceReader reader {stream};
+    ch8::TraceRecord record;
+    for (std::uint64_t cycle {0}; cycle < 5000; ++cycle) {
+        REQUIRE(reader.next(record));
+        const ch8::TraceRecord& expected {records[cycle % records.size()]};
+        REQUIRE(record.cycle == cycle);
+        REQUIRE(record.PC == expected.PC);
+        REQUIRE(record.opcode == expected.opcode);
+        REQUIRE(record.reg == expected.reg);
+        REQUIRE(record.value == expected.value);
+        REQUIRE(record.address == expected.address);
+    }
+
+    REQUIRE(!reader.next(record));
+
+    std::stringstream garbage {"CH8TRACX"};
+    REQUIRE_THROWS_AS(ch8::TraceReader {garbage}, const std::runtime_error&);
+    std::string truncated {stream.str()};
+    std::stringstream truncated_stream {truncated.substr(0, truncated.size() - 1)};
+    ch8::TraceReader truncated_reader {truncated_stream};
+    REQUIRE_THROWS_AS(while (truncated_reader.next(record)) {}, const std::runtime_error&);
+}
+
+TEST_CASE("Traced processors record every instruction.", "[trace, processor]") {
+    // 200: LD V0, 0x7B; LD I, 0x300; LD B, V0; ADD V0, 1; SE V0, 0x7D; JP 0x206; EXIT
+    const ch8::byte program[] = {0x60, 0x7B, 0xA3, 0x00, 0xF0, 0x33, 0x70, 0x01,
+                                 0x30, 0x7D, 0x12, 0x06, 0x00, 0xFD};
+    std::stringstream stream;
+    ch8::Memory memory {program, sizeof(program)};
+    ch8::Processor processor {memory, 0};
+    {
+        ch8::TraceWriter writer {stream};
+        processor.trace(&writer);
+        REQUIRE(processor.run(100) == 9);
+        processor.trace(nullptr);
+        writer.close();
+    }
+
+    ch8::TraceReader reader {stream};
+    std::vector<ch8::TraceRecord> records;
+    ch8::TraceRecord record;
+    while (reader.next(record)) records.push_back(record);
+    REQUIRE(records.size() == 9);
+    REQUIRE(records[0].reg == 0x0);
+    REQUIRE(records[0].value == 0x7B);
+    REQUIRE(records[1].reg == ch8::TraceRecord::I_REGISTER);
+    REQUIRE(records[1].value == 0x300);
+    REQUIRE(records[2].address == 0x300);
+    REQUIRE(records[2].data == 1); // Hundreds of 123.
+    REQUIRE(records[6].PC == 0x206); // After the jump.
+    REQUIRE(records[8].opcode == 0x00FD);
+    REQUIRE(records[8].cycle == 8);
+}
+
+TEST_CASE("Traced processors record XO-CHIP's range stores.", "[trace, processor]") {
+    // 200: LD V1, 0x2A; LD I, 0x300; SAVE V1 - V2; EXIT
+    const ch8::byte program[] = {0x61, 0x2A, 0xA3, 0x00, 0x51, 0x22, 0x00, 0xFD};
+    ch8::Memory memory {program, sizeof(program)};
+    ch8::Processor processor {memory, 0};
+    if (ch8::Memory::SIZE < 0x10000) return; // Only XO-CHIP builds have the profile.
+    processor.profile(ch8::Profile::XO_CHIP);
+
+    std::stringstream stream;
+    {
+        ch8::TraceWriter writer {stream};
+        processor.trace(&writer);
+        REQUIRE(processor.run(100) == 4);
+        processor.trace(nullptr);
+        writer.close();
+    }
+
+    ch8::TraceReader reader {stream};
+    ch8::TraceRecord record;
+    for (int i {0}; i < 3; ++i) REQUIRE(reader.next(record));
+    REQUIRE(record.address == 0x300);
+    REQUIRE(record.data == 0x2A);
+}
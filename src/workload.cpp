@@ -0,0 +1,123 @@
+#include "workload.hpp"
+#include "memory.hpp"
+#include "processor.hpp"
+
+namespace ch8 {
+    namespace {
+        const struct {
+            Workload::Kind kind;
+            const char* name;
+            unsigned max_intensity;
+        } KINDS[] = {
+            {Workload::Kind::ALU, "alu", 350}, // 10 bytes each, with room to spare in program memory.
+            {Workload::Kind::DRAW, "draw", 400},
+            {Workload::Kind::CALLS, "calls", Processor::STACK_SIZE - 1},
+            {Workload::Kind::MEMORY, "memory", 400}, // Ends well before 0xF00.
+            {Workload::Kind::TIMERS, "timers", 255}
+        };
+
+        void emit(std::vector<byte>& rom, word opcode) {
+            rom.push_back(opcode >> 8);
+            rom.push_back(opcode & 0xFF);
+        }
+    }
+
+    std::vector<byte> Workload::generate(Kind kind, unsigned intensity) {
+        if (intensity == 0 || intensity > max_intensity(kind))
+            throw std::invalid_argument {"Couldn't generate " + std::string {name(kind)} + " workload, intensity out of range."};
+
+        std::vector<byte> rom;
+        switch (kind) {
+        case Kind::ALU:
+            emit(rom, 0x6103); // LD V1, 3
+            for (unsigned i {0}; i < intensity; ++i) {
+                emit(rom, 0x8014); // ADD V0, V1
+                emit(rom, 0x8203); // XOR V2, V0
+                emit(rom, 0x8326); // SHR V3, V2
+                emit(rom, 0x8425); // SUB V4, V2
+                emit(rom, 0x7103); // ADD V1, 3
+            }
+
+            emit(rom, 0x1202); // JP 0x202
+            break;
+
+        case Kind::DRAW:
+            emit(rom, 0xA000); // LD I, 0x000 (the font's 0)
+            for (unsigned i {0}; i < intensity; ++i) {
+                emit(rom, 0x7008); // ADD V0, 8
+                emit(rom, 0xD015); // DRW V0, V1, 5
+            }
+
+            emit(rom, 0x7101); // ADD V1, 1
+            emit(rom, 0x1202); // JP 0x202
+            break;
+
+        case Kind::CALLS:
+            // 200: LD V0, 0; CALL 0x206; JP 0x200
+            // 206: ADD V0, 1; SE V0, <depth>; CALL 0x206; RET
+            emit(rom, 0x6000);
+            emit(rom, 0x2206);
+            emit(rom, 0x1200);
+            emit(rom, 0x7001);
+            emit(rom, 0x3000 | intensity);
+            emit(rom, 0x2206);
+            emit(rom, 0x00EE);
+            break;
+
+        case Kind::MEMORY:
+            for (unsigned i {0}; i < intensity; ++i) {
+                // Past the end of the largest program, so it never overwrites itself.
+                emit(rom, 0xAF00 | (i & 0x7F)); // LD I, 0xF00 + i
+                emit(rom, 0xFF55); // LD [I], VF
+                emit(rom, 0xAF00 | ((i + 1) & 0x7F)); // LD I, 0xF01 + i, so every pass shifts it all by a byte
+                emit(rom, 0xFF65); // LD VF, [I]
+            }
+
+            emit(rom, 0x7001); // ADD V0, 1
+            emit(rom, 0x1200); // JP 0x200
+            break;
+
+        case Kind::TIMERS:
+            // 200: LD V0, <frames>; LD DT, V0; LD V1, DT; SE V1, 0; JP 0x204; DRW V2, V2, 1; JP 0x200
+            emit(rom, 0x6000 | intensity);
+            emit(rom, 0xF015);
+            emit(rom, 0xF107);
+            emit(rom, 0x3100);
+            emit(rom, 0x1204);
+            emit(rom, 0xD221);
+            emit(rom, 0x1200);
+            break;
+        }
+
+        return rom;
+    }
+
+    unsigned Workload::max_intensity(Kind kind) {
+        for (const auto& entry : KINDS) {
+            if (kind == entry.kind) return entry.max_intensity;
+        }
+
+        return 0;
+    }
+
+    Workload::Kind Workload::kind(const std::string& name) {
+        for (const auto& entry : KINDS) {
+            if (name == entry.name) return entry.kind;
+        }
+
+        throw std::invalid_argument {"Couldn't find workload " + name + '.'};
+    }
+
+    const char* Workload::name(Kind kind) {
+        for (const auto& entry : KINDS) {
+            if (kind == entry.kind) return entry.name;
+        }
+
+        return "unknown";
+    }
+
+    const std::vector<Workload::Kind>& Workload::kinds() {
+        static const std::vector<Kind> all {Kind::ALU, Kind::DRAW, Kind::CALLS, Kind::MEMORY, Kind::TIMERS};
+        return all;
+    }
+}
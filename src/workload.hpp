@@ -0,0 +1,31 @@
+#ifndef CH8_WORKLOAD_HPP
+#define CH8_WORKLOAD_HPP
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include "definitions.hpp"
+
+namespace ch8 {
+    // Synthetic ROMs, each dominated by one kind of work, for end-to-end throughput
+    // runs. They loop forever and never read keys, so a run is fully determined by
+    // its budget. Intensity scales how much of that work there is per loop.
+    class Workload {
+    public:
+        enum class Kind {
+            ALU, // Straight-line register arithmetic, in blocks of five ops.
+            DRAW, // Rows of font sprites, 5 pixels high, scrolling down the screen.
+            CALLS, // Recursion, intensity is the depth, up to the stack size.
+            MEMORY, // FX55 then FX65 over all registers, shifted by a byte each time.
+            TIMERS // Spins on the delay timer, intensity is how many frames it waits.
+        };
+
+        static std::vector<byte> generate(Kind, unsigned); // Throws std::invalid_argument if intensity is out of range.
+        static unsigned max_intensity(Kind); // Intensities go from 1 up to this.
+        static Kind kind(const std::string&); // Throws std::invalid_argument for unknown names.
+        static const char* name(Kind); // Name as accepted by the above, e.g. "alu".
+        static const std::vector<Kind>& kinds(); // All of them, in the order above.
+    };
+}
+
+#endif
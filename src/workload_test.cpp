@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <vector>
+#include "catch.hpp"
+#include "workload.hpp"
+#include "memory.hpp"
+#include "processor.hpp"
+
+TEST_CASE("Workloads run forever without faulting.", "[workload]") {
+    for (ch8::Workload::Kind kind : ch8::Workload::kinds()) {
+        REQUIRE(ch8::Workload::kind(ch8::Workload::name(kind)) == kind);
+        for (unsigned intensity : {1u, ch8::Workload::max_intensity(kind)}) {
+            std::vector<ch8::byte> rom {ch8::Workload::generate(kind, intensity)};
+            REQUIRE(rom.size() <= ch8::Memory::PROGRAM_SIZE);
+            ch8::Memory memory {rom.data(), rom.size()};
+            ch8::Processor processor {memory, 0};
+            for (int frame {0}; frame < 1000; ++frame) {
+                for (int cycle {0}; cycle < 10; ++cycle) processor.step();
+                processor.tick_timers();
+            }
+
+            REQUIRE(processor.running());
+            REQUIRE(!processor.trapped());
+        }
+
+        REQUIRE_THROWS_AS(ch8::Workload::generate(kind, 0), const std::invalid_argument&);
+        REQUIRE_THROWS_AS(ch8::Workload::generate(kind, ch8::Workload::max_intensity(kind) + 1), const std::invalid_argument&);
+    }
+
+    REQUIRE_THROWS_AS(ch8::Workload::kind("nope"), const std::invalid_argument&);
+}
+
+TEST_CASE("Workloads are dominated by their kind of work.", "[workload]") {
+    // The deepest recursion goes all the way down the stack.
+    std::vector<ch8::byte> calls {ch8::Workload::generate(ch8::Workload::Kind::CALLS, 16)};
+    ch8::Memory memory {calls.data(), calls.size()};
+    ch8::Processor processor {memory, 0};
+    ch8::word deepest {0};
+    for (int i {0}; i < 200; ++i) {
+        processor.step();
+        deepest = std::max(deepest, processor.register_state(ch8::Processor::Register::SP));
+    }
+
+    REQUIRE(deepest == 16);
+
+    // Most steps of a draw workload draw something.
+    std::vector<ch8::byte> draw {ch8::Workload::generate(ch8::Workload::Kind::DRAW, 100)};
+    ch8::Memory draw_memory {draw.data(), draw.size()};
+    ch8::Processor drawing {draw_memory, 0};
+    int draws {0};
+    for (int i {0}; i < 1000; ++i) {
+        drawing.step();
+        if (drawing.display_updated()) ++draws;
+        drawing.updated_display();
+    }
+
+    REQUIRE(draws > 450);
+}